@@ -0,0 +1,107 @@
+#ifndef NES_BLOCK_CACHE_TYPE_H
+#define NES_BLOCK_CACHE_TYPE_H
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "address.h"
+#include "byte.h"
+
+#define NES_BLOCK_LENGTH ( (size_t) 16 )		// max instructions per block
+#define NES_BLOCK_CACHE_SIZE ( (size_t) 2048 )		// blocks (a power of two)
+#define NES_BLOCK_PAGE_SIZE ( (size_t) 0x2000 )		// blocks never cross an 8KB page
+
+typedef enum	// BlockCache::PageFlags (flags of the 256-byte pages of the address space)
+{
+  CodePage = (1 << 0),			// RAM holding decoded code (writes invalidate)
+  BankPage = (1 << 1),			// mapper registers (writes may switch banks)
+  HaltPage = (1 << 2),			// I/O registers (writing OAMDMA halts the CPU)
+} blockPage_t;
+
+typedef struct	// BlockCache::Instruction (pre-decoded)
+{
+  byte_t opcode;
+  byte_t op;						// Operation (handler)
+  byte_t mode;						// Addressing Mode
+  byte_t cycles;					// Base Cycles
+  byte_t penalty;					// Page-Cross Penalty
+  byte_t length;					// Bytes (opcode and operand)
+  address_t operand;					// Resolved operand bytes
+  uint16_t rest;					// Base cycles of the rest of the block
+} blockOp_t;
+
+typedef size_t (*native_t) (void*);			// recompiled block (returns cycles)
+
+typedef struct	// BlockCache::Block (a straight run of code ending at a control transfer)
+{
+  const byte_t* page;					// 8KB page of the code (key)
+  native_t native;					// recompiled code (or NULL)
+  uint32_t epoch;					// RAM code epoch (0 for ROM code)
+  address_t pc;						// address of the first instruction (key)
+  uint16_t count;					// instructions
+  uint16_t cycles;					// summed base cycles
+  uint16_t heat;					// executions (until recompiled)
+  bool idle;						// polling loop (no side effects)
+  blockOp_t code[NES_BLOCK_LENGTH];
+} block_t;
+
+typedef struct	// BlockCache
+{
+  uint32_t epoch;					// bumped when RAM code is written
+  bool banked;						// mapper pages flagged
+  byte_t pages[256];					// blockPage_t flags
+  block_t* blocks;
+} blockCache_t;
+
+typedef struct
+{
+  blockCache_t* (*create) (void);
+  blockCache_t* (*destroy) (blockCache_t*);
+  void (*invalidate) (blockCache_t*);
+  void (*flush) (blockCache_t*);
+} blockCache_namespace_t;
+
+// the slot of the block of code at PC in the (8KB) page, direct mapped
+static inline block_t* blockCache_slot (const blockCache_t* cache,
+				        const byte_t* page,
+				        address_t const pc)
+{
+  size_t const bank = ( (uintptr_t) page >> 13 );
+  size_t const index = ( (pc ^ (pc >> 11) ^ (bank << 3)) & (NES_BLOCK_CACHE_SIZE - 1) );
+  return &cache -> blocks[index];
+}
+
+
+// true if the slot holds the (current) block of code at PC in the page
+static inline bool blockCache_hit (const block_t* block,
+				   const byte_t* page,
+				   address_t const pc,
+				   uint32_t const epoch)
+{
+  return (block -> page == page && block -> pc == pc && block -> epoch == epoch);
+}
+
+#endif
+
+// NES Emulation					October 18, 2026
+//
+//			Academic Purpose
+//
+// source: blockCache.h
+// author: @misael-diaz
+//
+// Synopsis:
+// BlockCache header file.
+// Defines the block cache, the pre-decoded straight runs of code keyed by the 8KB page
+// holding the code and the PC. Because the key is the page (not the bank register), a bank
+// switch needs no flush: the blocks of the switched-out bank simply stop matching until
+// it is mapped back. RAM code is tagged with an epoch that writes to it bump.
+//
+// Copyright (c) 2023 Misael Diaz-Maldonado
+// This file is released under the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// References:
+// [0] https://github.com/amhndu/SimpleNES
@@ -1,17 +1,97 @@
 #ifndef NES_BUS_TYPE_H
 #define NES_BUS_TYPE_H
 
+#include <stddef.h>
+#include <stdbool.h>
+
 #include "device.h"
+#include "mapper.h"
+#include "blockCache.h"
 #include "address.h"
 #include "byte.h"
 
+#define NES_BUS_PAGES ( (size_t) 256 )		// 256-byte pages of the CPU address space
+#define NES_BUS_HANDLERS ( (size_t) 16 )	// handlers of the pages not accessed straight
+#define NES_BUS_SPLITS ( (size_t) 2 )		// pages shared by devices (register pages)
+#define NES_BUS_WORK_RAM ( (size_t) 0x0800 )	// 2KB of work RAM (mirrored up to $1FFF)
+#define NES_BUS_PRG_RAM ( (size_t) 0x2000 )	// PRG-RAM window ($6000 - $7FFF)
+#define NES_BUS_WATCHES ( (size_t) 16 )		// watchpoints (address ranges)
+#define NES_BUS_OAM ( (size_t) 256 )		// sprite memory (OAM) of the PPU
+
+typedef enum	// Bus::Handler::Kind
+{
+  PPUHandler,						// PPU registers
+  IOHandler,						// APU and I/O registers
+  OpenBusHandler,					// unmapped
+  CartridgeHandler,					// mapper (writes, traced reads)
+  WatchHandler,						// watched pages (slow path)
+  SplitHandler,						// pages shared by devices (by byte)
+  DeviceHandler,					// first handler of the devices
+} busHandlerKind_t;
+
+typedef enum	// Bus::Watch::Kind (flags of the accesses watched)
+{
+  WatchRead = (1 << 0),
+  WatchWrite = (1 << 1),
+  WatchExecute = (1 << 2),				// (opcode fetch)
+} busWatchKind_t;
+
+// invoked with the context, the address (as accessed), the value, and the kind of access
+typedef void (*busWatcher_t) (void*, address_t, byte_t, busWatchKind_t);
+
+typedef struct	// Bus::Watch (watchpoint)
+{
+  address_t first;					// (of the range, mirrors resolved)
+  address_t last;
+  address_t from;					// (of the range as watched)
+  address_t to;
+  byte_t kinds;						// busWatchKind_t flags
+  busWatcher_t watcher;
+  void* context;					// (of the watcher)
+} busWatch_t;
+
+typedef struct	// Bus::Handler (of the pages that are not accessed straight)
+{
+  byte_t (*read) (void*, const address_t);
+  void (*write) (void*, const address_t, const byte_t);
+  void* context;
+} busHandler_t;
+
 typedef struct	// Bus
 {
   // public:
-  byte_t* ram;						// fake RAM
+  byte_t* ram;						// work RAM (2KB)
+  byte_t* prgRAM;					// PRG-RAM of the cartridge (or NULL)
+  size_t sizePRGRAM;
+  byte_t ppu[8];					// PPU registers (latched)
+  byte_t io[0x20];					// APU and I/O registers (latched)
+  byte_t oam[NES_BUS_OAM];				// OAM of the PPU (OAMDATA and DMA)
+  bool halt;						// OAM DMA started (halts the CPU)
   device_t* cpu;					// for the CPU Bus connection
+  mapper_t* mapper;					// Cartridge ($8000 - $FFFF)
+  blockCache_t* cache;					// CPU decoded code (or NULL)
+  const byte_t* reads[NES_BUS_PAGES];			// page read straight (or NULL)
+  byte_t* writes[NES_BUS_PAGES];			// page written straight (or NULL)
+  byte_t handlers[NES_BUS_PAGES];			// handler of the page (if not straight)
+  busHandler_t handler[NES_BUS_HANDLERS];
+  size_t countHandlers;					// (the devices add theirs)
+  byte_t claims[NES_BUS_PAGES];				// handler claiming the page (or 0)
+  byte_t splits[NES_BUS_PAGES];				// split table of the shared page
+  byte_t split[NES_BUS_SPLITS][NES_BUS_PAGES];		// handler of each byte of the page
+  size_t countSplits;
+  byte_t watched[NES_BUS_PAGES];			// busWatchKind_t flags of the pages
+  address_t straight;					// CPU accesses the work RAM below
+  size_t countWatches;
+  busWatch_t watches[NES_BUS_WATCHES];
   byte_t (*read) (const void*, const address_t);
   void (*write) (void*, const address_t, const byte_t);
+  byte_t (*peek) (const void*, const address_t);	// reads (unwatched) the code
+  bool (*watch) (void*, address_t, address_t, byte_t, busWatcher_t, void*);
+  size_t (*unwatch) (void*, address_t, address_t);	// removes the watchpoints
+  void (*notify) (const void*, address_t, byte_t, busWatchKind_t);
+  void (*ConnectMapper) (void*, mapper_t*);
+  bool (*ConnectPRGRAM) (void*, size_t);		// PRG-RAM ($6000 - $7FFF)
+  bool (*ConnectDevice) (void*, device_t*);		// the address ranges it claims
 } bus_t;
 
 typedef struct
@@ -32,6 +112,21 @@ typedef struct
 // Synopsis:
 // Bus header file.
 // Defines the bus type.
+// The bus dispatches the accesses by the 256-entry page table of the CPU memory map: the
+// pages of RAM (and of PRG-ROM) are read with a straight load, the I/O pages (and the
+// writes to the cartridge) go to the handler of the page. The bus holds only the memory
+// the console has, the 2KB of work RAM (and the PRG-RAM of the cartridge, if any), whose
+// mirrors are pages of the table pointing to the same memory.
+// A write to OAMDMA ($4014) copies the page into the OAM at once (straight if the page is
+// read straight) and raises the halt flag, the CPU then stops its run so that the console
+// charges the stall of the DMA.
+// The watchpoints flag the pages they cover in a bitmap: the flagged pages go to the watch
+// handler (which checks the exact ranges and notifies the watchers) in place of their own
+// mapping, the rest are dispatched as ever.
+// The devices connected to the bus take over the address ranges they claim: the bus
+// compiles the ranges into the page table on connecting the device, the whole pages go to
+// the handler of the device and the pages shared (the I/O registers, say) to a split table
+// that picks the handler by the byte, so that no access searches the ranges.
 // Ports SimpleNES (reference [0]) to clang for learning purposes.
 //
 // Copyright (c) 2023 Misael Diaz-Maldonado
@@ -41,3 +136,5 @@ typedef struct
 //
 // References:
 // [0] https://github.com/amhndu/SimpleNES
+// [1] https://www.nesdev.org/wiki/CPU_memory_map
+// [2] https://www.nesdev.org/wiki/PPU_OAM
@@ -2,6 +2,7 @@
 #define NES_CARTRIDGE_TYPE_H
 
 #include <stdlib.h>
+#include <stdint.h>
 #include <stdbool.h>
 
 #include "byte.h"
@@ -12,11 +13,21 @@ typedef struct
   // private:
   void* data;
   // public:
-  void (*loadFromFile) (void*);
+  bool (*loadFromFile) (void*, const char*);		// (false if the ROM failed to load)
+  bool (*loadFromArchive) (void*, const char*);
+  bool (*loadFromMemory) (void*, const byte_t*, size_t);
+  bool (*mapFromFile) (void*, const char*);
   byte_t* (*getROM) (const void*);
   byte_t* (*getVROM) (const void*);
   size_t (*getSizeROM) (const void*);
   size_t (*getSizeVROM) (const void*);
+  size_t (*getSizePRGRAM) (const void*);
+  size_t (*getSizeCHRRAM) (const void*);
+  uint16_t (*getMapperNumber) (const void*);
+  byte_t (*getSubmapperNumber) (const void*);
+  byte_t (*getTimingMode) (const void*);
+  uint32_t (*getCRC32) (const void*);
+  const byte_t* (*getSHA1) (const void*);
   byte_t (*getNameTableMirroring) (const void*);
   bool (*hasExtendedRAM) (const void*);
 } cartridge_t;
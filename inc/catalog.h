@@ -0,0 +1,64 @@
+#ifndef NES_CATALOG_TYPE_H
+#define NES_CATALOG_TYPE_H
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "byte.h"
+
+typedef struct	// Catalog Entry (one per ROM file)
+{
+  const char* path;
+  uint64_t mtime;					// file modification time (s)
+  uint64_t size_file;					// file size (bytes)
+  uint32_t crc32;					// CRC32 of the ROM sans header
+  uint32_t size_ROM;					// PRG-ROM size (bytes)
+  uint32_t size_VROM;					// CHR-ROM size (bytes)
+  byte_t sha1[20];					// SHA-1 of the ROM sans header
+  uint16_t mapperNumber;
+  byte_t submapperNumber;				// NES 2.0 (zero otherwise)
+  byte_t nameTableMirroring;
+  byte_t tvSystem;
+  bool extendedRAM;
+  bool valid;						// false if not an iNES ROM
+} catalogEntry_t;
+
+typedef struct	// Catalog (of a ROM library)
+{
+  // public:
+  catalogEntry_t* entries;				// sorted by path
+  size_t count;
+  // private:
+  char* strings;					// holds the paths
+} catalog_t;
+
+typedef struct
+{
+  catalog_t* (*scan) (const char*, const catalog_t*, size_t);
+  catalog_t* (*load) (const char*);
+  int (*save) (const catalog_t*, const char*);
+  const catalogEntry_t* (*find) (const catalog_t*, const char*);
+  catalog_t* (*destroy) (catalog_t*);
+} catalog_namespace_t;
+
+#endif
+
+// NES Emulation					October 18, 2026
+//
+//			Academic Purpose
+//
+// source: catalog.h
+// author: @misael-diaz
+//
+// Synopsis:
+// Catalog header file.
+// Defines the catalog type, an index of the iNES header fields of a ROM library.
+//
+// Copyright (c) 2023 Misael Diaz-Maldonado
+// This file is released under the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// References:
+// [0] https://github.com/amhndu/SimpleNES
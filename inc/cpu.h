@@ -1,15 +1,84 @@
 #ifndef NES_CPU_TYPE_H
 #define NES_CPU_TYPE_H
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include "bus.h"
+#include "blockCache.h"
+#include "recompiler.h"
 #include "device.h"
 #include "address.h"
 #include "byte.h"
 
+#define NES_CPU_WORK_RAM ( (address_t) 0x0800 )	// end of the internal work RAM (2KB)
+
+typedef enum	// CPU::Flags (bits of the Status Register)
+{
+  CarryFlag = (1 << 0),
+  ZeroFlag = (1 << 1),
+  InterruptDisableFlag = (1 << 2),
+  DecimalFlag = (1 << 3),				// no effect on the 2A03
+  BreakFlag = (1 << 4),
+  UnusedFlag = (1 << 5),
+  OverflowFlag = (1 << 6),
+  NegativeFlag = (1 << 7),
+} cpuFlag_t;
+
+typedef enum	// CPU::AddressingMode
+{
+  IMP,							// Implied
+  ACC,							// Accumulator
+  IMM,							// Immediate
+  ZP0,							// Zero Page
+  ZPX,							// Zero Page + X Register offset
+  ZPY,							// Zero Page + Y Register offset
+  ABS,							// Absolute
+  ABX,							// Absolute  + X Register offset
+  ABY,							// Absolute  + Y Register offset
+  IND,							// Indirect
+  IZX,							// Indirect  + X Register offset
+  IZY,							// Indirect  + Y Register offset
+  REL,							// Relative
+} addressingMode_t;
+
+// operations (official and the stable unofficial ones):
+#define NES_CPU_OPERATIONS(X)									\
+  X(ADC) X(AND) X(ASL) X(ASL_A) X(BCC) X(BCS) X(BEQ) X(BIT) X(BMI) X(BNE) X(BPL) X(BRK)	\
+  X(BVC) X(BVS) X(CLC) X(CLD) X(CLI) X(CLV) X(CMP) X(CPX) X(CPY) X(DEC) X(DEX) X(DEY)	\
+  X(EOR) X(INC) X(INX) X(INY) X(JMP) X(JSR) X(LDA) X(LDX) X(LDY) X(LSR) X(LSR_A) X(NOP)	\
+  X(ORA) X(PHA) X(PHP) X(PLA) X(PLP) X(ROL) X(ROL_A) X(ROR) X(ROR_A) X(RTI) X(RTS)	\
+  X(SBC) X(SEC) X(SED) X(SEI) X(STA) X(STX) X(STY) X(TAX) X(TAY) X(TSX) X(TXA) X(TXS)	\
+  X(TYA) X(ALR) X(ANC) X(ARR) X(AXS) X(DCP) X(ISC) X(JAM) X(LAS) X(LAX) X(LXA) X(RLA)	\
+  X(RRA) X(SAX) X(SHA) X(SHX) X(SHY) X(SLO) X(SRE) X(TAS) X(XAA)
+
+#define NES_CPU_ENUM(op) op,
+typedef enum	// CPU::Operation
+{
+  NES_CPU_OPERATIONS(NES_CPU_ENUM)
+} operation_t;
+#undef NES_CPU_ENUM
+
+typedef enum	// CPU::Engine (selected at create time)
+{
+  InterpreterEngine,					// executes the decoded blocks
+  RecompilerEngine,					// executes the hot blocks natively
+  AccurateEngine,					// executes cycle by cycle (bus exact)
+} cpuEngine_t;
+
+typedef struct	// CPU::Instruction (entry of the opcode table)
+{
+  byte_t op;						// Operation
+  byte_t mode;						// Addressing Mode
+  byte_t cycles;					// Base Cycles
+  byte_t penalty;					// Page-Cross Penalty (cycles)
+} instruction_t;
+
 typedef struct	// CPU
 {
   // public:
   bus_t* bus;						// Main Bus
+  byte_t* ram;						// Work RAM ($0000 - $07FF) of the Bus
   const device_t* dev;					// CPU base type (for Bus Connect)
   // Registers:
   address_t pc;						// Program Counter PC
@@ -18,7 +87,19 @@ typedef struct	// CPU
   byte_t a;						// Accumulator Register
   byte_t x;						// X Register
   byte_t y;						// Y Register
+  byte_t sp;						// Stack Pointer
+  byte_t status;					// Status Register
   byte_t fetched;
+  byte_t opcode;					// Opcode (last executed)
+  byte_t cycles;					// Cycles left (of opcode)
+  byte_t tick;						// Cycle of opcode (accurate engine)
+  uint64_t clock_count;					// Cycles since power up
+  uint64_t dmas;					// OAM DMAs that halted the CPU
+  blockCache_t* cache;					// Decoded blocks of code
+  recompiler_t* recompiler;				// Native code of the hot blocks
+  cpuEngine_t engine;
+  uint64_t skipped;					// Cycles fast-forwarded (idle loops)
+  bool skipsIdle;					// fast-forwards the idle loops
   // Bus Connectivity:
   byte_t (*read) (const void*, const address_t);
   void (*write) (void*, const address_t, const byte_t);
@@ -35,12 +116,22 @@ typedef struct	// CPU
   byte_t (*INX) (void*);				// Indirect  + X Register offset
   byte_t (*INY) (void*);				// Indirect  + Y Register offset
   byte_t (*REL) (void*);				// Relative
+  // Interrupts:
+  void (*reset) (void*);				// Reset
+  void (*irq) (void*);					// Interrupt Request
+  void (*nmi) (void*);					// Non-Maskable Interrupt
+  // Execution:
+  void (*clock) (void*);				// executes one cycle
+  size_t (*step) (void*);				// executes one instruction
+  size_t (*run) (void*, size_t);			// executes a budget of cycles
 } cpu_t;
 
 typedef struct
 {
-  cpu_t* (*create) (const device_t*);
+  cpu_t* (*create) (const device_t*, cpuEngine_t);
   cpu_t* (*destroy) (cpu_t*);
+  const instruction_t* (*decode) (const byte_t);
+  bool (*halts) (void*);				// the bus halted the CPU (DMA)
 } cpu_namespace_t;
 
 #endif
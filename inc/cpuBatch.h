@@ -0,0 +1,49 @@
+#ifndef NES_CPU_BATCH_TYPE_H
+#define NES_CPU_BATCH_TYPE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "cpu.h"
+
+#define NES_CPU_BATCH_ALIGNMENT ( (size_t) 32 )	// (one AVX2 register) of the lane arrays
+
+typedef struct	// CPU::Batch (instances of the CPU running in lockstep)
+{
+  // private:
+  void* data;
+  // public:
+  size_t (*run) (void*, size_t);			// executes a budget of cycles (each)
+  size_t (*getCount) (const void*);			// instances
+} cpuBatch_t;
+
+typedef struct
+{
+  cpuBatch_t* (*create) (cpu_t**, size_t);
+  cpuBatch_t* (*destroy) (cpuBatch_t*);
+} cpuBatch_namespace_t;
+
+#endif
+
+// NES Emulation					October 18, 2026
+//
+//			Academic Purpose
+//
+// source: cpuBatch.h
+// author: @misael-diaz
+//
+// Synopsis:
+// CPU Batch header file.
+// Defines the CPU batch, which runs many instances of the CPU (copies of the same ROM
+// with different inputs, say) with their registers stored as struct-of-arrays, so that
+// the instances at the same PC execute the instruction together as one (vectorizable)
+// loop over the lanes. The batch borrows the CPUs; their registers are up to date
+// between the calls to run().
+//
+// Copyright (c) 2023 Misael Diaz-Maldonado
+// This file is released under the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// References:
+// [0] https://github.com/amhndu/SimpleNES
@@ -0,0 +1,38 @@
+#ifndef NES_CPU_CYCLE_TYPE_H
+#define NES_CPU_CYCLE_TYPE_H
+
+#include <stddef.h>
+
+#include "cpu.h"
+
+typedef struct	// CPU::Cycle (the accurate engine, one bus access per cycle)
+{
+  void (*clock) (void*);				// executes one cycle
+  size_t (*step) (void*);				// executes one instruction
+  size_t (*run) (void*, size_t);			// executes a budget of cycles
+} cpuCycle_namespace_t;
+
+#endif
+
+// NES Emulation					October 18, 2026
+//
+//			Academic Purpose
+//
+// source: cpuCycle.h
+// author: @misael-diaz
+//
+// Synopsis:
+// CPU Cycle header file.
+// Defines the methods of the accurate engine of the CPU, which executes the instructions
+// cycle by cycle (the dummy reads and writes included) so that every bus access happens
+// on the cycle it does on the 2A03. The CPU created with the AccurateEngine executes with
+// these methods in place of the (instruction-granular) ones of the fast engines.
+//
+// Copyright (c) 2023 Misael Diaz-Maldonado
+// This file is released under the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// References:
+// [0] https://github.com/amhndu/SimpleNES
+// [1] https://www.nesdev.org/6502_cpu.txt
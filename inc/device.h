@@ -1,10 +1,35 @@
 #ifndef NES_DEVICE_TYPE_H
 #define NES_DEVICE_TYPE_H
 
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "address.h"
+#include "byte.h"
+
+#define NES_DEVICE_RANGES ( (size_t) 8 )	// address ranges a device may claim
+
+typedef struct	// Device::Range (address range claimed by the device)
+{
+  address_t first;
+  address_t last;
+  byte_t (*read) (void*, const address_t);
+  void (*write) (void*, const address_t, const byte_t);
+  void* context;					// (of the handlers)
+} deviceRange_t;
+
 typedef struct
 {
   void* vbus;
+  size_t countRanges;
+  deviceRange_t ranges[NES_DEVICE_RANGES];
   void (*ConnectBus) (void*, void*);
+  bool (*claim) (void*,
+		 address_t,
+		 address_t,
+		 byte_t (*) (void*, const address_t),
+		 void (*) (void*, const address_t, const byte_t),
+		 void*);
 } device_t;
 
 typedef struct
@@ -25,6 +50,9 @@ typedef struct
 // Synopsis:
 // Device header file.
 // Defines the device type.
+// A device (the PPU, the APU, the controllers, a peripheral) claims the address ranges it
+// answers to with claim(), giving the handlers of the reads and of the writes; the bus
+// compiles the ranges into its page table when the device is connected to it.
 // Ports SimpleNES (reference [0]) to clang for learning purposes.
 //
 // Copyright (c) 2023 Misael Diaz-Maldonado
@@ -0,0 +1,48 @@
+#ifndef NES_FINGERPRINT_TYPE_H
+#define NES_FINGERPRINT_TYPE_H
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "byte.h"
+
+typedef struct	// Fingerprint (CRC32 and SHA-1 computed while the ROM streams in)
+{
+  // private:
+  uint64_t size;					// bytes fingerprinted so far
+  uint64_t size_section;				// bytes of the current section
+  uint32_t crc;						// CRC32 state of the current section
+  uint32_t crc_total;					// CRC32 of the ended sections
+  uint32_t sha1[5];					// SHA-1 state
+  uint32_t fill;					// bytes pending in the block
+  byte_t block[64];					// pending SHA-1 block
+} fingerprint_t;
+
+typedef struct
+{
+  void (*init) (fingerprint_t*);
+  void (*update) (fingerprint_t*, const byte_t*, size_t);
+  uint32_t (*section) (fingerprint_t*);
+  void (*final) (fingerprint_t*, uint32_t*, byte_t*);
+} fingerprint_namespace_t;
+
+#endif
+
+// NES Emulation					October 18, 2026
+//
+//			Academic Purpose
+//
+// source: fingerprint.h
+// author: @misael-diaz
+//
+// Synopsis:
+// Fingerprint header file.
+// Defines the fingerprint type, the CRC32 and SHA-1 that identify a ROM.
+//
+// Copyright (c) 2023 Misael Diaz-Maldonado
+// This file is released under the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// References:
+// [0] https://github.com/amhndu/SimpleNES
@@ -0,0 +1,59 @@
+#ifndef NES_INES_TYPE_H
+#define NES_INES_TYPE_H
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "byte.h"
+#include "mirroring.h"
+
+typedef enum	// TV System (or CPU/PPU timing)
+{
+  NTSC = 0,
+  PAL = 1,
+  MultipleRegion = 2,
+  Dendy = 3,
+} tvSystem_t;
+
+typedef struct	// decodes the fields of the (16 bytes) iNES header
+{
+  bool (*isValid) (const byte_t*);
+  bool (*isNES20) (const byte_t*);
+  bool (*hasTrainer) (const byte_t*);
+  size_t (*getSizeROM) (const byte_t*);
+  size_t (*getSizeVROM) (const byte_t*);
+  size_t (*getSizePRGRAM) (const byte_t*);
+  size_t (*getSizeCHRRAM) (const byte_t*);
+  nameTableMirroring_t (*getNameTableMirroring) (const byte_t*);
+  uint16_t (*getMapperNumber) (const byte_t*);
+  byte_t (*getSubmapperNumber) (const byte_t*);
+  bool (*hasExtendedRAM) (const byte_t*);
+  tvSystem_t (*getTVSystemOfficial) (const byte_t*);
+  tvSystem_t (*getTVSystemUnofficial) (const byte_t*);
+  tvSystem_t (*getTVSystem) (const byte_t*);
+} ines_namespace_t;
+
+#endif
+
+// NES Emulation					October 18, 2026
+//
+//			Academic Purpose
+//
+// source: ines.h
+// author: @misael-diaz
+//
+// Synopsis:
+// iNES header file.
+// Defines the methods that decode the iNES and NES 2.0 headers (shared by cartridge and
+// catalog).
+//
+// Copyright (c) 2023 Misael Diaz-Maldonado
+// This file is released under the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// References:
+// [0] https://github.com/amhndu/SimpleNES
+// [1] https://www.nesdev.org/wiki/INES
+// [2] https://www.nesdev.org/wiki/NES_2.0
@@ -3,6 +3,11 @@
 
 #include "address.h"
 #include "cartridge.h"
+#include "trace.h"
+
+#define NES_MAPPER_ALIGNMENT ( (size_t) 64 )	// mapper blocks start at a cache line
+#define NES_MAPPER_ALIGN(size) \
+  ( ( (size) + NES_MAPPER_ALIGNMENT - 1 ) & ~(NES_MAPPER_ALIGNMENT - 1) )
 
 typedef enum 	// Mapper::Type
 {
@@ -33,7 +38,16 @@ typedef struct	// Mapper
 typedef struct
 {
   mapper_t* (*create) (cartridge_t*, const mapperKind_t);
+  mapper_t* (*createAt) (void*, cartridge_t*, const mapperKind_t);
+  size_t (*footprint) (size_t);
   mapper_t* (*destroy) (mapper_t*);
+  void (*mapPRG) (mapper_t*, size_t, size_t, size_t);
+  void (*mapCHR) (mapper_t*, size_t, size_t, size_t);
+  void (*setCHR) (mapper_t*, byte_t*, size_t, bool);
+  uint32_t (*getGeneration) (const mapper_t*);
+  void (*listen) (mapper_t*, void (*) (void*), void*);
+  trace_t* (*getTrace) (const mapper_t*);
+  size_t (*saveTrace) (mapper_t*);
   /*
   // TODO: add Mapper::createMapper:
   mapper_t* (*generate) (const mapperKind_t,
@@ -6,6 +6,8 @@
 typedef struct
 {
   mapper_t* (*create) (cartridge_t*, void (*mirroring_cb) (void));
+  mapper_t* (*createAt) (void*, cartridge_t*, void (*mirroring_cb) (void));
+  size_t (*footprint) (const cartridge_t*);
   mapper_t* (*destroy) (mapper_t*);
 } mapperAxROM_namespace_t;
 
@@ -6,6 +6,8 @@
 typedef struct
 {
   mapper_t* (*create) (cartridge_t*);
+  mapper_t* (*createAt) (void*, cartridge_t*);
+  size_t (*footprint) (const cartridge_t*);
   mapper_t* (*destroy) (mapper_t*);
 } mapperCNROM_namespace_t;
 
@@ -0,0 +1,47 @@
+#ifndef NES_MAPPER_DATA_TYPE_H
+#define NES_MAPPER_DATA_TYPE_H
+
+#include "mapper.h"
+#include "trace.h"
+
+typedef struct	// Mapper (protected data shared by the core and the derived mappers)
+{
+  const byte_t* m_pagesPRG[4];	// 8KB PRG-ROM pages mapped at $8000, $A000, $C000, $E000
+  byte_t* m_pagesCHR[8];	// 1KB CHR pages mapped at $0000, $0400, ..., $1C00
+  cartridge_t* m_cartridge;
+  mapperKind_t m_kind;
+  void* next;
+  const byte_t* m_PRG;
+  byte_t* m_CHR;
+  size_t m_size_PRG;
+  size_t m_size_CHR;
+  uint32_t m_generation;	// counts the remappings of the pages
+  void (*m_remapped) (void*);	// notifies the listener of the PRG-ROM remappings
+  void* m_listener;		// (the bus)
+  bool m_writableCHR;
+  bool m_owned;			// frees the mapper block on destroy (false if supplied)
+#if defined(NES_TRACE)
+  trace_t* m_trace;
+#endif
+} mapperData_t;
+
+#endif
+
+// NES Emulation					October 18, 2026
+//
+//			Academic Purpose
+//
+// source: mapperData.h
+// author: @misael-diaz
+//
+// Synopsis:
+// Defines the protected data of the core mapper, the single definition shared by the
+// core, the derived mappers, and the inlined (devirtualized) dispatch.
+//
+// Copyright (c) 2023 Misael Diaz-Maldonado
+// This file is released under the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// References:
+// [0] https://github.com/amhndu/SimpleNES
@@ -0,0 +1,102 @@
+#ifndef NES_MAPPER_DISPATCH_TYPE_H
+#define NES_MAPPER_DISPATCH_TYPE_H
+
+#include "mapperData.h"
+
+// X-macro table of the mappers that switch banks on PRG writes: X(kind, writePRG)
+#define NES_MAPPER_TABLE(X)			\
+  X(AxROM, mapperAxROM_writePRG)		\
+  X(CNROM, mapperCNROM_writePRG)
+
+#define NES_MAPPER_DECLARE_WRITE_PRG(kind, writePRG) \
+  void writePRG (void*, const address_t, const byte_t);
+NES_MAPPER_TABLE(NES_MAPPER_DECLARE_WRITE_PRG)
+#undef NES_MAPPER_DECLARE_WRITE_PRG
+
+// builds with the mapper kind fixed at compile time (make MAPPER=7) fold the switch
+// into the single case of that kind, otherwise the kind is dispatched once per access
+// by a switch (a direct, predictable branch rather than an indirect call)
+#if defined(NES_MAPPER_KIND)
+#define NES_MAPPER_KIND_OF(data) ( (mapperKind_t) NES_MAPPER_KIND )
+#else
+#define NES_MAPPER_KIND_OF(data) ( (data) -> m_kind )
+#endif
+
+// reads (and CHR writes) are the same page lookup for all the mapper kinds:
+
+static inline byte_t mapper_readPRG (const mapperData_t* data, const address_t addr)
+{
+  byte_t const byte = data -> m_pagesPRG[(addr >> 13) & 0x03][addr & 0x1fff];
+  NES_TRACE_RECORD(data, TraceReadPRG, addr, byte);
+  return byte;
+}
+
+
+static inline byte_t mapper_readCHR (const mapperData_t* data, const address_t addr)
+{
+  if (addr >= 0x2000)	// attempted to read CHR at invalid address
+  {
+    NES_TRACE_RECORD(data, TraceReadCHR | NES_TRACE_FAULT, addr, 0);
+    return 0;
+  }
+
+  byte_t const byte = data -> m_pagesCHR[addr >> 10][addr & 0x03ff];
+  NES_TRACE_RECORD(data, TraceReadCHR, addr, byte);
+  return byte;
+}
+
+
+static inline void mapper_writeCHR (const mapperData_t* data,
+				    const address_t addr,
+				    const byte_t byte)
+{
+  if (!data -> m_writableCHR || addr >= 0x2000)	// CHR-ROM or invalid address
+  {
+    NES_TRACE_RECORD(data, TraceWriteCHR | NES_TRACE_FAULT, addr, byte);
+    return;
+  }
+
+  data -> m_pagesCHR[addr >> 10][addr & 0x03ff] = byte;
+  NES_TRACE_RECORD(data, TraceWriteCHR, addr, byte);
+}
+
+
+// PRG writes go to the bank registers of the mapper kind (called directly, not virtually)
+static inline void mapper_writePRG (mapper_t* core, const address_t addr, const byte_t byte)
+{
+  const mapperData_t* data = core -> data;
+  switch (NES_MAPPER_KIND_OF(data))
+  {
+#define NES_MAPPER_CASE_WRITE_PRG(kind, writePRG)	\
+    case kind:						\
+      writePRG(core, addr, byte);			\
+      break;
+    NES_MAPPER_TABLE(NES_MAPPER_CASE_WRITE_PRG)
+#undef NES_MAPPER_CASE_WRITE_PRG
+    default:
+      NES_TRACE_RECORD(data, TraceWritePRG, addr, byte);
+      break;
+  }
+}
+
+#endif
+
+// NES Emulation					October 18, 2026
+//
+//			Academic Purpose
+//
+// source: mapperDispatch.h
+// author: @misael-diaz
+//
+// Synopsis:
+// Defines the inlined (devirtualized) mapper accessors, the bus calls these instead of
+// the methods of the mapper object to skip the indirect call and the pointer chasing.
+// The methods of the mapper object are wrappers of these, so both paths agree.
+//
+// Copyright (c) 2023 Misael Diaz-Maldonado
+// This file is released under the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// References:
+// [0] https://github.com/amhndu/SimpleNES
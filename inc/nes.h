@@ -0,0 +1,52 @@
+#ifndef NES_CONSOLE_TYPE_H
+#define NES_CONSOLE_TYPE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "cpu.h"
+#include "cartridge.h"
+#include "mapper.h"
+#include "scheduler.h"
+
+typedef struct	// NES (the console: cartridge, mapper, bus, and CPU)
+{
+  // private:
+  void* data;
+  // public:
+  size_t (*runFrame) (void*);				// executes one video frame
+  size_t (*run) (void*, size_t);			// executes a budget of cycles
+  cpu_t* (*getCPU) (const void*);
+  uint64_t (*getFrameCount) (const void*);
+  void (*setIdleSkip) (void*, bool);			// opts the ROM in (or out)
+  uint64_t (*getSkippedCycles) (const void*);		// fast-forwarded (idle loops)
+} nes_t;
+
+typedef struct
+{
+  nes_t* (*create) (const char*, cpuEngine_t);
+  nes_t* (*destroy) (nes_t*);
+} nes_namespace_t;
+
+#endif
+
+// NES Emulation					October 18, 2026
+//
+//			Academic Purpose
+//
+// source: nes.h
+// author: @misael-diaz
+//
+// Synopsis:
+// NES header file.
+// Defines the console type, which wires the cartridge mapper and the CPU to the bus and
+// runs the CPU in batches (a video frame or a budget of cycles at a time) up to the timed
+// events of its scheduler.
+//
+// Copyright (c) 2023 Misael Diaz-Maldonado
+// This file is released under the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// References:
+// [0] https://github.com/amhndu/SimpleNES
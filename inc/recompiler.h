@@ -0,0 +1,49 @@
+#ifndef NES_RECOMPILER_TYPE_H
+#define NES_RECOMPILER_TYPE_H
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "blockCache.h"
+
+#define NES_RECOMPILER_ARENA ( (size_t) 0x100000 )	// bytes of the code arena (1MB)
+#define NES_RECOMPILER_THRESHOLD ( (uint16_t) 32 )	// executions that make a block hot
+
+typedef struct	// Recompiler (6502 blocks to x86-64 machine code)
+{
+  // private:
+  void* data;
+} recompiler_t;
+
+typedef struct
+{
+  recompiler_t* (*create) (size_t);
+  recompiler_t* (*destroy) (recompiler_t*);
+  native_t (*compile) (recompiler_t*, const block_t*);
+  bool (*isFull) (const recompiler_t*);
+  void (*reset) (recompiler_t*);
+} recompiler_namespace_t;
+
+#endif
+
+// NES Emulation					October 18, 2026
+//
+//			Academic Purpose
+//
+// source: recompiler.h
+// author: @misael-diaz
+//
+// Synopsis:
+// Recompiler header file.
+// Defines the recompiler, which translates the hot blocks of the block cache into x86-64
+// machine code held in an executable (mmap'd) arena. It is available on x86-64 (unix)
+// only, create() returns NULL elsewhere and the CPU keeps interpreting.
+//
+// Copyright (c) 2023 Misael Diaz-Maldonado
+// This file is released under the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// References:
+// [0] https://github.com/amhndu/SimpleNES
@@ -0,0 +1,46 @@
+#ifndef NES_ROMSTORE_TYPE_H
+#define NES_ROMSTORE_TYPE_H
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "byte.h"
+
+typedef struct romimage	// shared immutable ROM image (PRG-ROM or CHR-ROM)
+{
+  // public:
+  const byte_t* bytes;
+  size_t size;
+  // private:
+  uint64_t key;
+  size_t refs;
+  struct romimage* next;
+} romimage_t;
+
+typedef struct
+{
+  romimage_t* (*acquire) (byte_t*, const size_t, const uint64_t);
+  romimage_t* (*release) (romimage_t*);
+  size_t (*count) (void);
+} romstore_namespace_t;
+
+#endif
+
+// NES Emulation					October 18, 2026
+//
+//			Academic Purpose
+//
+// source: romstore.h
+// author: @misael-diaz
+//
+// Synopsis:
+// ROM store header file.
+// Defines the process-wide store of reference-counted ROM images.
+//
+// Copyright (c) 2023 Misael Diaz-Maldonado
+// This file is released under the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// References:
+// [0] https://github.com/amhndu/SimpleNES
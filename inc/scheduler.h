@@ -0,0 +1,64 @@
+#ifndef NES_SCHEDULER_TYPE_H
+#define NES_SCHEDULER_TYPE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define NES_SCHEDULER_CAPACITY ( (size_t) 16 )	// pending events of the console
+#define NES_SCHEDULER_NEVER ( (uint64_t) UINT64_MAX )	// time of the next event if none
+
+typedef enum	// Scheduler::Event::Kind
+{
+  NMIEvent,						// vertical blank (PPU NMI)
+  DMAEvent,						// completion of the DMA
+  FrameEndEvent,					// end of the video frame
+} eventKind_t;
+
+typedef struct	// Scheduler::Event
+{
+  uint64_t time;					// master clock (when due)
+  uint64_t order;					// (ties are due in order)
+  eventKind_t kind;
+} event_t;
+
+typedef struct	// Scheduler (min-heap of the timed events, keyed by master clock)
+{
+  // private:
+  void* data;
+  // public:
+  bool (*schedule) (void*, uint64_t, eventKind_t);	// adds the event due at time
+  size_t (*cancel) (void*, eventKind_t);		// removes the events of the kind
+  uint64_t (*next) (const void*);			// time of the earliest event
+  bool (*pop) (void*, uint64_t, event_t*);		// removes the earliest if due
+  size_t (*getCount) (const void*);			// pending events
+} scheduler_t;
+
+typedef struct
+{
+  scheduler_t* (*create) (size_t);
+  scheduler_t* (*destroy) (scheduler_t*);
+} scheduler_namespace_t;
+
+#endif
+
+// NES Emulation					October 18, 2026
+//
+//			Academic Purpose
+//
+// source: scheduler.h
+// author: @misael-diaz
+//
+// Synopsis:
+// Scheduler header file.
+// Defines the scheduler, a binary min-heap of the timed events of the console (NMI, DMA
+// completion, frame end) keyed by the master clock, so that the CPU runs
+// (catches up) straight to the next event rather than in lockstep with the other parts.
+//
+// Copyright (c) 2023 Misael Diaz-Maldonado
+// This file is released under the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// References:
+// [0] https://github.com/amhndu/SimpleNES
@@ -0,0 +1,46 @@
+#ifndef NES_STREAM_TYPE_H
+#define NES_STREAM_TYPE_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "byte.h"
+
+typedef struct	// Stream (of ROM bytes)
+{
+  // private:
+  void* data;
+  // public:
+  size_t (*read) (void*, byte_t*, size_t);
+  bool (*verify) (void*);				// reads to the end, checks the CRC32
+} stream_t;
+
+typedef struct
+{
+  stream_t* (*openFile) (const char*);
+  stream_t* (*openMemory) (const byte_t*, size_t);
+  stream_t* (*openArchive) (const char*);
+  stream_t* (*destroy) (stream_t*);
+} stream_namespace_t;
+
+#endif
+
+// NES Emulation					October 18, 2026
+//
+//			Academic Purpose
+//
+// source: stream.h
+// author: @misael-diaz
+//
+// Synopsis:
+// Stream header file.
+// Defines the stream type, the source of the bytes the cartridge loads the ROM from
+// (a file, a buffer, or the entry of a gzip or zip archive inflated on the fly).
+//
+// Copyright (c) 2023 Misael Diaz-Maldonado
+// This file is released under the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// References:
+// [0] https://github.com/amhndu/SimpleNES
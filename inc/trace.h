@@ -0,0 +1,117 @@
+#ifndef NES_TRACE_TYPE_H
+#define NES_TRACE_TYPE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+#define NES_TRACE_MAGIC "NESTRACE"
+#define NES_TRACE_VERSION ( (uint32_t) 1 )
+#define NES_TRACE_CAPACITY ( (size_t) 0x10000 )
+#define NES_TRACE_FAULT ( (uint8_t) 0x80 )	// flags accesses the mapper rejected
+
+typedef enum	// Trace::Operation
+{
+  TraceReadPRG = 0,
+  TraceReadCHR = 1,
+  TraceWritePRG = 2,
+  TraceWriteCHR = 3,
+  TraceScanlineIRQ = 4,
+} traceOp_t;
+
+typedef struct	// Trace::Record (fixed-size, binary)
+{
+  uint64_t cycle;
+  uint32_t address;
+  uint16_t kind;
+  uint8_t op;
+  uint8_t value;
+} traceRecord_t;
+
+typedef struct	// Trace (single-producer single-consumer lock-free ring)
+{
+  // producer side:
+  _Alignas(64) atomic_size_t head;
+  size_t tail_cached;
+  uint64_t cycle;				// (of the records, stamped by the console)
+  size_t dropped;
+  // consumer side:
+  _Alignas(64) atomic_size_t tail;
+  size_t reported;				// (records dropped as of the last dump)
+  // shared (read-only):
+  _Alignas(64) size_t mask;
+  traceRecord_t* records;
+} trace_t;
+
+typedef struct
+{
+  trace_t* (*create) (size_t);
+  trace_t* (*destroy) (trace_t*);
+  size_t (*drain) (trace_t*, FILE*);
+  size_t (*dump) (trace_t*, const char*);
+} trace_namespace_t;
+
+#if defined(NES_TRACE)
+
+// pushes the record, drops it (and counts it) if the consumer has fallen behind
+static inline void trace_push (trace_t* ring,
+			       uint16_t const kind,
+			       uint8_t const op,
+			       uint32_t const address,
+			       uint8_t const value)
+{
+  size_t const head = atomic_load_explicit(&ring -> head, memory_order_relaxed);
+  if (head - ring -> tail_cached > ring -> mask)
+  {
+    ring -> tail_cached = atomic_load_explicit(&ring -> tail, memory_order_acquire);
+    if (head - ring -> tail_cached > ring -> mask)
+    {
+      ++ring -> dropped;
+      return;
+    }
+  }
+
+  traceRecord_t* record = &ring -> records[head & ring -> mask];
+  record -> cycle = ring -> cycle;
+  record -> address = address;
+  record -> kind = kind;
+  record -> op = op;
+  record -> value = value;
+  atomic_store_explicit(&ring -> head, head + 1, memory_order_release);
+}
+
+#define NES_TRACE_RECORD(data, op, address, value) \
+  trace_push((data) -> m_trace, (data) -> m_kind, (op), (address), (value))
+
+#else
+
+#define NES_TRACE_RECORD(data, op, address, value) \
+  ( (void) (data), (void) (address), (void) (value) )
+
+#endif
+
+#endif
+
+// NES Emulation					October 18, 2026
+//
+//			Academic Purpose
+//
+// source: trace.h
+// author: @misael-diaz
+//
+// Synopsis:
+// Trace header file.
+// Defines the trace type, a per-mapper ring of binary records of the memory accesses.
+// Tracing is compiled in with NES_TRACE (make TRACE=1), otherwise NES_TRACE_RECORD()
+// expands to nothing and the hot paths pay nothing for it. The records are decoded
+// offline with the nes-tracedump tool.
+//
+// Copyright (c) 2023 Misael Diaz-Maldonado
+// This file is released under the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// References:
+// [0] https://github.com/amhndu/SimpleNES
+// [1] https://www.1024cores.net/home/lock-free-algorithms/queues
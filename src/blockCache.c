@@ -0,0 +1,105 @@
+#include <stdio.h>
+#include <string.h>
+#include "blockCache.h"
+
+
+static blockCache_t* create (void)
+{
+  blockCache_t* cache = malloc( sizeof(blockCache_t) );
+  if (cache == NULL)
+  {
+    printf("BlockCache::BlockCache() failed to allocate the block cache!\n");
+    return cache;
+  }
+
+  cache -> blocks = (block_t*) calloc( NES_BLOCK_CACHE_SIZE, sizeof(block_t) );
+  if (cache -> blocks == NULL)
+  {
+    free(cache);
+    cache = NULL;
+    printf("BlockCache::BlockCache() failed to allocate the blocks!\n");
+    return cache;
+  }
+
+  // the empty slots (NULL page) never match:
+  cache -> epoch = 1;
+  cache -> banked = false;
+  memset(cache -> pages, 0, sizeof(cache -> pages));
+  return cache;
+}
+
+
+static blockCache_t* destroy (blockCache_t* cache)
+{
+  if (cache == NULL)
+  {
+    return cache;
+  }
+
+  free(cache -> blocks);
+  cache -> blocks = NULL;
+
+  free(cache);
+  cache = NULL;
+  return cache;
+}
+
+
+// discards the blocks of RAM code (the blocks of ROM code stay valid)
+static void invalidate (blockCache_t* cache)
+{
+  ++cache -> epoch;
+  if (cache -> epoch == 0)			// 0 tags the blocks of ROM code
+  {
+    memset(cache -> blocks, 0, NES_BLOCK_CACHE_SIZE * sizeof(block_t));
+    cache -> epoch = 1;
+  }
+
+  for (size_t i = 0; i != sizeof(cache -> pages); ++i)
+  {
+    cache -> pages[i] &= ~CodePage;
+  }
+}
+
+
+// discards all the blocks (the blocks of ROM code too), the block being executed is left
+// intact but it no longer matches
+static void flush (blockCache_t* cache)
+{
+  for (size_t i = 0; i != NES_BLOCK_CACHE_SIZE; ++i)
+  {
+    cache -> blocks[i].page = NULL;
+    cache -> blocks[i].native = NULL;
+    cache -> blocks[i].heat = 0;
+  }
+
+  invalidate(cache);
+}
+
+
+blockCache_namespace_t const blockCache = {
+  .create = create,
+  .destroy = destroy,
+  .invalidate = invalidate,
+  .flush = flush
+};
+
+
+// NES Emulation					October 18, 2026
+//
+//			Academic Purpose
+//
+// source: blockCache.c
+// author: @misael-diaz
+//
+// Synopsis:
+// Implements the methods of the block cache object.
+// The CPU decodes the blocks (it owns the opcode table) and stores them here.
+//
+// Copyright (c) 2023 Misael Diaz-Maldonado
+// This file is released under the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// References:
+// [0] https://github.com/amhndu/SimpleNES
@@ -1,37 +1,758 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <stdbool.h>
 #include "bus.h"
+#include "mapperDispatch.h"
+
+extern blockCache_namespace_t const blockCache;
+extern mapper_namespace_t const mapper;
+
+#define NES_BUS_WATCH_RANGES ( (size_t) 5 )	// (a range resolves into as many at most)
 
 
 static byte_t read (const void* vbus, address_t const address)
 {
   const bus_t* bus = vbus;
-  const byte_t* ram = bus -> ram;
+  const byte_t* page = bus -> reads[address >> 8];
+  if (page != NULL)
+  {
+    return page[address & 0x00ff];
+  }
+
+  const busHandler_t* handler = &bus -> handler[bus -> handlers[address >> 8]];
+  return handler -> read(handler -> context, address);
+}
+
 
-  // NOTE: ignore GCC -Wtype-limits warning regarding that the condition is always true
-  bool const isValidAddressableRange = (address >= 0x0000 && address <= 0xFFFF);
-  if (isValidAddressableRange)
+// discards the decoded code of the CPU if it was overwritten
+static void overwrote (bus_t* bus, address_t const address)
+{
+  blockCache_t* cache = bus -> cache;
+  if (cache != NULL && (cache -> pages[address >> 8] & CodePage))
   {
-    byte_t const data = ram[address];
-    return data;
+    blockCache.invalidate(cache);
+  }
+}
+
+
+static void write (void* vbus, address_t const address, byte_t const data)
+{
+  bus_t* bus = vbus;
+  byte_t* page = bus -> writes[address >> 8];
+  if (page == NULL)
+  {
+    const busHandler_t* handler = &bus -> handler[bus -> handlers[address >> 8]];
+    handler -> write(handler -> context, address, data);
+    return;
+  }
+
+  page[address & 0x00ff] = data;
+  overwrote(bus, address);
+}
+
+
+// the PPU registers ($2000 - $2007, mirrored up to $3FFF) are latched (there is no PPU),
+// but OAMDATA accesses the OAM at OAMADDR (which the writes advance) ref[2]
+static byte_t readPPU (void* vbus, address_t const address)
+{
+  const bus_t* bus = vbus;
+  byte_t const reg = (address & 0x0007);
+  return (reg == 0x04)? bus -> oam[bus -> ppu[0x03]] : bus -> ppu[reg];
+}
+
+
+static void writePPU (void* vbus, address_t const address, byte_t const data)
+{
+  bus_t* bus = vbus;
+  byte_t const reg = (address & 0x0007);
+  bus -> ppu[reg] = data;
+  if (reg == 0x04)
+  {
+    bus -> oam[bus -> ppu[0x03]] = data;
+    ++bus -> ppu[0x03];
+  }
+}
+
+
+// copies the page into the OAM (from OAMADDR on, wrapping around) ref[2], the page read
+// straight is copied at once and the rest (I/O, watched) is read through the bus
+static void dma (bus_t* bus, byte_t const page)
+{
+  byte_t* oam = bus -> oam;
+  size_t const start = bus -> ppu[0x03];
+  const byte_t* source = bus -> reads[page];
+  if (source != NULL)
+  {
+    memcpy(oam + start, source, NES_BUS_OAM - start);
+    memcpy(oam, source + (NES_BUS_OAM - start), start);
   }
   else
   {
-    return 0x00;
+    for (size_t i = 0; i != NES_BUS_OAM; ++i)
+    {
+      oam[(start + i) & 0xff] = read(bus, (page << 8) | i);
+    }
   }
+
+  bus -> halt = true;
 }
 
 
-static void write (void* vbus, address_t const address, byte_t const data)
+// the APU and I/O registers ($4000 - $401F) are latched (there is no APU), the rest of
+// the page is open bus (the high byte of the address is the last byte on the data bus)
+static byte_t readIO (void* vbus, address_t const address)
+{
+  const bus_t* bus = vbus;
+  return (address < 0x4020)? bus -> io[address & 0x001f] : (address >> 8);
+}
+
+
+static void writeIO (void* vbus, address_t const address, byte_t const data)
+{
+  bus_t* bus = vbus;
+  if (address < 0x4020)
+  {
+    bus -> io[address & 0x001f] = data;
+  }
+
+  if (address == 0x4014)
+  {
+    dma(bus, data);
+  }
+}
+
+
+static byte_t readOpenBus (void* vbus, address_t const address)
+{
+  (void) vbus;
+  return (address >> 8);
+}
+
+
+static void writeOpenBus (void* vbus, address_t const address, byte_t const data)
+{
+  (void) vbus;
+  (void) address;
+  (void) data;
+}
+
+
+// the cartridge space goes to the mapper:
+static byte_t readPRG (void* vbus, address_t const address)
+{
+  const bus_t* bus = vbus;
+  const mapper_t* map = bus -> mapper;
+  return mapper_readPRG(map -> data, address);
+}
+
+
+static void writePRG (void* vbus, address_t const address, byte_t const data)
+{
+  bus_t* bus = vbus;
+  mapper_writePRG(bus -> mapper, address, data);
+}
+
+
+// the pages shared by devices go to the handler of the byte (by the split table):
+static byte_t readSplit (void* vbus, address_t const address)
+{
+  const bus_t* bus = vbus;
+  const byte_t* split = bus -> split[bus -> splits[address >> 8]];
+  const busHandler_t* handler = &bus -> handler[split[address & 0x00ff]];
+  return handler -> read(handler -> context, address);
+}
+
+
+static void writeSplit (void* vbus, address_t const address, byte_t const data)
+{
+  bus_t* bus = vbus;
+  const byte_t* split = bus -> split[bus -> splits[address >> 8]];
+  const busHandler_t* handler = &bus -> handler[split[address & 0x00ff]];
+  handler -> write(handler -> context, address, data);
+}
+
+
+static void setHandler (bus_t* bus,
+			busHandlerKind_t const kind,
+			byte_t (*read) (void*, const address_t),
+			void (*write) (void*, const address_t, const byte_t))
+{
+  busHandler_t* handler = &bus -> handler[kind];
+  handler -> read = read;
+  handler -> write = write;
+  handler -> context = bus;
+}
+
+
+// gets the mapping of the page by the memory map (ref[1]): the 2KB of work RAM (mirrored
+// up to $1FFF), the PPU registers, the APU and I/O registers, the expansion area (open
+// bus), the PRG-RAM (if connected), and the cartridge (if connected); the PRG-ROM banks
+// are read straight (unless tracing, the handler records the reads) and the writes go to
+// the mapper registers
+static busHandlerKind_t memoryMap (const bus_t* bus,
+				   size_t const index,
+				   const byte_t** reads,
+				   byte_t** writes)
+{
+  *reads = NULL;
+  *writes = NULL;
+  if (index < 0x20)
+  {
+    byte_t* page = bus -> ram + ( (index & 0x07) << 8 );
+    *reads = page;
+    *writes = page;
+    return OpenBusHandler;
+  }
+
+  if (index < 0x40)
+  {
+    return PPUHandler;
+  }
+
+  if (index == 0x40)
+  {
+    return IOHandler;
+  }
+
+  if (index < 0x80)
+  {
+    if (index >= 0x60 && bus -> prgRAM != NULL)
+    {
+      size_t const pages = (bus -> sizePRGRAM >> 8);
+      byte_t* page = bus -> prgRAM + ( ( (index - 0x60) % pages ) << 8 );
+      *reads = page;
+      *writes = page;
+    }
+
+    return OpenBusHandler;
+  }
+
+  if (bus -> mapper == NULL)
+  {
+    return OpenBusHandler;
+  }
+
+#if !defined(NES_TRACE)
+  const mapperData_t* data = bus -> mapper -> data;
+  *reads = data -> m_pagesPRG[(index >> 5) & 0x03] + ( (index & 0x1f) << 8 );
+#endif
+  return CartridgeHandler;
+}
+
+
+// gets the mapping of the page, the pages claimed by the devices go to their handler
+static byte_t home (const bus_t* bus,
+		    size_t const index,
+		    const byte_t** reads,
+		    byte_t** writes)
+{
+  if (bus -> claims[index] != 0)
+  {
+    *reads = NULL;
+    *writes = NULL;
+    return bus -> claims[index];
+  }
+
+  return memoryMap(bus, index, reads, writes);
+}
+
+
+// maps the page to its memory (or handler), the accesses watched go to the watch handler
+static void mapPage (bus_t* bus, size_t const index)
+{
+  const byte_t* reads = NULL;
+  byte_t* writes = NULL;
+  byte_t const kind = home(bus, index, &reads, &writes);
+  byte_t const watched = bus -> watched[index];
+  bool const isWatched = (watched & (WatchRead | WatchWrite));
+  bus -> reads[index] = (watched & WatchRead)? NULL : reads;
+  bus -> writes[index] = (watched & WatchWrite)? NULL : writes;
+  bus -> handlers[index] = (isWatched)? WatchHandler : kind;
+}
+
+
+// reads the byte by the mapping of its page, not notifying the watchers (the CPU reads the
+// code it decodes so)
+static byte_t peek (const void* vbus, address_t const address)
+{
+  const bus_t* bus = vbus;
+  if (bus -> reads[address >> 8] != NULL)
+  {
+    return bus -> reads[address >> 8][address & 0x00ff];
+  }
+
+  const byte_t* reads = NULL;
+  byte_t* writes = NULL;
+  byte_t const kind = home(bus, address >> 8, &reads, &writes);
+  if (reads != NULL)
+  {
+    return reads[address & 0x00ff];
+  }
+
+  const busHandler_t* handler = &bus -> handler[kind];
+  return handler -> read(handler -> context, address);
+}
+
+
+// resolves the mirrors of the work RAM and of the PPU registers
+static address_t canonical (address_t const address)
+{
+  if (address < 0x2000)
+  {
+    return (address & 0x07ff);
+  }
+
+  if (address < 0x4000)
+  {
+    return ( 0x2000 | (address & 0x0007) );
+  }
+
+  return address;
+}
+
+
+// invokes the watchers of the access (at the exact address range and of the kind)
+static void notify (const void* vbus,
+		    address_t const address,
+		    byte_t const value,
+		    busWatchKind_t const kind)
+{
+  const bus_t* bus = vbus;
+  address_t const target = canonical(address);
+  for (size_t i = 0; i != bus -> countWatches; ++i)
+  {
+    const busWatch_t* watch = &bus -> watches[i];
+    if ( (watch -> kinds & kind) && target >= watch -> first && target <= watch -> last )
+    {
+      watch -> watcher(watch -> context, address, value, kind);
+    }
+  }
+}
+
+
+// the slow path of the watched pages: accesses the page by its mapping and notifies
+static byte_t readWatched (void* vbus, address_t const address)
+{
+  const bus_t* bus = vbus;
+  byte_t const value = peek(bus, address);
+  notify(bus, address, value, WatchRead);
+  return value;
+}
+
+
+static void writeWatched (void* vbus, address_t const address, byte_t const data)
+{
+  bus_t* bus = vbus;
+  const byte_t* reads = NULL;
+  byte_t* writes = NULL;
+  byte_t const kind = home(bus, address >> 8, &reads, &writes);
+  if (writes != NULL)
+  {
+    writes[address & 0x00ff] = data;
+    overwrote(bus, address);
+  }
+  else
+  {
+    const busHandler_t* handler = &bus -> handler[kind];
+    handler -> write(handler -> context, address, data);
+  }
+
+  notify(bus, address, data, WatchWrite);
+}
+
+
+// flags the pages covered by the watchpoints (at all their mirrors) and remaps them, the
+// CPU accesses straight only the work RAM below the first page watched
+static void flagPages (bus_t* bus)
+{
+  bus -> straight = NES_BUS_WORK_RAM;
+  for (size_t i = 0; i != NES_BUS_PAGES; ++i)
+  {
+    address_t const first = canonical(i << 8);
+    address_t const last = canonical( (i << 8) | 0x00ff );
+    byte_t kinds = 0;
+    for (size_t j = 0; j != bus -> countWatches; ++j)
+    {
+      const busWatch_t* watch = &bus -> watches[j];
+      bool const isCovered = (watch -> first <= last && watch -> last >= first);
+      kinds |= (isCovered)? watch -> kinds : 0;
+    }
+
+    bus -> watched[i] = kinds;
+    if (i < 0x20 && (kinds & (WatchRead | WatchWrite)) && first < bus -> straight)
+    {
+      bus -> straight = first;
+    }
+
+    mapPage(bus, i);
+  }
+
+  // the CPU decodes its code afresh (minding the pages watched for execution):
+  if (bus -> cache != NULL)
+  {
+    blockCache.flush(bus -> cache);
+  }
+}
+
+
+// splits the address range into the ranges of the addresses it covers with the mirrors
+// resolved (a range wrapping around the work RAM or the PPU registers is split in two,
+// one covering a whole mirror is the whole region), returns how many ranges there are
+static size_t resolve (address_t const first,
+		       address_t const last,
+		       address_t* firsts,
+		       address_t* lasts)
+{
+  size_t const regions = 3;
+  address_t const starts[] = { 0x0000, 0x2000, 0x4000 };
+  address_t const ends[] = { 0x1fff, 0x3fff, 0xffff };
+  size_t const periods[] = { 0x0800, 0x0008, 0xc000 };	// (the rest is not mirrored)
+  size_t count = 0;
+  for (size_t i = 0; i != regions; ++i)
+  {
+    if (first > ends[i] || last < starts[i])
+    {
+      continue;
+    }
+
+    address_t const a = (first > starts[i])? first : starts[i];
+    address_t const b = (last < ends[i])? last : ends[i];
+    address_t const top = (starts[i] + periods[i] - 1);
+    address_t const lo = canonical(a);
+    address_t const hi = canonical(b);
+    if ( (size_t) (b - a) + 1 >= periods[i] )
+    {
+      firsts[count] = starts[i];
+      lasts[count] = top;
+      ++count;
+    }
+    else if (lo <= hi)
+    {
+      firsts[count] = lo;
+      lasts[count] = hi;
+      ++count;
+    }
+    else
+    {
+      firsts[count] = lo;
+      lasts[count] = top;
+      firsts[count + 1] = starts[i];
+      lasts[count + 1] = hi;
+      count += 2;
+    }
+  }
+
+  return count;
+}
+
+
+// watches the accesses (of the kinds) to the address range, the ranges in the work RAM
+// or in the PPU registers are watched at all their mirrors
+static bool watch (void* vbus,
+		   address_t const first,
+		   address_t const last,
+		   byte_t const kinds,
+		   busWatcher_t watcher,
+		   void* context)
+{
+  bus_t* bus = vbus;
+  if (first > last || kinds == 0 || watcher == NULL)
+  {
+    printf("Bus::watch() expects an address range, the kinds of access, and a watcher\n");
+    return false;
+  }
+
+  address_t firsts[NES_BUS_WATCH_RANGES];
+  address_t lasts[NES_BUS_WATCH_RANGES];
+  size_t const count = resolve(first, last, firsts, lasts);
+  if (bus -> countWatches + count > NES_BUS_WATCHES)
+  {
+    printf("Bus::watch() no room for more watchpoints!\n");
+    return false;
+  }
+
+  for (size_t i = 0; i != count; ++i)
+  {
+    busWatch_t* w = &bus -> watches[bus -> countWatches];
+    w -> first = firsts[i];
+    w -> last = lasts[i];
+    w -> from = first;
+    w -> to = last;
+    w -> kinds = (kinds & (WatchRead | WatchWrite | WatchExecute));
+    w -> watcher = watcher;
+    w -> context = context;
+    ++bus -> countWatches;
+  }
+
+  flagPages(bus);
+  return true;
+}
+
+
+// removes the watchpoints of the address range (as it was watched), returns how many
+// were removed
+static size_t unwatch (void* vbus, address_t const first, address_t const last)
 {
   bus_t* bus = vbus;
-  byte_t* ram = bus -> ram;
+  size_t removed = 0;
+  size_t i = 0;
+  while (i != bus -> countWatches)
+  {
+    busWatch_t* w = &bus -> watches[i];
+    if (w -> from == first && w -> to == last)
+    {
+      --bus -> countWatches;
+      *w = bus -> watches[bus -> countWatches];
+      ++removed;
+      continue;
+    }
 
-  bool const isValidAddressableRange = (address >= 0x0000 && address <= 0xFFFF);
-  if (isValidAddressableRange)
+    ++i;
+  }
+
+  if (removed != 0)
+  {
+    flagPages(bus);
+  }
+
+  return removed;
+}
+
+
+// maps the PRG-ROM pages (notified by the mapper on the bank switches)
+static void remapped (void* vbus)
+{
+  bus_t* bus = vbus;
+  for (size_t i = 0x80; i != NES_BUS_PAGES; ++i)
   {
-    ram[address] = data;
+    mapPage(bus, i);
+  }
+}
+
+
+static void ConnectMapper (void* vbus, mapper_t* map)
+{
+  bus_t* bus = vbus;
+  bus -> mapper = map;
+  if (map != NULL)
+  {
+    mapper.listen(map, remapped, bus);
+    remapped(bus);
+  }
+}
+
+
+// allocates the PRG-RAM of the cartridge (rounded up to whole pages) and maps it at
+// $6000 - $7FFF, mirrored if smaller than the 8KB window
+static bool ConnectPRGRAM (void* vbus, size_t const size)
+{
+  bus_t* bus = vbus;
+  if (size == 0 || size > NES_BUS_PRG_RAM || bus -> prgRAM != NULL)
+  {
+    printf("Bus::ConnectPRGRAM() expects a PRG-RAM of 1 to 8KB, connected once\n");
+    return false;
+  }
+
+  size_t const pages = ( (size + 0xff) >> 8 );
+  bus -> prgRAM = (byte_t*) calloc(pages << 8, sizeof(byte_t));
+  if (bus -> prgRAM == NULL)
+  {
+    printf("Bus::ConnectPRGRAM() failed to allocate the PRG-RAM!\n");
+    return false;
+  }
+
+  bus -> sizePRGRAM = (pages << 8);
+  for (size_t i = 0x60; i != 0x80; ++i)
+  {
+    mapPage(bus, i);
+  }
+
+  return true;
+}
+
+
+// finds the handler of the range (the ranges of the same handlers and context share one),
+// returns 0 if it is not in the handler table
+static byte_t findHandler (const bus_t* bus, const deviceRange_t* range)
+{
+  for (size_t i = DeviceHandler; i != bus -> countHandlers; ++i)
+  {
+    const busHandler_t* handler = &bus -> handler[i];
+    if (handler -> read == range -> read &&
+	handler -> write == range -> write &&
+	handler -> context == range -> context)
+    {
+      return i;
+    }
+  }
+
+  return 0;
+}
+
+
+// true if the range covers the page but part of it (the page is shared)
+static bool isPartial (const deviceRange_t* range, size_t const index)
+{
+  size_t const first = (index << 8);
+  size_t const last = (first | 0x00ff);
+  return (range -> first > first || range -> last < last);
+}
+
+
+// checks that the ranges of the device fit in the page table: the work RAM belongs to the
+// bus and the cartridge space ($6000 - $FFFF) to the mapper (the CPU decodes the code there
+// straight out of the PRG banks), so only the register pages ($2000 - $5FFF) are claimed
+static bool fits (const bus_t* bus, const device_t* dev)
+{
+  size_t countHandlers = bus -> countHandlers;
+  size_t countSplits = bus -> countSplits;
+  byte_t isSplit[NES_BUS_PAGES];
+  for (size_t i = 0; i != NES_BUS_PAGES; ++i)
+  {
+    isSplit[i] = (bus -> claims[i] == SplitHandler);
+  }
+
+  for (size_t i = 0; i != dev -> countRanges; ++i)
+  {
+    const deviceRange_t* range = &dev -> ranges[i];
+    if (range -> first < 0x2000)
+    {
+      printf("Bus::ConnectDevice() the work RAM ($0000 - $1FFF) cannot be claimed\n");
+      return false;
+    }
+
+    if (range -> last >= 0x6000)
+    {
+      printf("Bus::ConnectDevice() the cartridge space ($6000 - $FFFF) cannot be claimed\n");
+      return false;
+    }
+
+    for (size_t j = (range -> first >> 8); j <= (size_t) (range -> last >> 8); ++j)
+    {
+      if (isPartial(range, j) && !isSplit[j])
+      {
+	isSplit[j] = 1;
+	++countSplits;
+      }
+    }
+
+    bool isNew = (findHandler(bus, range) == 0);
+    for (size_t j = 0; j != i && isNew; ++j)
+    {
+      const deviceRange_t* other = &dev -> ranges[j];
+      isNew = (other -> read != range -> read ||
+	       other -> write != range -> write ||
+	       other -> context != range -> context);
+    }
+
+    countHandlers += (isNew)? 1 : 0;
+  }
+
+  if (countHandlers > NES_BUS_HANDLERS || countSplits > NES_BUS_SPLITS)
+  {
+    printf("Bus::ConnectDevice() no room for the handlers of the device!\n");
+    return false;
+  }
+
+  return true;
+}
+
+
+// shares the page among devices: the bytes keep the handler of the page until claimed
+static void split (bus_t* bus, size_t const index)
+{
+  const byte_t* reads = NULL;
+  byte_t* writes = NULL;
+  byte_t const kind = home(bus, index, &reads, &writes);
+  memset(bus -> split[bus -> countSplits], kind, NES_BUS_PAGES);
+  bus -> splits[index] = bus -> countSplits;
+  bus -> claims[index] = SplitHandler;
+  ++bus -> countSplits;
+}
+
+
+// compiles the range into the page table: its whole pages are claimed for its handler,
+// and the bytes it claims of the pages it covers in part are so in their split table
+static void compile (bus_t* bus, const deviceRange_t* range)
+{
+  byte_t kind = findHandler(bus, range);
+  if (kind == 0)
+  {
+    kind = bus -> countHandlers;
+    busHandler_t* handler = &bus -> handler[kind];
+    handler -> read = range -> read;
+    handler -> write = range -> write;
+    handler -> context = range -> context;
+    ++bus -> countHandlers;
+  }
+
+  for (size_t i = (range -> first >> 8); i <= (size_t) (range -> last >> 8); ++i)
+  {
+    if (!isPartial(range, i))
+    {
+      bus -> claims[i] = kind;
+      mapPage(bus, i);
+      continue;
+    }
+
+    if (bus -> claims[i] != SplitHandler)
+    {
+      split(bus, i);
+      mapPage(bus, i);
+    }
+
+    size_t const start = (i << 8);
+    size_t const first = (range -> first > start)? (range -> first & 0x00ff) : 0x00;
+    size_t const last = (range -> last < (start | 0x00ff))? (range -> last & 0x00ff) : 0xff;
+    memset(bus -> split[bus -> splits[i]] + first, kind, last - first + 1);
+  }
+}
+
+
+// connects the device, its address ranges go to its handlers from now on (the ranges
+// connected later take over the ranges they overlap)
+static bool ConnectDevice (void* vbus, device_t* dev)
+{
+  bus_t* bus = vbus;
+  if (dev == NULL || !fits(bus, dev))
+  {
+    printf("Bus::ConnectDevice() failed to connect the device!\n");
+    return false;
+  }
+
+  for (size_t i = 0; i != dev -> countRanges; ++i)
+  {
+    compile(bus, &dev -> ranges[i]);
+  }
+
+  // the CPU decodes its code afresh (the device may have claimed pages holding code):
+  if (bus -> cache != NULL)
+  {
+    blockCache.flush(bus -> cache);
+  }
+
+  dev -> ConnectBus(dev, bus);
+  return true;
+}
+
+
+// sets the handlers and maps the CPU address space (ref[1]), the PRG-RAM and the
+// cartridge are open bus until connected
+static void mapMemory (bus_t* bus)
+{
+  setHandler(bus, PPUHandler, readPPU, writePPU);
+  setHandler(bus, IOHandler, readIO, writeIO);
+  setHandler(bus, OpenBusHandler, readOpenBus, writeOpenBus);
+  setHandler(bus, CartridgeHandler, readPRG, writePRG);
+  setHandler(bus, WatchHandler, readWatched, writeWatched);
+  setHandler(bus, SplitHandler, readSplit, writeSplit);
+  for (size_t i = 0; i != NES_BUS_PAGES; ++i)
+  {
+    bus -> watched[i] = 0;
+    bus -> claims[i] = 0;
+    bus -> splits[i] = 0;
+    mapPage(bus, i);
   }
 }
 
@@ -45,24 +766,49 @@ static bus_t* create (device_t* cpu)
     return bus;
   }
 
-  size_t const ram_size = 64 * 1024;	// 64 KB (Fake) RAM
-  bus -> ram = (byte_t*) malloc( ram_size * sizeof(byte_t) );
+  bus -> ram = (byte_t*) calloc(NES_BUS_WORK_RAM, sizeof(byte_t));
   if (bus -> ram == NULL)
   {
     free(bus);
     bus = NULL;
-    printf("Bus::Bus() failed to allocate (Fake) RAM!\n");
+    printf("Bus::Bus() failed to allocate the work RAM!\n");
     return bus;
   }
 
-  byte_t* ram = bus -> ram;
-  for (size_t i = 0; i != ram_size; ++i)
+  for (size_t i = 0; i != sizeof(bus -> ppu); ++i)
+  {
+    bus -> ppu[i] = 0x00;
+  }
+
+  for (size_t i = 0; i != sizeof(bus -> io); ++i)
   {
-    ram[i] = 0x00;
+    bus -> io[i] = 0x00;
   }
 
+  for (size_t i = 0; i != NES_BUS_OAM; ++i)
+  {
+    bus -> oam[i] = 0x00;
+  }
+
+  bus -> halt = false;
+  bus -> prgRAM = NULL;
+  bus -> sizePRGRAM = 0;
+  bus -> mapper = NULL;
+  bus -> cache = NULL;
+  bus -> straight = NES_BUS_WORK_RAM;
+  bus -> countWatches = 0;
+  bus -> countHandlers = DeviceHandler;
+  bus -> countSplits = 0;
+  mapMemory(bus);
   bus -> read = read;
   bus -> write = write;
+  bus -> peek = peek;
+  bus -> watch = watch;
+  bus -> unwatch = unwatch;
+  bus -> notify = notify;
+  bus -> ConnectMapper = ConnectMapper;
+  bus -> ConnectPRGRAM = ConnectPRGRAM;
+  bus -> ConnectDevice = ConnectDevice;
 
   cpu -> ConnectBus(cpu, bus);
 
@@ -77,6 +823,9 @@ static bus_t* destroy (bus_t* bus)
     return bus;
   }
 
+  free(bus -> prgRAM);
+  bus -> prgRAM = NULL;
+
   free(bus -> ram);
   bus -> ram = NULL;
 
@@ -1,5 +1,13 @@
 #include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "cartridge.h"
+#include "ines.h"
+#include "fingerprint.h"
+#include "romstore.h"
+#include "stream.h"
 
 
 #define NES_FAILURE_STATE ( (int) 0xffffffff )
@@ -12,16 +20,33 @@ typedef struct
   byte_t* header;
   byte_t* m_PRG_ROM;
   byte_t* m_CHR_ROM;
+  byte_t* m_image;		// read-only mapping of the iNES file (NULL if not mapped)
+  romimage_t* m_PRG_image;	// shared PRG-ROM (NULL if privately owned or mapped)
+  romimage_t* m_CHR_image;	// shared CHR-ROM (NULL if privately owned or mapped)
+  size_t m_size_image;
+  uint32_t m_crc32_PRG;		// CRC32 of the PRG-ROM (the key of the shared image)
+  uint32_t m_crc32_CHR;		// CRC32 of the CHR-ROM (the key of the shared image)
+  uint32_t m_crc32;		// CRC32 of the PRG-ROM and CHR-ROM (ROM sans header)
+  byte_t m_sha1[20];		// SHA-1 of the PRG-ROM and CHR-ROM (ROM sans header)
+  bool m_fingerprinted;
   size_t num_banks;
   size_t num_vbanks;
-  byte_t banks;
-  byte_t vbanks;
+  size_t m_size_PRGRAM;
+  size_t m_size_CHRRAM;
+  uint16_t m_mapperNumber;
+  byte_t m_submapperNumber;
   byte_t m_nameTableMirroring;
-  byte_t m_mapperNumber;
+  byte_t m_tvSystem;
   bool m_extendedRAM;
 } data_t;
 
 
+extern ines_namespace_t const ines;
+extern fingerprint_namespace_t const fingerprint;
+extern romstore_namespace_t const romstore;
+extern stream_namespace_t const stream;
+
+
 static void util_copy (size_t size, byte_t* restrict dst, const byte_t* restrict src)
 {
   for (size_t i = 0; i != size; ++i)
@@ -31,15 +56,15 @@ static void util_copy (size_t size, byte_t* restrict dst, const byte_t* restrict
 }
 
 
-static int load_H_ROM (FILE* rom, cartridge_t* c)	// loads ROM Header into cartridge
+static int load_H_ROM (stream_t* rom, cartridge_t* c)	// loads ROM Header into cartridge
 {
   size_t size = 0x10;
   byte_t header[size];
-  size_t count = fread(header, sizeof(byte_t), size, rom);
+  size_t count = rom -> read(rom, header, size);
   if (count != size)
   {
     printf("Invalid NES ROM\n");
-    fclose(rom);
+    rom = stream.destroy(rom);
     return NES_FAILURE_STATE;
   }
 
@@ -50,7 +75,7 @@ static int load_H_ROM (FILE* rom, cartridge_t* c)	// loads ROM Header into cartr
   if (d -> header == NULL)
   {
     printf("failed to allocate memory for ROM header!\n");
-    fclose(rom);
+    rom = stream.destroy(rom);
     return NES_FAILURE_STATE;
   }
 
@@ -61,15 +86,37 @@ static int load_H_ROM (FILE* rom, cartridge_t* c)	// loads ROM Header into cartr
 }
 
 
-static int load_PRG_ROM (FILE* rom, cartridge_t* c)
+// streams the ROM in chunks straight into its (right-sized) allocation, fingerprinting
+// each chunk while it is still in the cache
+static int load_chunked (stream_t* rom, byte_t* dst, size_t const size, fingerprint_t* fp)
+{
+  size_t const size_chunk = 0x10000;
+  for (size_t offset = 0; offset != size;)
+  {
+    size_t const remaining = (size - offset);
+    size_t const size_read = (remaining < size_chunk)? remaining : size_chunk;
+    size_t const count = rom -> read(rom, dst + offset, size_read);
+    if (count != size_read)
+    {
+      return NES_FAILURE_STATE;
+    }
+
+    fingerprint.update(fp, dst + offset, count);
+    offset += count;
+  }
+
+  return NES_SUCCESS_STATE;
+}
+
+
+static int load_PRG_ROM (stream_t* rom, cartridge_t* c, fingerprint_t* fp)
 {
   data_t* d = c -> data;
   byte_t* header = d -> header;
-  byte_t banks = header[4];	// see iNES file format: https://www.nesdev.org/wiki/INES
-  printf("16KB PRG-ROM Banks: %u \n", banks);
-  if (!banks)
+  size_t const num_banks = ines.getSizeROM(header);	// PRG ROM size (bytes) ref[6]
+  printf("16KB PRG-ROM Banks: %zu \n", num_banks / 0x4000);
+  if (!num_banks)
   {
-    printf("16KB PRG-ROM Banks: %u \n", banks);
     printf("ROM does not have PRG-ROM Banks! Failed to load ROM\n");
     free(d -> header);
     d -> header = NULL;
@@ -77,72 +124,68 @@ static int load_PRG_ROM (FILE* rom, cartridge_t* c)
     free(c -> data);
     c -> data = NULL;
     d = NULL;
-    fclose(rom);
+    rom = stream.destroy(rom);
     return NES_FAILURE_STATE;
   }
 
-  d -> banks = banks;
+  d -> m_PRG_ROM = (byte_t*) malloc( num_banks * sizeof(byte_t) );
 
-  size_t num_banks = (0x4000 * banks);	// PRG ROM size (bytes) see iNES file format
-  byte_t b_PRG_ROM[num_banks];
-  size_t count = fread(b_PRG_ROM, sizeof(byte_t), num_banks, rom);
-  if (num_banks != count)
+  if (d -> m_PRG_ROM == NULL)
   {
-    printf("Failed to read PRG-ROM!\n");
+    printf("failed to allocate memory for PRG-ROM!\n");
     free(d -> header);
     d -> header = NULL;
     header = NULL;
     free(c -> data);
     c -> data = NULL;
     d = NULL;
-    fclose(rom);
+    rom = stream.destroy(rom);
     return NES_FAILURE_STATE;
   }
-  d -> num_banks = num_banks;
-
-  d -> m_PRG_ROM = (byte_t*) malloc( num_banks * sizeof(byte_t) );
 
-  if (d -> m_PRG_ROM == NULL)
+  byte_t* m_PRG_ROM = d -> m_PRG_ROM;
+  int const stat = load_chunked(rom, m_PRG_ROM, num_banks, fp);
+  if (stat == NES_FAILURE_STATE)
   {
-    printf("failed to allocate memory for PRG-ROM!\n");
+    printf("Failed to read PRG-ROM!\n");
     free(d -> header);
     d -> header = NULL;
     header = NULL;
+    free(d -> m_PRG_ROM);
+    d -> m_PRG_ROM = NULL;
     free(c -> data);
     c -> data = NULL;
     d = NULL;
-    fclose(rom);
+    rom = stream.destroy(rom);
     return NES_FAILURE_STATE;
   }
 
-  byte_t* m_PRG_ROM = d -> m_PRG_ROM;
-  util_copy(num_banks, m_PRG_ROM, b_PRG_ROM);
+  d -> num_banks = num_banks;
+  d -> m_crc32_PRG = fingerprint.section(fp);
 
   return NES_SUCCESS_STATE;
 }
 
 
-static int load_CHR_ROM (FILE* rom, cartridge_t* c)
+static int load_CHR_ROM (stream_t* rom, cartridge_t* c, fingerprint_t* fp)
 {
   data_t* d = c -> data;
   byte_t* header = d -> header;
-  byte_t vbanks = header[5];	// see iNES file format https://www.nesdev.org/wiki/INES
-  d -> vbanks = vbanks;
-  printf("8KB CHR-ROM Banks: %u \n", vbanks);
+  size_t const num_vbanks = ines.getSizeVROM(header);	// CHR ROM size (bytes) ref[6]
+  printf("8KB CHR-ROM Banks: %zu \n", num_vbanks / 0x2000);
 
-  if (vbanks == 0)
+  if (num_vbanks == 0)
   {
     d -> num_vbanks = 0;
     d -> m_CHR_ROM = NULL;
     return NES_SUCCESS_STATE;
   }
 
-  size_t num_vbanks = (0x2000 * vbanks);	// CHR ROM size (bytes), see iNES format
-  byte_t b_CHR_ROM[num_vbanks];
-  size_t count = fread(b_CHR_ROM, sizeof(byte_t), num_vbanks, rom);
-  if (num_vbanks != count)
+  d -> m_CHR_ROM = (byte_t*) malloc( num_vbanks * sizeof(byte_t) );
+
+  if (d -> m_CHR_ROM == NULL)
   {
-    printf("Failed to read CHR-ROM!\n");
+    printf("failed to allocate memory for CHR-ROM!\n");
     free(d -> header);
     d -> header = NULL;
     header = NULL;
@@ -151,66 +194,88 @@ static int load_CHR_ROM (FILE* rom, cartridge_t* c)
     free(c -> data);
     c -> data = NULL;
     d = NULL;
-    fclose(rom);
+    rom = stream.destroy(rom);
     return NES_FAILURE_STATE;
   }
-  d -> num_vbanks = num_vbanks;
-
-  d -> m_CHR_ROM = (byte_t*) malloc( num_vbanks * sizeof(byte_t) );
 
-  if (d -> m_CHR_ROM == NULL)
+  byte_t* m_CHR_ROM = d -> m_CHR_ROM;
+  int const stat = load_chunked(rom, m_CHR_ROM, num_vbanks, fp);
+  if (stat == NES_FAILURE_STATE)
   {
-    printf("failed to allocate memory for CHR-ROM!\n");
+    printf("Failed to read CHR-ROM!\n");
     free(d -> header);
     d -> header = NULL;
     header = NULL;
     free(d -> m_PRG_ROM);
     d -> m_PRG_ROM = NULL;
+    free(d -> m_CHR_ROM);
+    d -> m_CHR_ROM = NULL;
     free(c -> data);
     c -> data = NULL;
     d = NULL;
-    fclose(rom);
+    rom = stream.destroy(rom);
     return NES_FAILURE_STATE;
   }
 
-  byte_t* m_CHR_ROM = d -> m_CHR_ROM;
-  util_copy(num_vbanks, m_CHR_ROM, b_CHR_ROM);
+  d -> num_vbanks = num_vbanks;
+  d -> m_crc32_CHR = fingerprint.section(fp);
 
   printf("ROM with CHR-RAM\n");
   return NES_SUCCESS_STATE;
 }
 
 
-static void setTableMirroring (cartridge_t* c)	// ref[2]
+// shares the loaded PRG-ROM and CHR-ROM with the cartridges holding the same ROM
+static void intern_ROM (cartridge_t* c)
 {
   data_t* d = c -> data;
-  byte_t* header = d -> header;
-  byte_t const isFourScreenMirroringEnabled = (header[6] & 0x08);
-  if (isFourScreenMirroringEnabled)
+
+  byte_t* m_PRG_ROM = d -> m_PRG_ROM;
+  size_t const num_banks = d -> num_banks;
+  uint64_t const key_PRG = ( ( (uint64_t) num_banks << 32 ) | d -> m_crc32_PRG );
+  romimage_t* image_PRG = romstore.acquire(m_PRG_ROM, num_banks, key_PRG);
+  if (image_PRG != NULL)
   {
-    nameTableMirroring_t mirroring = FourScreen;
-    byte_t m_nameTableMirroring = mirroring;
-    printf("Name Table Mirroring: %u \n", m_nameTableMirroring);
-    d -> m_nameTableMirroring = m_nameTableMirroring;
+    d -> m_PRG_image = image_PRG;
+    d -> m_PRG_ROM = (byte_t*) image_PRG -> bytes;
   }
-  else
+
+  byte_t* m_CHR_ROM = d -> m_CHR_ROM;
+  if (m_CHR_ROM == NULL)
   {
-    byte_t const isVerticalMirroringEnabled = (header[6] & 0x01);
-    byte_t m_nameTableMirroring = isVerticalMirroringEnabled;
-    switch (m_nameTableMirroring)
-    {
-      case 0:
-	printf("Name Table Mirroring: Horizontal\n");
-	break;
-      case 1:
-	printf("Name Table Mirroring: Vertical\n");
-	break;
-      default:
-	printf("Name Table Mirroring: Impossible\n");
-	break;
-    }
-    d -> m_nameTableMirroring = m_nameTableMirroring;
+    return;
+  }
+
+  size_t const num_vbanks = d -> num_vbanks;
+  uint64_t const key_CHR = ( ( (uint64_t) num_vbanks << 32 ) | d -> m_crc32_CHR );
+  romimage_t* image_CHR = romstore.acquire(m_CHR_ROM, num_vbanks, key_CHR);
+  if (image_CHR != NULL)
+  {
+    d -> m_CHR_image = image_CHR;
+    d -> m_CHR_ROM = (byte_t*) image_CHR -> bytes;
+  }
+}
+
+
+static void setTableMirroring (cartridge_t* c)	// ref[2]
+{
+  data_t* d = c -> data;
+  byte_t* header = d -> header;
+  nameTableMirroring_t const mirroring = ines.getNameTableMirroring(header);
+  byte_t const m_nameTableMirroring = mirroring;
+  switch (mirroring)
+  {
+    case Horizontal:
+      printf("Name Table Mirroring: Horizontal\n");
+      break;
+    case Vertical:
+      printf("Name Table Mirroring: Vertical\n");
+      break;
+    default:
+      printf("Name Table Mirroring: %u \n", m_nameTableMirroring);
+      break;
   }
+  d -> m_nameTableMirroring = m_nameTableMirroring;
 }
 
 
@@ -218,11 +283,29 @@ static void setMapperNumber (cartridge_t* c)
 {
   data_t* d = c -> data;
   byte_t* header = d -> header;
-  byte_t const lowerMapperNumberNybble = ( (header[6] >> 4) & 0x0f );	// ref[2]
-  byte_t const upperMapperNumberNybble = (header[7] & 0xf0);		// ref[3]
-  byte_t const m_mapperNumber = (upperMapperNumberNybble | lowerMapperNumberNybble);
+  uint16_t const m_mapperNumber = ines.getMapperNumber(header);	// ref[2], ref[3]
+  byte_t const m_submapperNumber = ines.getSubmapperNumber(header);	// ref[6]
   d -> m_mapperNumber = m_mapperNumber;
+  d -> m_submapperNumber = m_submapperNumber;
   printf("Mapper Number: %u \n", m_mapperNumber);
+  if (ines.isNES20(header))
+  {
+    printf("Submapper Number: %u \n", m_submapperNumber);
+  }
+}
+
+
+static void setRAMSizes (cartridge_t* c)					// ref[6]
+{
+  data_t* d = c -> data;
+  byte_t* header = d -> header;
+  d -> m_size_PRGRAM = ines.getSizePRGRAM(header);
+  d -> m_size_CHRRAM = ines.getSizeCHRRAM(header);
+  if (ines.isNES20(header))
+  {
+    printf("PRG-RAM size: %zu \n", d -> m_size_PRGRAM);
+    printf("CHR-RAM size: %zu \n", d -> m_size_CHRRAM);
+  }
 }
 
 
@@ -230,8 +313,7 @@ static void setExtendedRAM (cartridge_t* c)
 {
   data_t* d = c -> data;
   byte_t* header = d -> header;
-  byte_t const isExtendedRAMBitSet = (header[6] & 0x02); 		// ref[2]
-  bool m_extendedRAM = (isExtendedRAMBitSet)? true : false;
+  bool const m_extendedRAM = ines.hasExtendedRAM(header);		// ref[2]
   d -> m_extendedRAM = m_extendedRAM;
   printf("Extended CPU RAM: %u \n", m_extendedRAM);
 }
@@ -241,10 +323,19 @@ static void info_colorSystem (cartridge_t* c)
 {
   data_t* d = c -> data;
   byte_t* header = d -> header;
+  d -> m_tvSystem = ines.getTVSystem(header);
+
+  // NES 2.0 states the CPU/PPU timing
+  if (ines.isNES20(header))
+  {
+    const char* timing[] = {"NTSC", "PAL", "Multiple-Region", "Dendy"};
+    printf("CPU/PPU Timing: %s (NES 2.0)\n", timing[d -> m_tvSystem]);
+    return;
+  }
 
   // official specification
-  byte_t const isPALEnabled1 = (header[0x09] & 0x01);			// ref[4]
-  if (isPALEnabled1)
+  tvSystem_t const official = ines.getTVSystemOfficial(header);	// ref[4]
+  if (official == PAL)
   {
     printf("Uses PAL TV System (official specification)\n");
   }
@@ -254,39 +345,30 @@ static void info_colorSystem (cartridge_t* c)
   }
 
   // unofficial specification (few emulators use it, see ref[5])
-  byte_t const isPALEnabled2 = ( (header[0x0a] & 0x03) == 0x02 );	// ref[5]
-  if (isPALEnabled2)
-  {
-    // NOTE: dunno why the ROM is not PAL compatible and how serious that really is
-    // Perhaps it is okay if it supports one or the other but this will have to be
-    // resolved later.
-    printf("Uses PAL TV System (unofficial specification)\n");
-  }
-  else
+  // NOTE: dunno why the ROM is not PAL compatible and how serious that really is
+  // Perhaps it is okay if it supports one or the other but this will have to be
+  // resolved later.
+  tvSystem_t const unofficial = ines.getTVSystemUnofficial(header);	// ref[5]
+  switch (unofficial)
   {
-    byte_t const byte = (header[0x0a] & 0x03);
-    switch (byte)
-    {
-      case 0:
-	printf("NTSC TV System (unofficial specification)\n");
-	break;
-      case 2:
-	printf("PAL TV System (unofficial specification)\n");
-	break;
-      default:
-	printf("Dual NTSC PAL TV System (unofficial specification)\n");
-	break;
-    }
+    case NTSC:
+      printf("NTSC TV System (unofficial specification)\n");
+      break;
+    case PAL:
+      printf("PAL TV System (unofficial specification)\n");
+      break;
+    default:
+      printf("Dual NTSC PAL TV System (unofficial specification)\n");
+      break;
   }
 }
 
 
-static int hasTrainerSupport (FILE* rom, cartridge_t* c)	// ref[2]
+static int hasTrainerSupport (stream_t* rom, cartridge_t* c)	// ref[2]
 {
   data_t* d = c -> data;
   byte_t* header = d -> header;
-  byte_t const isTrainerBitSet = (header[6] & 0x04);
-  if (isTrainerBitSet)
+  if (ines.hasTrainer(header))
   {
     printf("Unsupported Trainer!\n");
     free(d -> header);
@@ -295,7 +377,7 @@ static int hasTrainerSupport (FILE* rom, cartridge_t* c)	// ref[2]
     free(c -> data);
     c -> data = NULL;
     d = NULL;
-    fclose(rom);
+    rom = stream.destroy(rom);
     return NES_FAILURE_STATE;
   }
 
@@ -303,23 +385,41 @@ static int hasTrainerSupport (FILE* rom, cartridge_t* c)	// ref[2]
 }
 
 
-static void loadFromFile (void* v_cartridge)
+// reads the rest of the (archived) ROM and checks its CRC32 ref[7]
+static int verify_ROM (stream_t* rom, cartridge_t* c)
 {
-  cartridge_t* c = v_cartridge;
-  FILE* rom = fopen("ROM", "rb");
-  if (rom == NULL)
+  if (!rom -> verify(rom))
   {
-    printf("failed to read ROM\n");
-    return;
+    data_t* d = c -> data;
+    printf("Corrupted ROM archive (CRC32 mismatch or truncated)! Failed to load ROM\n");
+    free(d -> header);
+    d -> header = NULL;
+    free(d -> m_PRG_ROM);
+    d -> m_PRG_ROM = NULL;
+    free(d -> m_CHR_ROM);
+    d -> m_CHR_ROM = NULL;
+    free(c -> data);
+    c -> data = NULL;
+    d = NULL;
+    rom = stream.destroy(rom);
+    return NES_FAILURE_STATE;
   }
 
+  return NES_SUCCESS_STATE;
+}
+
+
+// loads the ROM from the stream (the stream is destroyed on return), returns false if it
+// failed to (the cartridge then holds no ROM)
+static bool load (cartridge_t* c, stream_t* rom)
+{
   // reads ROM header:
 
   int stat;
   stat = load_H_ROM(rom, c);
   if (stat == NES_FAILURE_STATE)
   {
-    return;
+    return false;
   }
 
   // reads ROM data:
@@ -327,27 +427,184 @@ static void loadFromFile (void* v_cartridge)
   stat = hasTrainerSupport(rom, c);
   if (stat == NES_FAILURE_STATE)
   {
-    return;
+    return false;
   }
 
-  stat = load_PRG_ROM(rom, c);
+  fingerprint_t fp;
+  fingerprint.init(&fp);
+
+  stat = load_PRG_ROM(rom, c, &fp);
   if (stat == NES_FAILURE_STATE)
   {
-    return;
+    return false;
   }
 
-  stat = load_CHR_ROM(rom, c);
+  stat = load_CHR_ROM(rom, c, &fp);
   if (stat == NES_FAILURE_STATE)
   {
-    return;
+    return false;
   }
 
+  stat = verify_ROM(rom, c);
+  if (stat == NES_FAILURE_STATE)
+  {
+    return false;
+  }
+
+  data_t* d = c -> data;
+  fingerprint.final(&fp, &d -> m_crc32, d -> m_sha1);
+  d -> m_fingerprinted = true;
+
+  intern_ROM(c);
+
   setTableMirroring(c);
   setMapperNumber(c);
+  setRAMSizes(c);
   setExtendedRAM(c);
   info_colorSystem(c);
 
-  fclose(rom);
+  rom = stream.destroy(rom);
+  return true;
+}
+
+
+static bool loadFromFile (void* v_cartridge, const char* path)
+{
+  cartridge_t* c = v_cartridge;
+  stream_t* rom = stream.openFile(path);
+  if (rom == NULL)
+  {
+    printf("failed to read ROM\n");
+    return false;
+  }
+
+  return load(c, rom);
+}
+
+
+// loads the ROM out of a gzip or zip archive, inflating it on the fly (no temp files)
+static bool loadFromArchive (void* v_cartridge, const char* path)
+{
+  cartridge_t* c = v_cartridge;
+  stream_t* rom = stream.openArchive(path);
+  if (rom == NULL)
+  {
+    printf("failed to read ROM archive\n");
+    return false;
+  }
+
+  return load(c, rom);
+}
+
+
+// loads the ROM (or the gzip or zip archive holding the ROM) from a buffer
+static bool loadFromMemory (void* v_cartridge, const byte_t* bytes, size_t const size)
+{
+  cartridge_t* c = v_cartridge;
+  stream_t* rom = stream.openMemory(bytes, size);
+  if (rom == NULL)
+  {
+    printf("failed to read ROM\n");
+    return false;
+  }
+
+  return load(c, rom);
+}
+
+
+static void unmap (data_t* d)
+{
+  munmap(d -> m_image, d -> m_size_image);
+  d -> m_image = NULL;
+  d -> m_size_image = 0;
+  d -> header = NULL;
+  d -> m_PRG_ROM = NULL;
+  d -> m_CHR_ROM = NULL;
+  d -> num_banks = 0;
+  d -> num_vbanks = 0;
+}
+
+
+// maps the ROM read-only so that the PRG-ROM and CHR-ROM point into the page cache
+static bool mapFromFile (void* v_cartridge, const char* path)
+{
+  cartridge_t* c = v_cartridge;
+  data_t* d = c -> data;
+  if (d -> header != NULL)
+  {
+    printf("cartridge already holds a ROM\n");
+    return false;
+  }
+
+  int const fd = open(path, O_RDONLY);
+  if (fd == -1)
+  {
+    printf("failed to read ROM\n");
+    return false;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) == -1 || st.st_size < 0x10)
+  {
+    printf("Invalid NES ROM\n");
+    close(fd);
+    return false;
+  }
+
+  size_t const size = st.st_size;
+  void* image = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (image == MAP_FAILED)
+  {
+    printf("failed to map ROM into memory!\n");
+    return false;
+  }
+
+  d -> m_image = (byte_t*) image;
+  d -> m_size_image = size;
+
+  byte_t* header = d -> m_image;
+  d -> header = header;
+  printf("header: %c %c %c 0x%x\n", header[0], header[1], header[2], header[3]);
+
+  if (ines.hasTrainer(header))	// ref[2]
+  {
+    printf("Unsupported Trainer!\n");
+    unmap(d);
+    return false;
+  }
+
+  size_t const num_banks = ines.getSizeROM(header);
+  size_t const num_vbanks = ines.getSizeVROM(header);
+  printf("16KB PRG-ROM Banks: %zu \n", num_banks / 0x4000);
+  printf("8KB CHR-ROM Banks: %zu \n", num_vbanks / 0x2000);
+  if (!num_banks)
+  {
+    printf("ROM does not have PRG-ROM Banks! Failed to load ROM\n");
+    unmap(d);
+    return false;
+  }
+
+  bool const isTruncated = (num_banks > size - 0x10 ||
+			    num_vbanks > size - 0x10 - num_banks);
+  if (isTruncated)
+  {
+    printf("Failed to read PRG-ROM or CHR-ROM!\n");
+    unmap(d);
+    return false;
+  }
+
+  d -> num_banks = num_banks;
+  d -> num_vbanks = num_vbanks;
+  d -> m_PRG_ROM = (d -> m_image + 0x10);
+  d -> m_CHR_ROM = (num_vbanks)? (d -> m_image + 0x10 + num_banks) : NULL;
+
+  setTableMirroring(c);
+  setMapperNumber(c);
+  setRAMSizes(c);
+  setExtendedRAM(c);
+  info_colorSystem(c);
+  return true;
 }
 
 
@@ -355,7 +612,7 @@ static size_t getSizeROM (const void* v_cartridge)
 {
   const cartridge_t* c = v_cartridge;
   const data_t* data = c -> data;
-  size_t size = data -> num_banks;
+  size_t size = (data != NULL)? data -> num_banks : 0;
   return size;
 }
 
@@ -364,7 +621,7 @@ static size_t getSizeVROM (const void* v_cartridge)
 {
   const cartridge_t* c = v_cartridge;
   const data_t* data = c -> data;
-  size_t size = data -> num_vbanks;
+  size_t size = (data != NULL)? data -> num_vbanks : 0;
   return size;
 }
 
@@ -373,7 +630,7 @@ static byte_t* getROM (const void* v_cartridge)
 {
   const cartridge_t* c = v_cartridge;
   const data_t* data = c -> data;
-  byte_t* m_PRG_ROM = data -> m_PRG_ROM;
+  byte_t* m_PRG_ROM = (data != NULL)? data -> m_PRG_ROM : NULL;	// (NULL if the load failed)
   return m_PRG_ROM;
 }
 
@@ -382,11 +639,104 @@ static byte_t* getVROM (const void* v_cartridge)
 {
   const cartridge_t* c = v_cartridge;
   const data_t* data = c -> data;
-  byte_t* m_CHR_ROM = data -> m_CHR_ROM;
+  byte_t* m_CHR_ROM = (data != NULL)? data -> m_CHR_ROM : NULL;	// (NULL if the load failed)
   return m_CHR_ROM;
 }
 
 
+// fingerprints the mapped ROM on demand so that mapping stays (nearly) free
+static void fingerprintImage (data_t* d)
+{
+  fingerprint_t fp;
+  fingerprint.init(&fp);
+  if (d -> m_PRG_ROM != NULL)
+  {
+    fingerprint.update(&fp, d -> m_PRG_ROM, d -> num_banks);
+  }
+  d -> m_crc32_PRG = fingerprint.section(&fp);
+
+  if (d -> m_CHR_ROM != NULL)
+  {
+    fingerprint.update(&fp, d -> m_CHR_ROM, d -> num_vbanks);
+  }
+  d -> m_crc32_CHR = fingerprint.section(&fp);
+
+  fingerprint.final(&fp, &d -> m_crc32, d -> m_sha1);
+  d -> m_fingerprinted = true;
+}
+
+
+static uint32_t getCRC32 (const void* v_cartridge)
+{
+  const cartridge_t* c = v_cartridge;
+  data_t* data = c -> data;
+  if (!data -> m_fingerprinted)
+  {
+    fingerprintImage(data);
+  }
+  uint32_t const crc = data -> m_crc32;
+  return crc;
+}
+
+
+static const byte_t* getSHA1 (const void* v_cartridge)
+{
+  const cartridge_t* c = v_cartridge;
+  data_t* data = c -> data;
+  if (!data -> m_fingerprinted)
+  {
+    fingerprintImage(data);
+  }
+  const byte_t* digest = data -> m_sha1;
+  return digest;
+}
+
+
+static size_t getSizePRGRAM (const void* v_cartridge)
+{
+  const cartridge_t* c = v_cartridge;
+  const data_t* data = c -> data;
+  size_t size = data -> m_size_PRGRAM;
+  return size;
+}
+
+
+static size_t getSizeCHRRAM (const void* v_cartridge)
+{
+  const cartridge_t* c = v_cartridge;
+  const data_t* data = c -> data;
+  size_t size = data -> m_size_CHRRAM;
+  return size;
+}
+
+
+static uint16_t getMapperNumber (const void* v_cartridge)
+{
+  const cartridge_t* c = v_cartridge;
+  const data_t* data = c -> data;
+  uint16_t num = data -> m_mapperNumber;
+  return num;
+}
+
+
+static byte_t getSubmapperNumber (const void* v_cartridge)
+{
+  const cartridge_t* c = v_cartridge;
+  const data_t* data = c -> data;
+  byte_t num = data -> m_submapperNumber;
+  return num;
+}
+
+
+static byte_t getTimingMode (const void* v_cartridge)
+{
+  const cartridge_t* c = v_cartridge;
+  const data_t* data = c -> data;
+  byte_t timing = data -> m_tvSystem;
+  return timing;
+}
+
+
 static byte_t getNameTableMirroring (const void* v_cartridge)
 {
   const cartridge_t* c = v_cartridge;
@@ -426,19 +776,39 @@ static cartridge_t* create ()
   d -> header = NULL;
   d -> m_PRG_ROM = NULL;
   d -> m_CHR_ROM = NULL;
+  d -> m_image = NULL;
+  d -> m_PRG_image = NULL;
+  d -> m_CHR_image = NULL;
+  d -> m_size_image = 0;
+  d -> m_crc32_PRG = 0;
+  d -> m_crc32_CHR = 0;
+  d -> m_crc32 = 0;
+  d -> m_fingerprinted = false;
   d -> num_banks = 0;
   d -> num_vbanks = 0;
-  d -> banks = 0;
-  d -> vbanks = 0;
-  d -> m_nameTableMirroring = 0;
+  d -> m_size_PRGRAM = 0;
+  d -> m_size_CHRRAM = 0;
   d -> m_mapperNumber = 0;
+  d -> m_submapperNumber = 0;
+  d -> m_nameTableMirroring = 0;
+  d -> m_tvSystem = 0;
   d -> m_extendedRAM = false;
 
   c -> loadFromFile = loadFromFile;
+  c -> loadFromArchive = loadFromArchive;
+  c -> loadFromMemory = loadFromMemory;
+  c -> mapFromFile = mapFromFile;
   c -> getROM = getROM;
   c -> getVROM = getVROM;
   c -> getSizeROM = getSizeROM;
   c -> getSizeVROM = getSizeVROM;
+  c -> getSizePRGRAM = getSizePRGRAM;
+  c -> getSizeCHRRAM = getSizeCHRRAM;
+  c -> getMapperNumber = getMapperNumber;
+  c -> getSubmapperNumber = getSubmapperNumber;
+  c -> getTimingMode = getTimingMode;
+  c -> getCRC32 = getCRC32;
+  c -> getSHA1 = getSHA1;
   c -> getNameTableMirroring = getNameTableMirroring;
   c -> hasExtendedRAM = hasExtendedRAM;
 
@@ -461,12 +831,29 @@ static cartridge_t* destroy (cartridge_t* c)
   }
 
   data_t* d = c -> data;
+  if (d -> m_image != NULL)
+  {
+    unmap(d);
+  }
+
   if (d -> header != NULL)
   {
     free(d -> header);
     d -> header= NULL;
   }
 
+  if (d -> m_PRG_image != NULL)
+  {
+    d -> m_PRG_image = romstore.release(d -> m_PRG_image);
+    d -> m_PRG_ROM = NULL;
+  }
+
+  if (d -> m_CHR_image != NULL)
+  {
+    d -> m_CHR_image = romstore.release(d -> m_CHR_image);
+    d -> m_CHR_ROM = NULL;
+  }
+
   if (d -> m_PRG_ROM != NULL)
   {
     free(d -> m_PRG_ROM);
@@ -518,6 +905,8 @@ cartridge_namespace_t const cartridge = {
 // [3] https://www.nesdev.org/wiki/INES#Flags_7
 // [4] https://www.nesdev.org/wiki/INES#Flags_9
 // [5] https://www.nesdev.org/wiki/INES#Flags_10
+// [6] https://www.nesdev.org/wiki/NES_2.0
+// [7] https://www.rfc-editor.org/rfc/rfc1952 (gzip trailer)
 
 
 // TODO:
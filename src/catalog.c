@@ -0,0 +1,650 @@
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "catalog.h"
+#include "ines.h"
+#include "fingerprint.h"
+
+
+#define NES_FAILURE_STATE ( (int) 0xffffffff )
+#define NES_SUCCESS_STATE ( (int) 0x00000000 )
+#define NES_CATALOG_VERSION ( (uint32_t) 3 )
+
+
+// binary index layout: header, records (sorted by path), and the paths (NUL separated)
+typedef struct
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t count;
+  uint64_t size_strings;
+} indexHeader_t;
+
+
+typedef struct
+{
+  uint64_t mtime;
+  uint64_t size_file;
+  uint32_t crc32;
+  uint32_t size_ROM;
+  uint32_t size_VROM;
+  uint32_t path;					// offset into the paths
+  byte_t sha1[20];
+  uint16_t mapperNumber;
+  byte_t submapperNumber;
+  byte_t nameTableMirroring;
+  byte_t tvSystem;
+  byte_t flags;						// bit 0: valid, bit 1: extended RAM
+} indexRecord_t;
+
+
+// list of the ROM paths found while walking the library
+typedef struct
+{
+  char** paths;
+  size_t count;
+  size_t capacity;
+} list_t;
+
+
+// work shared by the scanner threads
+typedef struct
+{
+  const list_t* list;
+  const catalog_t* prev;
+  catalogEntry_t* entries;
+  atomic_size_t next;
+} job_t;
+
+
+static const char magic[8] = {'N', 'E', 'S', 'I', 'N', 'D', 'E', 'X'};
+
+
+extern ines_namespace_t const ines;
+extern fingerprint_namespace_t const fingerprint;
+
+
+static bool isROM (const char* name)
+{
+  size_t const len = strlen(name);
+  if (len < 4)
+  {
+    return false;
+  }
+
+  const char* ext = (name + len - 4);
+  return (strcasecmp(ext, ".nes") == 0);
+}
+
+
+static int append (list_t* list, const char* path)
+{
+  if (list -> count == list -> capacity)
+  {
+    size_t const capacity = (list -> capacity)? (2 * list -> capacity) : 1024;
+    char** paths = realloc(list -> paths, capacity * sizeof(char*));
+    if (paths == NULL)
+    {
+      printf("Catalog::scan() failed to allocate the list of ROMs!\n");
+      return NES_FAILURE_STATE;
+    }
+    list -> paths = paths;
+    list -> capacity = capacity;
+  }
+
+  char* p = strdup(path);
+  if (p == NULL)
+  {
+    printf("Catalog::scan() failed to allocate the list of ROMs!\n");
+    return NES_FAILURE_STATE;
+  }
+
+  list -> paths[list -> count] = p;
+  ++list -> count;
+  return NES_SUCCESS_STATE;
+}
+
+
+// walks the library (recursively) collecting the paths of the ROMs
+static int walk (list_t* list, const char* dir)
+{
+  DIR* d = opendir(dir);
+  if (d == NULL)
+  {
+    printf("Catalog::scan() failed to open directory %s\n", dir);
+    return NES_FAILURE_STATE;
+  }
+
+  int stat = NES_SUCCESS_STATE;
+  struct dirent* ent;
+  while ( (ent = readdir(d)) != NULL )
+  {
+    const char* name = ent -> d_name;
+    if (strcmp(name, ".") == 0 || strcmp(name, "..") == 0)
+    {
+      continue;
+    }
+
+    size_t const len = strlen(dir) + strlen(name) + 2;
+    char path[len];
+    snprintf(path, len, "%s/%s", dir, name);
+
+    unsigned char type = ent -> d_type;
+    if (type == DT_UNKNOWN)
+    {
+      struct stat st;
+      if (lstat(path, &st) == -1)
+      {
+	continue;
+      }
+      type = (S_ISDIR(st.st_mode))? DT_DIR : (S_ISREG(st.st_mode))? DT_REG : DT_UNKNOWN;
+    }
+
+    if (type == DT_DIR)
+    {
+      stat = walk(list, path);
+    }
+    else if (type == DT_REG && isROM(name))
+    {
+      stat = append(list, path);
+    }
+
+    if (stat == NES_FAILURE_STATE)
+    {
+      break;
+    }
+  }
+
+  closedir(d);
+  return stat;
+}
+
+
+static int compare (const void* va, const void* vb)
+{
+  const char* const* a = va;
+  const char* const* b = vb;
+  return strcmp(*a, *b);
+}
+
+
+static int compareEntry (const void* vkey, const void* ventry)
+{
+  const char* key = vkey;
+  const catalogEntry_t* entry = ventry;
+  return strcmp(key, entry -> path);
+}
+
+
+static const catalogEntry_t* find (const catalog_t* catalog, const char* path)
+{
+  if (catalog == NULL || catalog -> count == 0)
+  {
+    return NULL;
+  }
+
+  const catalogEntry_t* entry = bsearch(path,
+					catalog -> entries,
+					catalog -> count,
+					sizeof(catalogEntry_t),
+					compareEntry);
+  return entry;
+}
+
+
+// fills the entry from the ROM header and contents (the ROM is mapped, not copied)
+static void indexFile (const char* path, catalogEntry_t* entry)
+{
+  entry -> valid = false;
+
+  int const fd = open(path, O_RDONLY);
+  if (fd == -1)
+  {
+    return;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) == -1)
+  {
+    close(fd);
+    return;
+  }
+
+  entry -> mtime = st.st_mtime;
+  entry -> size_file = st.st_size;
+
+  size_t const size = st.st_size;
+  if (size < 0x10)
+  {
+    close(fd);
+    return;
+  }
+
+  void* image = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (image == MAP_FAILED)
+  {
+    return;
+  }
+
+  const byte_t* header = image;
+  size_t const offset = 0x10 + (ines.hasTrainer(header)? 0x200 : 0);
+  size_t const size_ROM = ines.getSizeROM(header);
+  size_t const size_VROM = ines.getSizeVROM(header);
+  bool const isValid = (ines.isValid(header) &&
+			size_ROM != 0 &&
+			size >= offset &&
+			size_ROM <= size - offset &&
+			size_VROM <= size - offset - size_ROM);
+  if (isValid)
+  {
+    const byte_t* PRG = (header + offset);
+    const byte_t* CHR = (PRG + size_ROM);
+    fingerprint_t fp;
+    fingerprint.init(&fp);
+    fingerprint.update(&fp, PRG, size_ROM);
+    fingerprint.update(&fp, CHR, size_VROM);
+    fingerprint.final(&fp, &entry -> crc32, entry -> sha1);
+    entry -> size_ROM = size_ROM;
+    entry -> size_VROM = size_VROM;
+    entry -> mapperNumber = ines.getMapperNumber(header);
+    entry -> submapperNumber = ines.getSubmapperNumber(header);
+    entry -> nameTableMirroring = ines.getNameTableMirroring(header);
+    entry -> tvSystem = ines.getTVSystem(header);
+    entry -> extendedRAM = ines.hasExtendedRAM(header);
+    entry -> valid = true;
+  }
+
+  munmap(image, size);
+}
+
+
+// reuses the entry of the previous catalog if the file has not changed since
+static bool reuse (const catalog_t* prev, const char* path, catalogEntry_t* entry)
+{
+  const catalogEntry_t* old = find(prev, path);
+  if (old == NULL)
+  {
+    return false;
+  }
+
+  struct stat st;
+  if (stat(path, &st) == -1)
+  {
+    return false;
+  }
+
+  bool const isSame = ( (uint64_t) st.st_mtime == old -> mtime &&
+			(uint64_t) st.st_size == old -> size_file );
+  if (isSame)
+  {
+    *entry = *old;
+  }
+
+  return isSame;
+}
+
+
+static void* work (void* vjob)
+{
+  job_t* job = vjob;
+  const list_t* list = job -> list;
+  size_t i;
+  while ( (i = atomic_fetch_add(&job -> next, 1)) < list -> count )
+  {
+    const char* path = list -> paths[i];
+    catalogEntry_t* entry = &job -> entries[i];
+    if (!reuse(job -> prev, path, entry))
+    {
+      indexFile(path, entry);
+    }
+  }
+  return NULL;
+}
+
+
+static void clear (list_t* list)
+{
+  for (size_t i = 0; i != list -> count; ++i)
+  {
+    free(list -> paths[i]);
+    list -> paths[i] = NULL;
+  }
+  free(list -> paths);
+  list -> paths = NULL;
+  list -> count = 0;
+  list -> capacity = 0;
+}
+
+
+// packs the paths into the catalog strings so that entries point into them
+static int pack (catalog_t* catalog, const list_t* list)
+{
+  size_t size = 0;
+  for (size_t i = 0; i != list -> count; ++i)
+  {
+    size += strlen(list -> paths[i]) + 1;
+  }
+
+  catalog -> strings = malloc( (size)? size : 1 );
+  if (catalog -> strings == NULL)
+  {
+    printf("Catalog::scan() failed to allocate the paths!\n");
+    return NES_FAILURE_STATE;
+  }
+
+  char* p = catalog -> strings;
+  for (size_t i = 0; i != list -> count; ++i)
+  {
+    size_t const len = strlen(list -> paths[i]) + 1;
+    memcpy(p, list -> paths[i], len);
+    catalog -> entries[i].path = p;
+    p += len;
+  }
+
+  return NES_SUCCESS_STATE;
+}
+
+
+static catalog_t* destroy (catalog_t* catalog)
+{
+  if (catalog == NULL)
+  {
+    return catalog;
+  }
+
+  free(catalog -> entries);
+  catalog -> entries = NULL;
+  free(catalog -> strings);
+  catalog -> strings = NULL;
+
+  free(catalog);
+  catalog = NULL;
+  return catalog;
+}
+
+
+static catalog_t* alloc (size_t const count)
+{
+  catalog_t* catalog = malloc( sizeof(catalog_t) );
+  if (catalog == NULL)
+  {
+    printf("Catalog::Catalog() failed to allocate catalog!\n");
+    return catalog;
+  }
+
+  catalog -> count = count;
+  catalog -> strings = NULL;
+  catalog -> entries = calloc( (count)? count : 1, sizeof(catalogEntry_t) );
+  if (catalog -> entries == NULL)
+  {
+    free(catalog);
+    catalog = NULL;
+    printf("Catalog::Catalog() failed to allocate the entries!\n");
+    return catalog;
+  }
+
+  return catalog;
+}
+
+
+// indexes the ROM library at dir on a pool of threads (zero selects one per core),
+// entries of the previous catalog (if any) are reused for the files that are unchanged
+static catalog_t* scan (const char* dir, const catalog_t* prev, size_t num_threads)
+{
+  list_t list = { .paths = NULL, .count = 0, .capacity = 0 };
+  if (walk(&list, dir) == NES_FAILURE_STATE)
+  {
+    clear(&list);
+    return NULL;
+  }
+
+  qsort(list.paths, list.count, sizeof(char*), compare);
+
+  catalog_t* catalog = alloc(list.count);
+  if (catalog == NULL)
+  {
+    clear(&list);
+    return catalog;
+  }
+
+  if (num_threads == 0)
+  {
+    long const cores = sysconf(_SC_NPROCESSORS_ONLN);
+    num_threads = (cores > 0)? cores : 1;
+  }
+
+  if (num_threads > list.count)
+  {
+    num_threads = (list.count)? list.count : 1;
+  }
+
+  job_t job = { .list = &list, .prev = prev, .entries = catalog -> entries };
+  atomic_init(&job.next, 0);
+
+  pthread_t threads[num_threads];
+  size_t num_spawned = 0;
+  for (size_t i = 1; i < num_threads; ++i)
+  {
+    if (pthread_create(&threads[i], NULL, work, &job) != 0)
+    {
+      break;
+    }
+    ++num_spawned;
+  }
+
+  work(&job);
+
+  for (size_t i = 1; i <= num_spawned; ++i)
+  {
+    pthread_join(threads[i], NULL);
+  }
+
+  int const stat = pack(catalog, &list);
+  clear(&list);
+  if (stat == NES_FAILURE_STATE)
+  {
+    catalog = destroy(catalog);
+    return catalog;
+  }
+
+  return catalog;
+}
+
+
+static int save (const catalog_t* catalog, const char* path)
+{
+  FILE* file = fopen(path, "wb");
+  if (file == NULL)
+  {
+    printf("Catalog::save() failed to open %s\n", path);
+    return NES_FAILURE_STATE;
+  }
+
+  size_t size_strings = 0;
+  for (size_t i = 0; i != catalog -> count; ++i)
+  {
+    size_strings += strlen(catalog -> entries[i].path) + 1;
+  }
+
+  indexHeader_t header = {
+    .version = NES_CATALOG_VERSION,
+    .count = catalog -> count,
+    .size_strings = size_strings
+  };
+  memcpy(header.magic, magic, sizeof(magic));
+
+  int stat = NES_SUCCESS_STATE;
+  if (fwrite(&header, sizeof(header), 1, file) != 1)
+  {
+    stat = NES_FAILURE_STATE;
+  }
+
+  uint32_t offset = 0;
+  for (size_t i = 0; i != catalog -> count && stat == NES_SUCCESS_STATE; ++i)
+  {
+    const catalogEntry_t* entry = &catalog -> entries[i];
+    indexRecord_t record = {
+      .mtime = entry -> mtime,
+      .size_file = entry -> size_file,
+      .crc32 = entry -> crc32,
+      .size_ROM = entry -> size_ROM,
+      .size_VROM = entry -> size_VROM,
+      .path = offset,
+      .mapperNumber = entry -> mapperNumber,
+      .submapperNumber = entry -> submapperNumber,
+      .nameTableMirroring = entry -> nameTableMirroring,
+      .tvSystem = entry -> tvSystem,
+      .flags = ( (entry -> valid)? 0x01 : 0x00 ) | ( (entry -> extendedRAM)? 0x02 : 0x00 )
+    };
+    memcpy(record.sha1, entry -> sha1, sizeof(record.sha1));
+    offset += strlen(entry -> path) + 1;
+
+    if (fwrite(&record, sizeof(record), 1, file) != 1)
+    {
+      stat = NES_FAILURE_STATE;
+    }
+  }
+
+  for (size_t i = 0; i != catalog -> count && stat == NES_SUCCESS_STATE; ++i)
+  {
+    const char* p = catalog -> entries[i].path;
+    size_t const len = strlen(p) + 1;
+    if (fwrite(p, sizeof(char), len, file) != len)
+    {
+      stat = NES_FAILURE_STATE;
+    }
+  }
+
+  if (fclose(file) != 0)
+  {
+    stat = NES_FAILURE_STATE;
+  }
+
+  if (stat == NES_FAILURE_STATE)
+  {
+    printf("Catalog::save() failed to write %s\n", path);
+  }
+
+  return stat;
+}
+
+
+// loads the catalog from the index so that the ROMs need not be reopened
+static catalog_t* load (const char* path)
+{
+  FILE* file = fopen(path, "rb");
+  if (file == NULL)
+  {
+    return NULL;
+  }
+
+  indexHeader_t header;
+  bool const isValid = (fread(&header, sizeof(header), 1, file) == 1 &&
+			memcmp(header.magic, magic, sizeof(magic)) == 0 &&
+			header.version == NES_CATALOG_VERSION);
+  if (!isValid)
+  {
+    printf("Catalog::load() invalid index %s\n", path);
+    fclose(file);
+    return NULL;
+  }
+
+  size_t const count = header.count;
+  size_t const size_strings = header.size_strings;
+  catalog_t* catalog = alloc(count);
+  indexRecord_t* records = malloc( (count)? (count * sizeof(indexRecord_t)) : 1 );
+  char* strings = malloc( (size_strings)? size_strings : 1 );
+  if (catalog == NULL || records == NULL || strings == NULL)
+  {
+    printf("Catalog::load() failed to allocate the index!\n");
+    catalog = destroy(catalog);
+    free(records);
+    free(strings);
+    fclose(file);
+    return catalog;
+  }
+
+  bool const isComplete = (fread(records, sizeof(indexRecord_t), count, file) == count &&
+			   fread(strings, sizeof(char), size_strings, file) == size_strings);
+  fclose(file);
+
+  // checks that the paths are in bounds and NUL terminated
+  bool isConsistent = isComplete && (size_strings == 0 || strings[size_strings - 1] == 0);
+  for (size_t i = 0; i != count && isConsistent; ++i)
+  {
+    isConsistent = (records[i].path < size_strings);
+  }
+
+  if (!isConsistent)
+  {
+    printf("Catalog::load() invalid index %s\n", path);
+    catalog = destroy(catalog);
+    free(records);
+    free(strings);
+    return catalog;
+  }
+
+  catalog -> strings = strings;
+  for (size_t i = 0; i != count; ++i)
+  {
+    const indexRecord_t* record = &records[i];
+    catalogEntry_t* entry = &catalog -> entries[i];
+    entry -> path = (strings + record -> path);
+    entry -> mtime = record -> mtime;
+    entry -> size_file = record -> size_file;
+    entry -> crc32 = record -> crc32;
+    memcpy(entry -> sha1, record -> sha1, sizeof(entry -> sha1));
+    entry -> size_ROM = record -> size_ROM;
+    entry -> size_VROM = record -> size_VROM;
+    entry -> mapperNumber = record -> mapperNumber;
+    entry -> submapperNumber = record -> submapperNumber;
+    entry -> nameTableMirroring = record -> nameTableMirroring;
+    entry -> tvSystem = record -> tvSystem;
+    entry -> valid = (record -> flags & 0x01)? true : false;
+    entry -> extendedRAM = (record -> flags & 0x02)? true : false;
+  }
+
+  free(records);
+  records = NULL;
+  return catalog;
+}
+
+
+catalog_namespace_t const catalog = {
+  .scan = scan,
+  .load = load,
+  .save = save,
+  .find = find,
+  .destroy = destroy
+};
+
+
+// NES Emulation					October 18, 2026
+//
+//			Academic Purpose
+//
+// source: catalog.c
+// author: @misael-diaz
+//
+// Synopsis:
+// Implements the methods of the catalog object.
+// Indexes a library of ROMs (header fields, CRC32 and SHA-1) on a pool of threads
+// and keeps the index in a compact binary file so that later startups read the index
+// instead of reopening every ROM.
+//
+// Copyright (c) 2023 Misael Diaz-Maldonado
+// This file is released under the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// References:
+// [0] https://github.com/amhndu/SimpleNES
+// [1] https://www.nesdev.org/wiki/INES
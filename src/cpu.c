@@ -75,6 +75,12 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include "cpu.h"
+#include "cpuCycle.h"
+#include "mapperData.h"
+
+extern blockCache_namespace_t const blockCache;
+extern recompiler_namespace_t const recompiler;
+extern cpuCycle_namespace_t const cpuCycle;
 
 static byte_t read (const void* vcpu, address_t const address)
 {
@@ -97,6 +103,8 @@ static void ConnectBus (cpu_t* cpu, const device_t* devCPU)
 {
   bus_t* bus = devCPU -> vbus;
   cpu -> bus = bus;
+  cpu -> ram = bus -> ram;
+  bus -> cache = cpu -> cache;
 }
 
 
@@ -283,6 +291,7 @@ static byte_t indirectXRegisterOffset (void* vcpu)
   address_t const addr = cpu -> read(cpu, pc);
   ++pc;
 
+  // the pointer is in the zero page (work RAM):
   address_t const lo = cpu -> read(cpu, (addr + x) & 0x00ff);
   address_t const hi = cpu -> read(cpu, (addr + x + 1) & 0x00ff);
 
@@ -303,6 +312,7 @@ static byte_t indirectYRegisterOffset (void* vcpu)
   address_t const addr = cpu -> read(cpu, pc);
   ++pc;
 
+  // the pointer is in the zero page (work RAM):
   address_t const lo = cpu -> read(cpu, addr & 0x00ff);
   address_t const hi = cpu -> read(cpu, (addr + 1) & 0x00ff);
 
@@ -338,7 +348,1042 @@ static byte_t relative (void* vcpu)
 }
 
 
-static cpu_t* create (const device_t* dev)
+
+// opcode table {operation, addressing mode, base cycles, page-cross penalty} ref[2]:
+static const instruction_t opcodes[256] = {
+  {BRK,IMP,7,0}, {ORA,IZX,6,0}, {JAM,IMP,2,0}, {SLO,IZX,8,0},	// 0x00
+  {NOP,ZP0,3,0}, {ORA,ZP0,3,0}, {ASL,ZP0,5,0}, {SLO,ZP0,5,0},
+  {PHP,IMP,3,0}, {ORA,IMM,2,0}, {ASL_A,ACC,2,0}, {ANC,IMM,2,0},
+  {NOP,ABS,4,0}, {ORA,ABS,4,0}, {ASL,ABS,6,0}, {SLO,ABS,6,0},
+  {BPL,REL,2,0}, {ORA,IZY,5,1}, {JAM,IMP,2,0}, {SLO,IZY,8,0},	// 0x10
+  {NOP,ZPX,4,0}, {ORA,ZPX,4,0}, {ASL,ZPX,6,0}, {SLO,ZPX,6,0},
+  {CLC,IMP,2,0}, {ORA,ABY,4,1}, {NOP,IMP,2,0}, {SLO,ABY,7,0},
+  {NOP,ABX,4,1}, {ORA,ABX,4,1}, {ASL,ABX,7,0}, {SLO,ABX,7,0},
+  {JSR,ABS,6,0}, {AND,IZX,6,0}, {JAM,IMP,2,0}, {RLA,IZX,8,0},	// 0x20
+  {BIT,ZP0,3,0}, {AND,ZP0,3,0}, {ROL,ZP0,5,0}, {RLA,ZP0,5,0},
+  {PLP,IMP,4,0}, {AND,IMM,2,0}, {ROL_A,ACC,2,0}, {ANC,IMM,2,0},
+  {BIT,ABS,4,0}, {AND,ABS,4,0}, {ROL,ABS,6,0}, {RLA,ABS,6,0},
+  {BMI,REL,2,0}, {AND,IZY,5,1}, {JAM,IMP,2,0}, {RLA,IZY,8,0},	// 0x30
+  {NOP,ZPX,4,0}, {AND,ZPX,4,0}, {ROL,ZPX,6,0}, {RLA,ZPX,6,0},
+  {SEC,IMP,2,0}, {AND,ABY,4,1}, {NOP,IMP,2,0}, {RLA,ABY,7,0},
+  {NOP,ABX,4,1}, {AND,ABX,4,1}, {ROL,ABX,7,0}, {RLA,ABX,7,0},
+  {RTI,IMP,6,0}, {EOR,IZX,6,0}, {JAM,IMP,2,0}, {SRE,IZX,8,0},	// 0x40
+  {NOP,ZP0,3,0}, {EOR,ZP0,3,0}, {LSR,ZP0,5,0}, {SRE,ZP0,5,0},
+  {PHA,IMP,3,0}, {EOR,IMM,2,0}, {LSR_A,ACC,2,0}, {ALR,IMM,2,0},
+  {JMP,ABS,3,0}, {EOR,ABS,4,0}, {LSR,ABS,6,0}, {SRE,ABS,6,0},
+  {BVC,REL,2,0}, {EOR,IZY,5,1}, {JAM,IMP,2,0}, {SRE,IZY,8,0},	// 0x50
+  {NOP,ZPX,4,0}, {EOR,ZPX,4,0}, {LSR,ZPX,6,0}, {SRE,ZPX,6,0},
+  {CLI,IMP,2,0}, {EOR,ABY,4,1}, {NOP,IMP,2,0}, {SRE,ABY,7,0},
+  {NOP,ABX,4,1}, {EOR,ABX,4,1}, {LSR,ABX,7,0}, {SRE,ABX,7,0},
+  {RTS,IMP,6,0}, {ADC,IZX,6,0}, {JAM,IMP,2,0}, {RRA,IZX,8,0},	// 0x60
+  {NOP,ZP0,3,0}, {ADC,ZP0,3,0}, {ROR,ZP0,5,0}, {RRA,ZP0,5,0},
+  {PLA,IMP,4,0}, {ADC,IMM,2,0}, {ROR_A,ACC,2,0}, {ARR,IMM,2,0},
+  {JMP,IND,5,0}, {ADC,ABS,4,0}, {ROR,ABS,6,0}, {RRA,ABS,6,0},
+  {BVS,REL,2,0}, {ADC,IZY,5,1}, {JAM,IMP,2,0}, {RRA,IZY,8,0},	// 0x70
+  {NOP,ZPX,4,0}, {ADC,ZPX,4,0}, {ROR,ZPX,6,0}, {RRA,ZPX,6,0},
+  {SEI,IMP,2,0}, {ADC,ABY,4,1}, {NOP,IMP,2,0}, {RRA,ABY,7,0},
+  {NOP,ABX,4,1}, {ADC,ABX,4,1}, {ROR,ABX,7,0}, {RRA,ABX,7,0},
+  {NOP,IMM,2,0}, {STA,IZX,6,0}, {NOP,IMM,2,0}, {SAX,IZX,6,0},	// 0x80
+  {STY,ZP0,3,0}, {STA,ZP0,3,0}, {STX,ZP0,3,0}, {SAX,ZP0,3,0},
+  {DEY,IMP,2,0}, {NOP,IMM,2,0}, {TXA,IMP,2,0}, {XAA,IMM,2,0},
+  {STY,ABS,4,0}, {STA,ABS,4,0}, {STX,ABS,4,0}, {SAX,ABS,4,0},
+  {BCC,REL,2,0}, {STA,IZY,6,0}, {JAM,IMP,2,0}, {SHA,IZY,6,0},	// 0x90
+  {STY,ZPX,4,0}, {STA,ZPX,4,0}, {STX,ZPY,4,0}, {SAX,ZPY,4,0},
+  {TYA,IMP,2,0}, {STA,ABY,5,0}, {TXS,IMP,2,0}, {TAS,ABY,5,0},
+  {SHY,ABX,5,0}, {STA,ABX,5,0}, {SHX,ABY,5,0}, {SHA,ABY,5,0},
+  {LDY,IMM,2,0}, {LDA,IZX,6,0}, {LDX,IMM,2,0}, {LAX,IZX,6,0},	// 0xA0
+  {LDY,ZP0,3,0}, {LDA,ZP0,3,0}, {LDX,ZP0,3,0}, {LAX,ZP0,3,0},
+  {TAY,IMP,2,0}, {LDA,IMM,2,0}, {TAX,IMP,2,0}, {LXA,IMM,2,0},
+  {LDY,ABS,4,0}, {LDA,ABS,4,0}, {LDX,ABS,4,0}, {LAX,ABS,4,0},
+  {BCS,REL,2,0}, {LDA,IZY,5,1}, {JAM,IMP,2,0}, {LAX,IZY,5,1},	// 0xB0
+  {LDY,ZPX,4,0}, {LDA,ZPX,4,0}, {LDX,ZPY,4,0}, {LAX,ZPY,4,0},
+  {CLV,IMP,2,0}, {LDA,ABY,4,1}, {TSX,IMP,2,0}, {LAS,ABY,4,1},
+  {LDY,ABX,4,1}, {LDA,ABX,4,1}, {LDX,ABY,4,1}, {LAX,ABY,4,1},
+  {CPY,IMM,2,0}, {CMP,IZX,6,0}, {NOP,IMM,2,0}, {DCP,IZX,8,0},	// 0xC0
+  {CPY,ZP0,3,0}, {CMP,ZP0,3,0}, {DEC,ZP0,5,0}, {DCP,ZP0,5,0},
+  {INY,IMP,2,0}, {CMP,IMM,2,0}, {DEX,IMP,2,0}, {AXS,IMM,2,0},
+  {CPY,ABS,4,0}, {CMP,ABS,4,0}, {DEC,ABS,6,0}, {DCP,ABS,6,0},
+  {BNE,REL,2,0}, {CMP,IZY,5,1}, {JAM,IMP,2,0}, {DCP,IZY,8,0},	// 0xD0
+  {NOP,ZPX,4,0}, {CMP,ZPX,4,0}, {DEC,ZPX,6,0}, {DCP,ZPX,6,0},
+  {CLD,IMP,2,0}, {CMP,ABY,4,1}, {NOP,IMP,2,0}, {DCP,ABY,7,0},
+  {NOP,ABX,4,1}, {CMP,ABX,4,1}, {DEC,ABX,7,0}, {DCP,ABX,7,0},
+  {CPX,IMM,2,0}, {SBC,IZX,6,0}, {NOP,IMM,2,0}, {ISC,IZX,8,0},	// 0xE0
+  {CPX,ZP0,3,0}, {SBC,ZP0,3,0}, {INC,ZP0,5,0}, {ISC,ZP0,5,0},
+  {INX,IMP,2,0}, {SBC,IMM,2,0}, {NOP,IMP,2,0}, {SBC,IMM,2,0},
+  {CPX,ABS,4,0}, {SBC,ABS,4,0}, {INC,ABS,6,0}, {ISC,ABS,6,0},
+  {BEQ,REL,2,0}, {SBC,IZY,5,1}, {JAM,IMP,2,0}, {ISC,IZY,8,0},	// 0xF0
+  {NOP,ZPX,4,0}, {SBC,ZPX,4,0}, {INC,ZPX,6,0}, {ISC,ZPX,6,0},
+  {SED,IMP,2,0}, {SBC,ABY,4,1}, {NOP,IMP,2,0}, {ISC,ABY,7,0},
+  {NOP,ABX,4,1}, {SBC,ABX,4,1}, {INC,ABX,7,0}, {ISC,ABX,7,0},
+};
+
+
+static const instruction_t* decode (const byte_t opcode)
+{
+  const instruction_t* instruction = &opcodes[opcode];
+  return instruction;
+}
+
+
+// bytes of the instructions (opcode and operand) by addressing mode:
+static const byte_t lengths[] = {
+  [IMP] = 1, [ACC] = 1, [IMM] = 2, [ZP0] = 2, [ZPX] = 2, [ZPY] = 2, [ABS] = 3,
+  [ABX] = 3, [ABY] = 3, [IND] = 3, [IZX] = 2, [IZY] = 2, [REL] = 2
+};
+
+
+// true for the operations that (may) transfer control, these end the blocks
+static bool isControlTransfer (const instruction_t* instruction)
+{
+  byte_t const op = instruction -> op;
+  return (instruction -> mode == REL || op == JMP || op == JSR || op == RTS ||
+	  op == RTI || op == BRK || op == JAM);
+}
+
+
+// fetches the byte from the page of the block (or from the bus if past it, or if no page)
+static byte_t fetch (const bus_t* bus, const byte_t* page, address_t const pc, size_t const i)
+{
+  size_t const offset = ( (pc & 0x1fff) + i );
+  if (page != NULL && offset < NES_BLOCK_PAGE_SIZE)
+  {
+    return page[offset];
+  }
+
+  address_t const address = (pc + i);
+  return bus -> peek(bus, address);
+}
+
+
+// true if reading the address has no side effects: RAM, PPUSTATUS (whose vblank flag
+// only changes at the scheduled events), and the cartridge (unless watched; the registers
+// claimed by a device may have side effects on reading)
+static bool isQuiet (const bus_t* bus, address_t const address)
+{
+  bool const isWatched = (bus -> watched[address >> 8] & WatchRead);
+  bool const isClaimed = (bus -> claims[address >> 8] != 0);
+  return !isWatched && !isClaimed &&
+    (address < 0x2000 || (address & 0xe007) == 0x2002 || address >= 0x6000);
+}
+
+
+// true if the block is a polling loop: it only reads (quiet addresses) into registers
+// idempotently and then branches (or jumps) back to its start, so that an iteration that
+// leaves the registers as they were would leave them so forever (until an event)
+static bool isIdleLoop (const bus_t* bus, const block_t* block, address_t const end)
+{
+  const blockOp_t* last = &block -> code[block -> count - 1];
+  bool const isLoop = (last -> mode == REL)?
+    ( (address_t) (end + (int8_t) last -> operand) == block -> pc ) :
+    (last -> opcode == 0x4c && last -> operand == block -> pc);	// (JMP absolute)
+  if (!isLoop)
+  {
+    return false;
+  }
+
+  for (const blockOp_t* op = block -> code; op != last; ++op)
+  {
+    switch (op -> op)
+    {
+      case LDA: case LDX: case LDY: case BIT: case AND: case ORA:
+      case CMP: case CPX: case CPY: case NOP:
+	break;
+      default:
+	return false;
+    }
+
+    bool const isStatic = (op -> mode == ZP0 || op -> mode == ABS);
+    bool const isOperand = (op -> mode == IMM || op -> mode == IMP);
+    if ( !isOperand && !(isStatic && isQuiet(bus, op -> operand)) )
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+
+// flags the RAM page holding code, at all its mirrors (written through any of them)
+static void flagCode (blockCache_t* cache, address_t const address)
+{
+  if (address >= 0x2000)
+  {
+    cache -> pages[address >> 8] |= CodePage;
+    return;
+  }
+
+  for (size_t mirror = 0; mirror != 0x2000; mirror += NES_CPU_WORK_RAM)
+  {
+    cache -> pages[( (address & (NES_CPU_WORK_RAM - 1)) + mirror ) >> 8] |= CodePage;
+  }
+}
+
+
+// decodes the straight run of code at PC (up to the first control transfer, the end of
+// its 8KB page, or NES_BLOCK_LENGTH instructions) into the block
+static void translate (const cpu_t* cpu,
+		       block_t* block,
+		       const byte_t* page,
+		       address_t const pc,
+		       uint32_t const epoch)
+{
+  const bus_t* bus = cpu -> bus;
+  blockCache_t* cache = cpu -> cache;
+  size_t offset = (pc & 0x1fff);
+  size_t count = 0;
+  size_t cycles = 0;
+  bool isCacheable = true;
+  bool isEnd = false;
+  bool isWatched = false;
+  // (the RAM code is read through the bus, which resolves the mirrors of the work RAM)
+  const byte_t* code = (epoch == 0)? page : NULL;
+  while (!isEnd && count != NES_BLOCK_LENGTH)
+  {
+    address_t const address = (pc + (offset - (pc & 0x1fff)));
+    // the code of the pages watched for execution is decoded afresh (never cached) an
+    // instruction at a time, so that the watchers are notified as it is about to execute:
+    if (bus -> watched[address >> 8] & WatchExecute)
+    {
+      if (count != 0)
+      {
+	break;
+      }
+
+      isCacheable = false;
+      isWatched = true;
+    }
+
+    byte_t const opcode = fetch(bus, code, address, 0);
+    if (isWatched)
+    {
+      bus -> notify(bus, address, opcode, WatchExecute);
+    }
+
+    const instruction_t* instruction = &opcodes[opcode];
+    size_t const length = lengths[instruction -> mode];
+    if (offset + length > NES_BLOCK_PAGE_SIZE)
+    {
+      if (count != 0)
+      {
+	break;
+      }
+
+      isCacheable = false;		// straddles two pages, decoded but never matched
+    }
+
+    address_t operand = 0x0000;
+    if (length >= 2)
+    {
+      operand = fetch(bus, code, address, 1);
+    }
+
+    if (length == 3)
+    {
+      operand |= (fetch(bus, code, address, 2) << 8);
+    }
+
+    blockOp_t* op = &block -> code[count];
+    op -> opcode = opcode;
+    op -> op = instruction -> op;
+    op -> mode = instruction -> mode;
+    op -> cycles = instruction -> cycles;
+    op -> penalty = instruction -> penalty;
+    op -> length = length;
+    op -> operand = operand;
+    cycles += instruction -> cycles;
+    offset += length;
+    ++count;
+    isEnd = (isWatched || isControlTransfer(instruction) || offset >= NES_BLOCK_PAGE_SIZE);
+  }
+
+  size_t rest = cycles;
+  for (size_t i = 0; i != count; ++i)
+  {
+    rest -= block -> code[i].cycles;
+    block -> code[i].rest = rest;
+  }
+
+  // the code read through the handlers of the I/O pages (which may change it without a
+  // write to the flagged pages) is decoded afresh each time:
+  address_t const end = (pc + (offset - (pc & 0x1fff)) - 1);
+  isCacheable = isCacheable &&
+    (epoch == 0 || (bus -> reads[pc >> 8] != NULL && bus -> reads[end >> 8] != NULL));
+  block -> page = (isCacheable)? page : NULL;
+  block -> epoch = epoch;
+  block -> pc = pc;
+  block -> count = count;
+  block -> cycles = cycles;
+  block -> native = NULL;
+  block -> heat = 0;
+  block -> idle = (!isWatched && isIdleLoop(bus, block, pc + (offset - (pc & 0x1fff))));
+
+  // flags the RAM pages holding the code (writes there invalidate the RAM blocks):
+  if (epoch != 0)
+  {
+    address_t const last = (pc + (offset - (pc & 0x1fff)) - 1);
+    flagCode(cache, pc);
+    flagCode(cache, last);			// (blocks span at most two pages)
+  }
+  else if (!cache -> banked)
+  {
+    for (size_t i = 0x80; i != 0x100; ++i)
+    {
+      cache -> pages[i] |= BankPage;
+    }
+    cache -> banked = true;
+  }
+}
+
+
+// returns the (decoded) block of code at PC, PRG-ROM code is keyed by its mapped page
+// and the rest by the entry of its 8KB page in the page table of the bus (never read)
+static block_t* lookup (const cpu_t* cpu, address_t const pc)
+{
+  const bus_t* bus = cpu -> bus;
+  const mapper_t* mapper = bus -> mapper;
+  blockCache_t* cache = cpu -> cache;
+  bool const isROM = (pc >= 0x8000 && mapper != NULL);
+  const mapperData_t* data = (isROM)? mapper -> data : NULL;
+  const byte_t* page = (isROM)?
+    data -> m_pagesPRG[(pc >> 13) & 3] : &bus -> handlers[(pc >> 8) & 0xe0];
+  uint32_t const epoch = (isROM)? 0 : cache -> epoch;
+  block_t* block = blockCache_slot(cache, page, pc);
+  if (!blockCache_hit(block, page, pc, epoch))
+  {
+    translate(cpu, block, page, pc, epoch);
+  }
+
+  return block;
+}
+
+
+// reads the work RAM straight, the rest (I/O and cartridge) through the bus; the work RAM
+// past the straight address (the first page watched, if any) is read through the bus too
+static inline byte_t load (const bus_t* bus,
+			   const byte_t* ram,
+			   address_t const straight,
+			   address_t const address)
+{
+  return (address < straight)? ram[address] : bus -> read(bus, address);
+}
+
+
+// writes to the work RAM straight (the zero page and the stack), returns true if the
+// write overwrote decoded code (which is discarded)
+static inline bool poke (byte_t* ram, blockCache_t* cache, address_t const address, byte_t const value)
+{
+  ram[address] = value;
+  if (cache -> pages[address >> 8] & CodePage)
+  {
+    blockCache.invalidate(cache);
+    return true;
+  }
+
+  return false;
+}
+
+
+// writes to the bus, returns true if the write may have changed the code being executed
+// (RAM code was overwritten, or a mapper register was written, possibly switching banks)
+static inline bool store (bus_t* bus,
+			  byte_t* ram,
+			  blockCache_t* cache,
+			  address_t const straight,
+			  address_t const address,
+			  byte_t const value)
+{
+  if (address < straight)
+  {
+    return poke(ram, cache, address, value);
+  }
+
+  byte_t const flags = cache -> pages[address >> 8];
+  bus -> write(bus, address, value);		// (the bus invalidates the RAM code)
+  return (flags != 0);
+}
+
+
+// true if the bus halted the CPU (a write started the OAM DMA), the run stops there so that
+// the console charges the stall of the DMA
+static bool halts (void* vcpu)
+{
+  cpu_t* cpu = vcpu;
+  bus_t* bus = cpu -> bus;
+  if (!bus -> halt)
+  {
+    return false;
+  }
+
+  bus -> halt = false;
+  ++cpu -> dmas;
+  return true;
+}
+
+
+// computed goto (labels as values) on GCC and clang, a switch elsewhere (or if asked)
+#if defined(__GNUC__) && !defined(NES_CPU_SWITCH_DISPATCH)
+#define NES_CPU_COMPUTED_GOTO 1
+#define NES_CPU_LABEL(op) [op] = &&op_##op,
+#define DISPATCH(op) goto *dispatch[op];
+#define OP(op) op_##op:
+#else
+#define NES_CPU_COMPUTED_GOTO 0
+#define DISPATCH(op) switch (op)
+#define OP(op) case op:
+#endif
+
+#define NEXT goto next
+
+#define READ(address) load(bus, ram, straight, (address))
+#define WRITE(address, value) ( leave |= store(bus, ram, cache, straight, (address), (value)) )
+#define PUSH(value) WRITE(0x0100 | sp--, (value))
+#define PULL() READ(0x0100 | ++sp)
+// the N and Z flags are lazy, kept as the bytes they are tested on (Z is set if z is zero)
+// and folded into the status register only when it is read as a whole:
+#define SET_NZ(value) ( n = z = (value) )
+#define STATUS() ( (p & ~(NegativeFlag | ZeroFlag)) | (n & NegativeFlag) |	\
+		   ( (z == 0)? ZeroFlag : 0 ) )
+#define SET_STATUS(value) ( p = (value), n = p, z = (p & ZeroFlag) ^ ZeroFlag )
+#define SET_FLAG(flag, cond) ( p = ( (cond)? (p | (flag)) : (p & ~(flag)) ) )
+#define BRANCH(cond)							\
+  if (cond)								\
+  {									\
+    cycles += 1 + ( ( (addr ^ pc) & 0xff00 )? 1 : 0 );		\
+    pc = addr;								\
+  }
+
+
+// adds with carry, sets the C and V flags (the caller sets the lazy N and Z flags)
+static byte_t adc (byte_t* p, byte_t const a, byte_t const value)
+{
+  uint16_t const sum = (a + value + (*p & CarryFlag));
+  byte_t const res = (byte_t) sum;
+  byte_t flags = *p & ~(CarryFlag | OverflowFlag);
+  flags |= (sum > 0xff)? CarryFlag : 0;
+  flags |= ( (~(a ^ value) & (a ^ res) & 0x80)? OverflowFlag : 0 );
+  *p = flags;
+  return res;
+}
+
+
+// compares, sets the C flag and returns the difference (that sets the lazy N and Z flags)
+static byte_t compare (byte_t* p, byte_t const reg, byte_t const value)
+{
+  *p = (*p & ~CarryFlag) | ( (reg >= value)? CarryFlag : 0 );
+  return (reg - value);
+}
+
+
+// executes instructions until the cycle budget is spent (at least one instruction, or
+// just the block at PC if asked once), returns the elapsed cycles. The instructions come
+// pre-decoded from the block cache. The decoding of the operand address (by addressing
+// mode) is separated from the execution of the operation (by the opcode table) ref[1].
+static size_t execute (cpu_t* cpu, size_t const budget, bool const once)
+{
+#if NES_CPU_COMPUTED_GOTO
+  static void* const dispatch[] = {
+    NES_CPU_OPERATIONS(NES_CPU_LABEL)
+  };
+#endif
+
+  bus_t* bus = cpu -> bus;
+  byte_t* ram = cpu -> ram;
+  blockCache_t* cache = cpu -> cache;
+  address_t const straight = bus -> straight;	// (the work RAM watched is past it)
+  address_t pc = cpu -> pc;
+  byte_t a = cpu -> a;
+  byte_t x = cpu -> x;
+  byte_t y = cpu -> y;
+  byte_t sp = cpu -> sp;
+  byte_t p = cpu -> status;
+  byte_t n = p;
+  byte_t z = (p & ZeroFlag) ^ ZeroFlag;
+  byte_t opcode = cpu -> opcode;
+  address_t addr = 0x0000;
+  size_t cycles = 0;
+  bool leave = false;
+  bool isHalted = false;
+  bool isRemapped = true;
+  const block_t* block = NULL;
+  const block_t* idle = NULL;		// idle loop (and its registers and cycles) last seen
+  uint32_t idleState = 0;
+  size_t idleCycles = 0;
+
+  do
+  {
+    // the successor in the same 8KB page needs no lookup of its page, unless the previous
+    // block was left because the code (or the mapping) may have changed:
+    if (isRemapped || block -> page == NULL || ( (pc ^ block -> pc) & 0xe000 ))
+    {
+      block = lookup(cpu, pc);
+      isRemapped = false;
+    }
+    else
+    {
+      block_t* successor = blockCache_slot(cache, block -> page, pc);
+      block = (blockCache_hit(successor, block -> page, pc, block -> epoch))?
+	successor : lookup(cpu, pc);
+    }
+
+    // charges the summed cycles up front if the whole block fits in the budget:
+    bool const fits = (cycles + block -> cycles <= budget);
+    cycles += (fits)? block -> cycles : 0;
+    const blockOp_t* end = (block -> code + block -> count);
+    for (const blockOp_t* instruction = block -> code; instruction != end; ++instruction)
+    {
+      opcode = instruction -> opcode;
+      pc += instruction -> length;
+      cycles += (fits)? 0 : instruction -> cycles;
+
+      // decodes the operand address:
+      address_t const operand = instruction -> operand;
+      switch (instruction -> mode)
+      {
+	case IMP:
+	case ACC:
+	  break;
+	case IMM:
+	  addr = (pc - 1);
+	  break;
+	case ZP0:
+	  addr = operand;
+	  break;
+	case ZPX:
+	  addr = ( (operand + x) & 0x00ff );
+	  break;
+	case ZPY:
+	  addr = ( (operand + y) & 0x00ff );
+	  break;
+	case ABS:
+	  addr = operand;
+	  break;
+	case ABX:
+	case ABY:
+	{
+	  addr = operand + ( (instruction -> mode == ABX)? x : y );
+	  cycles += ( ( (operand ^ addr) & 0xff00 )? instruction -> penalty : 0 );
+	  break;
+	}
+	case IND:				// caters hardware bug (no carry into the high byte)
+	{
+	  address_t const next = ( (operand & 0xff00) | ( (operand + 1) & 0x00ff ) );
+	  addr = ( (READ(next) << 8) | READ(operand) );
+	  break;
+	}
+	case IZX:
+	{
+	  address_t const ptr = ( (operand + x) & 0x00ff );
+	  addr = ( (READ( (ptr + 1) & 0x00ff ) << 8) | READ(ptr) );
+	  break;
+	}
+	case IZY:
+	{
+	  address_t const base = ( (READ( (operand + 1) & 0x00ff ) << 8) | READ(operand) );
+	  addr = base + y;
+	  cycles += ( ( (base ^ addr) & 0xff00 )? instruction -> penalty : 0 );
+	  break;
+	}
+	case REL:
+	  addr = (pc + (int8_t) operand);
+	  break;
+      }
+
+      // executes the operation:
+      DISPATCH(instruction -> op)
+      {
+	OP(ADC) a = adc(&p, a, READ(addr)); SET_NZ(a); NEXT;
+	OP(SBC) a = adc(&p, a, ~READ(addr)); SET_NZ(a); NEXT;
+	OP(AND) a &= READ(addr); SET_NZ(a); NEXT;
+	OP(ORA) a |= READ(addr); SET_NZ(a); NEXT;
+	OP(EOR) a ^= READ(addr); SET_NZ(a); NEXT;
+	OP(CMP) SET_NZ( compare(&p, a, READ(addr)) ); NEXT;
+	OP(CPX) SET_NZ( compare(&p, x, READ(addr)) ); NEXT;
+	OP(CPY) SET_NZ( compare(&p, y, READ(addr)) ); NEXT;
+	OP(BIT)
+	{
+	  byte_t const value = READ(addr);
+	  p = (p & ~OverflowFlag) | (value & OverflowFlag);
+	  n = value;
+	  z = (a & value);
+	  NEXT;
+	}
+	OP(LDA) a = READ(addr); SET_NZ(a); NEXT;
+	OP(LDX) x = READ(addr); SET_NZ(x); NEXT;
+	OP(LDY) y = READ(addr); SET_NZ(y); NEXT;
+	OP(STA) WRITE(addr, a); NEXT;
+	OP(STX) WRITE(addr, x); NEXT;
+	OP(STY) WRITE(addr, y); NEXT;
+	OP(TAX) x = a; SET_NZ(x); NEXT;
+	OP(TAY) y = a; SET_NZ(y); NEXT;
+	OP(TSX) x = sp; SET_NZ(x); NEXT;
+	OP(TXA) a = x; SET_NZ(a); NEXT;
+	OP(TXS) sp = x; NEXT;
+	OP(TYA) a = y; SET_NZ(a); NEXT;
+	OP(INX) ++x; SET_NZ(x); NEXT;
+	OP(INY) ++y; SET_NZ(y); NEXT;
+	OP(DEX) --x; SET_NZ(x); NEXT;
+	OP(DEY) --y; SET_NZ(y); NEXT;
+	OP(INC)
+	{
+	  byte_t const value = READ(addr) + 1;
+	  WRITE(addr, value);
+	  SET_NZ(value);
+	  NEXT;
+	}
+	OP(DEC)
+	{
+	  byte_t const value = READ(addr) - 1;
+	  WRITE(addr, value);
+	  SET_NZ(value);
+	  NEXT;
+	}
+	OP(ASL_A) SET_FLAG(CarryFlag, a & 0x80); a <<= 1; SET_NZ(a); NEXT;
+	OP(LSR_A) SET_FLAG(CarryFlag, a & 0x01); a >>= 1; SET_NZ(a); NEXT;
+	OP(ROL_A)
+	{
+	  byte_t const carry = (p & CarryFlag);
+	  SET_FLAG(CarryFlag, a & 0x80);
+	  a = (a << 1) | carry;
+	  SET_NZ(a);
+	  NEXT;
+	}
+	OP(ROR_A)
+	{
+	  byte_t const carry = (p & CarryFlag);
+	  SET_FLAG(CarryFlag, a & 0x01);
+	  a = (a >> 1) | (carry << 7);
+	  SET_NZ(a);
+	  NEXT;
+	}
+	OP(ASL)
+	{
+	  byte_t value = READ(addr);
+	  SET_FLAG(CarryFlag, value & 0x80);
+	  value <<= 1;
+	  WRITE(addr, value);
+	  SET_NZ(value);
+	  NEXT;
+	}
+	OP(LSR)
+	{
+	  byte_t value = READ(addr);
+	  SET_FLAG(CarryFlag, value & 0x01);
+	  value >>= 1;
+	  WRITE(addr, value);
+	  SET_NZ(value);
+	  NEXT;
+	}
+	OP(ROL)
+	{
+	  byte_t value = READ(addr);
+	  byte_t const carry = (p & CarryFlag);
+	  SET_FLAG(CarryFlag, value & 0x80);
+	  value = (value << 1) | carry;
+	  WRITE(addr, value);
+	  SET_NZ(value);
+	  NEXT;
+	}
+	OP(ROR)
+	{
+	  byte_t value = READ(addr);
+	  byte_t const carry = (p & CarryFlag);
+	  SET_FLAG(CarryFlag, value & 0x01);
+	  value = (value >> 1) | (carry << 7);
+	  WRITE(addr, value);
+	  SET_NZ(value);
+	  NEXT;
+	}
+	OP(BCC) BRANCH( !(p & CarryFlag) ); NEXT;
+	OP(BCS) BRANCH( (p & CarryFlag) ); NEXT;
+	OP(BNE) BRANCH( z != 0 ); NEXT;
+	OP(BEQ) BRANCH( z == 0 ); NEXT;
+	OP(BPL) BRANCH( !(n & NegativeFlag) ); NEXT;
+	OP(BMI) BRANCH( (n & NegativeFlag) ); NEXT;
+	OP(BVC) BRANCH( !(p & OverflowFlag) ); NEXT;
+	OP(BVS) BRANCH( (p & OverflowFlag) ); NEXT;
+	OP(CLC) p &= ~CarryFlag; NEXT;
+	OP(CLD) p &= ~DecimalFlag; NEXT;
+	OP(CLI) p &= ~InterruptDisableFlag; NEXT;
+	OP(CLV) p &= ~OverflowFlag; NEXT;
+	OP(SEC) p |= CarryFlag; NEXT;
+	OP(SED) p |= DecimalFlag; NEXT;
+	OP(SEI) p |= InterruptDisableFlag; NEXT;
+	OP(JMP) pc = addr; NEXT;
+	OP(JSR)
+	{
+	  address_t const ret = (pc - 1);
+	  PUSH(ret >> 8);
+	  PUSH(ret & 0x00ff);
+	  pc = addr;
+	  NEXT;
+	}
+	OP(RTS)
+	{
+	  address_t const lo = PULL();
+	  address_t const hi = PULL();
+	  pc = ( (hi << 8) | lo ) + 1;
+	  NEXT;
+	}
+	OP(BRK)
+	{
+	  ++pc;				// skips the padding byte
+	  PUSH(pc >> 8);
+	  PUSH(pc & 0x00ff);
+	  PUSH(STATUS() | BreakFlag | UnusedFlag);
+	  p |= InterruptDisableFlag;
+	  pc = ( (READ(0xffff) << 8) | READ(0xfffe) );
+	  NEXT;
+	}
+	OP(RTI)
+	{
+	  SET_STATUS( (PULL() & ~BreakFlag) | UnusedFlag );
+	  address_t const lo = PULL();
+	  address_t const hi = PULL();
+	  pc = ( (hi << 8) | lo );
+	  NEXT;
+	}
+	OP(PHA) PUSH(a); NEXT;
+	OP(PHP) PUSH(STATUS() | BreakFlag | UnusedFlag); NEXT;
+	OP(PLA) a = PULL(); SET_NZ(a); NEXT;
+	OP(PLP) SET_STATUS( (PULL() & ~BreakFlag) | UnusedFlag ); NEXT;
+	OP(NOP) NEXT;
+	// unofficial (stable) operations:
+	OP(LAX) a = x = READ(addr); SET_NZ(a); NEXT;
+	OP(SAX) WRITE(addr, a & x); NEXT;
+	OP(DCP)
+	{
+	  byte_t const value = READ(addr) - 1;
+	  WRITE(addr, value);
+	  SET_NZ( compare(&p, a, value) );
+	  NEXT;
+	}
+	OP(ISC)
+	{
+	  byte_t const value = READ(addr) + 1;
+	  WRITE(addr, value);
+	  a = adc(&p, a, ~value);
+	  SET_NZ(a);
+	  NEXT;
+	}
+	OP(SLO)
+	{
+	  byte_t value = READ(addr);
+	  SET_FLAG(CarryFlag, value & 0x80);
+	  value <<= 1;
+	  WRITE(addr, value);
+	  a |= value;
+	  SET_NZ(a);
+	  NEXT;
+	}
+	OP(RLA)
+	{
+	  byte_t value = READ(addr);
+	  byte_t const carry = (p & CarryFlag);
+	  SET_FLAG(CarryFlag, value & 0x80);
+	  value = (value << 1) | carry;
+	  WRITE(addr, value);
+	  a &= value;
+	  SET_NZ(a);
+	  NEXT;
+	}
+	OP(SRE)
+	{
+	  byte_t value = READ(addr);
+	  SET_FLAG(CarryFlag, value & 0x01);
+	  value >>= 1;
+	  WRITE(addr, value);
+	  a ^= value;
+	  SET_NZ(a);
+	  NEXT;
+	}
+	OP(RRA)
+	{
+	  byte_t value = READ(addr);
+	  byte_t const carry = (p & CarryFlag);
+	  SET_FLAG(CarryFlag, value & 0x01);
+	  value = (value >> 1) | (carry << 7);
+	  WRITE(addr, value);
+	  a = adc(&p, a, value);
+	  SET_NZ(a);
+	  NEXT;
+	}
+	OP(ANC) a &= READ(addr); SET_NZ(a); SET_FLAG(CarryFlag, a & 0x80); NEXT;
+	OP(ALR)
+	{
+	  a &= READ(addr);
+	  SET_FLAG(CarryFlag, a & 0x01);
+	  a >>= 1;
+	  SET_NZ(a);
+	  NEXT;
+	}
+	OP(ARR)
+	{
+	  a &= READ(addr);
+	  a = (a >> 1) | ( (p & CarryFlag) << 7 );
+	  SET_NZ(a);
+	  SET_FLAG(CarryFlag, a & 0x40);
+	  SET_FLAG(OverflowFlag, ( (a >> 6) ^ (a >> 5) ) & 0x01);
+	  NEXT;
+	}
+	OP(AXS)
+	{
+	  byte_t const value = READ(addr);
+	  byte_t const ax = (a & x);
+	  SET_FLAG(CarryFlag, ax >= value);
+	  x = (ax - value);
+	  SET_NZ(x);
+	  NEXT;
+	}
+	// unofficial (unstable) operations, the commonly emulated behavior:
+	OP(XAA) a = (a | 0xee) & x & READ(addr); SET_NZ(a); NEXT;
+	OP(LXA) a = x = (a | 0xee) & READ(addr); SET_NZ(a); NEXT;
+	OP(LAS) a = x = sp = (sp & READ(addr)); SET_NZ(a); NEXT;
+	OP(SHA) WRITE(addr, a & x & ( (addr >> 8) + 1 )); NEXT;
+	OP(SHX) WRITE(addr, x & ( (addr >> 8) + 1 )); NEXT;
+	OP(SHY) WRITE(addr, y & ( (addr >> 8) + 1 )); NEXT;
+	OP(TAS) sp = (a & x); WRITE(addr, sp & ( (addr >> 8) + 1 )); NEXT;
+	OP(JAM)				// halts (re-executes itself until the budget is spent)
+	{
+	  --pc;
+	  cycles += (cycles < budget)? ( (budget - cycles) / 2 ) * 2 : 0;
+	  NEXT;
+	}
+      }
+
+      next:
+      // leaves the block if the code may have changed (refunds the cycles not executed):
+      if (leave)
+      {
+	cycles -= (fits)? instruction -> rest : 0;
+	leave = false;
+	isRemapped = true;
+	isHalted = halts(cpu);
+	break;
+      }
+
+      if (!fits && cycles >= budget)
+      {
+	break;
+      }
+    }
+
+    // fast-forwards the idle loop once an iteration left the registers as they were, the
+    // iterations skipped are whole and the last one runs as usual (so the run ends alike):
+    if (block -> idle && fits && pc == block -> pc && cpu -> skipsIdle)
+    {
+      uint32_t const state = (a | (x << 8) | (y << 16) | ( (uint32_t) STATUS() << 24 ));
+      size_t const iteration = (cycles - idleCycles);
+      if (block == idle && state == idleState && cycles < budget && iteration != 0)
+      {
+	size_t const iterations = (budget - cycles) / iteration;
+	size_t const skipped = (iterations > 1)? (iterations - 1) * iteration : 0;
+	cpu -> skipped += skipped;
+	cycles += skipped;
+      }
+
+      idle = block;
+      idleState = state;
+      idleCycles = cycles;
+    }
+  } while (cycles < budget && !once && !isHalted);
+
+  cpu -> pc = pc;
+  cpu -> a = a;
+  cpu -> x = x;
+  cpu -> y = y;
+  cpu -> sp = sp;
+  cpu -> status = STATUS();
+  cpu -> opcode = opcode;
+  cpu -> abs = addr;
+  return cycles;
+}
+
+
+#undef NEXT
+#undef DISPATCH
+#undef OP
+
+
+// recompiles the hot block, starting over with an empty arena when it is full
+static native_t recompile (cpu_t* cpu, const block_t* block)
+{
+  recompiler_t* rec = cpu -> recompiler;
+  native_t native = recompiler.compile(rec, block);
+  if (native == NULL && recompiler.isFull(rec))
+  {
+    blockCache_t* cache = cpu -> cache;
+    for (size_t i = 0; i != NES_BLOCK_CACHE_SIZE; ++i)
+    {
+      cache -> blocks[i].native = NULL;
+      cache -> blocks[i].heat = 0;
+    }
+
+    recompiler.reset(rec);
+    native = recompiler.compile(rec, block);
+  }
+
+  return native;
+}
+
+
+// executes the hot blocks natively and the rest with the interpreter until the cycle
+// budget is spent, the cycles are counted at the exits of the blocks (so that the last
+// block may overshoot the budget)
+static size_t executeNative (cpu_t* cpu, size_t const budget)
+{
+  uint64_t const dmas = cpu -> dmas;
+  size_t cycles = 0;
+  do
+  {
+    block_t* block = lookup(cpu, cpu -> pc);
+    if (block -> idle && cpu -> skipsIdle)
+    {
+      // the interpreter fast-forwards the idle loops:
+      cycles += execute(cpu, budget - cycles, false);
+      continue;
+    }
+
+    if (block -> native == NULL && ++block -> heat == NES_RECOMPILER_THRESHOLD)
+    {
+      block -> native = (block -> page != NULL)? recompile(cpu, block) : NULL;
+    }
+
+    // the native code leaves without cycles if it cannot execute the first instruction:
+    size_t const elapsed = (block -> native != NULL)? block -> native(cpu) : 0;
+    cycles += (elapsed != 0)? elapsed : execute(cpu, budget - cycles, true);
+    halts(cpu);				// (the native code leaves on the write to OAMDMA)
+  } while (cycles < budget && cpu -> dmas == dmas);
+
+  return cycles;
+}
+
+
+static size_t step (void* vcpu)
+{
+  cpu_t* cpu = vcpu;
+  size_t const cycles = execute(cpu, 1, false);
+  cpu -> clock_count += cycles;
+  return cycles;
+}
+
+
+// executes whole instructions in a tight loop until the cycle budget is spent, returns
+// the consumed cycles (the last instruction may overshoot the budget by a few cycles)
+static size_t run (void* vcpu, size_t const budget)
+{
+  cpu_t* cpu = vcpu;
+  if (budget == 0)
+  {
+    return 0;
+  }
+
+  // (the interpreter executes while the bus is watched, the native code is not watched)
+  bool const isNative = (cpu -> recompiler != NULL && cpu -> bus -> countWatches == 0);
+  size_t const cycles = (isNative)? executeNative(cpu, budget) : execute(cpu, budget, false);
+  cpu -> clock_count += cycles;
+  return cycles;
+}
+
+
+// executes the instruction on its first cycle, then waits out its remaining cycles
+static void clock (void* vcpu)
+{
+  cpu_t* cpu = vcpu;
+  if (cpu -> cycles == 0)
+  {
+    cpu -> cycles = execute(cpu, 1, false);
+  }
+
+  --cpu -> cycles;
+  ++cpu -> clock_count;
+}
+
+
+// pushes the value onto the stack, out of a run of the CPU (the decoded code overwritten,
+// if any, is discarded by the time the CPU runs again)
+static void push (cpu_t* cpu, byte_t const value)
+{
+  bus_t* bus = cpu -> bus;
+  store(bus, cpu -> ram, cpu -> cache, bus -> straight, 0x0100 | cpu -> sp, value);
+  --cpu -> sp;
+}
+
+
+static void interrupt (cpu_t* cpu, address_t const vector, size_t const cycles)
+{
+  bus_t* bus = cpu -> bus;
+  const byte_t* ram = cpu -> ram;
+  address_t const straight = bus -> straight;
+  address_t const pc = cpu -> pc;
+  if (cpu -> engine == AccurateEngine)
+  {
+    // (the 2A03 reads the opcode at PC twice and discards it ref[3])
+    bus -> read(bus, pc);
+    bus -> read(bus, pc);
+  }
+
+  push(cpu, pc >> 8);
+  push(cpu, pc & 0x00ff);
+  push(cpu, (cpu -> status & ~BreakFlag) | UnusedFlag);
+  cpu -> status |= InterruptDisableFlag;
+  cpu -> pc = ( (READ(vector + 1) << 8) | READ(vector) );
+  cpu -> clock_count += cycles;
+}
+
+
+static void reset (void* vcpu)
+{
+  cpu_t* cpu = vcpu;
+  const bus_t* bus = cpu -> bus;
+  const byte_t* ram = cpu -> ram;
+  address_t const straight = bus -> straight;
+  cpu -> a = 0x00;
+  cpu -> x = 0x00;
+  cpu -> y = 0x00;
+  cpu -> sp = 0xfd;
+  cpu -> status = (UnusedFlag | InterruptDisableFlag);
+  cpu -> pc = ( (READ(0xfffd) << 8) | READ(0xfffc) );
+  cpu -> abs = 0x0000;
+  cpu -> rel = 0x0000;
+  cpu -> fetched = 0x00;
+  cpu -> cycles = 0;
+  cpu -> tick = 0;
+  cpu -> clock_count += 7;
+}
+
+
+static void irq (void* vcpu)
+{
+  cpu_t* cpu = vcpu;
+  if (cpu -> status & InterruptDisableFlag)
+  {
+    return;
+  }
+
+  interrupt(cpu, 0xfffe, 7);
+}
+
+
+static void nmi (void* vcpu)
+{
+  cpu_t* cpu = vcpu;
+  interrupt(cpu, 0xfffa, 7);
+}
+
+
+#undef READ
+#undef WRITE
+#undef PUSH
+#undef PULL
+#undef SET_NZ
+#undef STATUS
+#undef SET_STATUS
+#undef SET_FLAG
+#undef BRANCH
+
+
+static cpu_t* create (const device_t* dev, cpuEngine_t const engine)
 {
   cpu_t* cpu = malloc( sizeof(cpu_t) );
   if (cpu == NULL)
@@ -360,7 +1405,39 @@ static cpu_t* create (const device_t* dev)
   cpu -> x = 0x00;
   cpu -> y = 0x00;
 
+  cpu -> sp = 0xfd;
+  cpu -> status = (UnusedFlag | InterruptDisableFlag);
+
   cpu -> fetched = 0x00;
+  cpu -> opcode = 0x00;
+  cpu -> cycles = 0;
+  cpu -> tick = 0;
+  cpu -> clock_count = 0;
+  cpu -> dmas = 0;
+  cpu -> cache = blockCache.create();
+  if (cpu -> cache == NULL)
+  {
+    free(cpu);
+    cpu = NULL;
+    return cpu;
+  }
+
+  // (writing OAMDMA halts the CPU, the writes to the page leave the block)
+  cpu -> cache -> pages[0x40] |= HaltPage;
+
+  cpu -> skipped = 0;
+  cpu -> skipsIdle = true;
+  cpu -> engine = engine;
+  cpu -> recompiler = NULL;
+  if (engine == RecompilerEngine)
+  {
+    cpu -> recompiler = recompiler.create(NES_RECOMPILER_ARENA);
+    if (cpu -> recompiler == NULL)
+    {
+      printf("CPU::CPU() the recompiler is not available, interpreting instead\n");
+      cpu -> engine = InterpreterEngine;
+    }
+  }
 
   // addressing modes:
   cpu -> IMP = implied;
@@ -376,6 +1453,17 @@ static cpu_t* create (const device_t* dev)
   cpu -> INY = indirectYRegisterOffset;
   cpu -> REL = relative;
 
+  // interrupts:
+  cpu -> reset = reset;
+  cpu -> irq = irq;
+  cpu -> nmi = nmi;
+
+  // execution (the accurate engine executes cycle by cycle):
+  bool const isAccurate = (cpu -> engine == AccurateEngine);
+  cpu -> clock = (isAccurate)? cpuCycle.clock : clock;
+  cpu -> step = (isAccurate)? cpuCycle.step : step;
+  cpu -> run = (isAccurate)? cpuCycle.run : run;
+
   ConnectBus(cpu, dev);
 
   return cpu;
@@ -389,6 +1477,9 @@ static cpu_t* destroy (cpu_t* cpu)
     return cpu;
   }
 
+  cpu -> cache = blockCache.destroy(cpu -> cache);
+  cpu -> recompiler = recompiler.destroy(cpu -> recompiler);
+
   free(cpu);
   cpu = NULL;
   return cpu;
@@ -397,7 +1488,9 @@ static cpu_t* destroy (cpu_t* cpu)
 
 cpu_namespace_t const cpu = {
   .create = create,
-  .destroy = destroy
+  .destroy = destroy,
+  .decode = decode,
+  .halts = halts
 };
 
 
@@ -411,6 +1504,12 @@ cpu_namespace_t const cpu = {
 // Synopsis:
 // Implements the methods of the CPU object.
 // Ports SimpleNES (reference [0]) to clang for learning purposes.
+// Executes the 6502/2A03 instruction set, official and unofficial opcodes, driven by
+// the 256-entry opcode table (operation, addressing mode, base cycles, page-cross penalty).
+// The straight runs of code are decoded once into the block cache (operands resolved and
+// base cycles summed), so the hot loop neither fetches nor decodes the opcodes.
+// With the recompiler engine the hot blocks run as native (x86-64) code instead.
+// With the accurate engine the instructions execute cycle by cycle (see cpuCycle.c).
 //
 // Copyright (c) 2023 Misael Diaz-Maldonado
 // This file is released under the GNU General Public License as published
@@ -419,3 +1518,6 @@ cpu_namespace_t const cpu = {
 //
 // References:
 // [0] https://github.com/amhndu/SimpleNES
+// [1] https://www.nesdev.org/obelisk-6502-guide/reference.html
+// [2] https://www.nesdev.org/wiki/CPU_unofficial_opcodes
+// [3] https://www.nesdev.org/6502_cpu.txt
@@ -0,0 +1,1016 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include "cpuBatch.h"
+#include "mapperData.h"
+
+extern cpu_namespace_t const cpu;
+
+// CPU batch private data typedef:
+typedef struct
+{
+  cpu_t** m_cpus;			// (borrowed) scalar instances
+  byte_t** m_ram;			// work RAM of the lanes
+  const byte_t** m_pages;		// page flags of the block caches of the lanes
+  size_t m_count;
+  // registers (struct-of-arrays, a lane per instance):
+  address_t* m_pc;
+  address_t* m_abs;
+  byte_t* m_a;
+  byte_t* m_x;
+  byte_t* m_y;
+  byte_t* m_sp;
+  byte_t* m_status;
+  // lockstep state:
+  byte_t* m_mask;			// 0xff for the lanes executing the instruction
+  byte_t* m_value;			// operand (or result) of the lane
+  uint64_t* m_cycles;			// elapsed cycles (in this run)
+  uint64_t* m_clock;			// clock count (at the start of this run)
+  byte_t m_code[256];			// pages of the RAM code executed in lockstep
+  bool m_isStale;			// a store may have changed the code of the lanes
+} data_t;
+
+typedef struct	// CPU::Batch::Group (the masked lanes, executing in lockstep)
+{
+  address_t pc;				// PC of the lanes
+  uint64_t spent;			// base cycles spent (not yet added to the lanes)
+  uint64_t lead;			// cycles of the lane furthest ahead (without the spent)
+} group_t;
+
+typedef enum	// CPU::Batch::Lockstep (outcome of the instruction)
+{
+  LockstepWhole,			// the group executed it and stays together
+  LockstepDiverged,			// the group executed it and split (the lanes have it all)
+  LockstepScalar,			// the group did not execute it (the scalar CPUs shall)
+} lockstep_t;
+
+
+// bytes of the instructions (opcode and operand) by addressing mode:
+static const byte_t lengths[] = {
+  [IMP] = 1, [ACC] = 1, [IMM] = 2, [ZP0] = 2, [ZPX] = 2, [ZPY] = 2, [ABS] = 3,
+  [ABX] = 3, [ABY] = 3, [IND] = 3, [IZX] = 2, [IZY] = 2, [REL] = 2
+};
+
+
+// reads the byte of the lane (the work RAM straight, the rest through the bus)
+static inline byte_t load (const data_t* d, size_t const i, address_t const address)
+{
+  const bus_t* bus = d -> m_cpus[i] -> bus;
+  return (address < NES_CPU_WORK_RAM)? d -> m_ram[i][address] : bus -> read(bus, address);
+}
+
+
+// the value for the lanes in the mask, the old value for the rest (branchless)
+static inline byte_t select8 (byte_t const mask, byte_t const value, byte_t const old)
+{
+  return ( (value & mask) | (old & ~mask) );
+}
+
+
+static inline address_t select16 (byte_t const mask, address_t const value, address_t const old)
+{
+  address_t const wide = (address_t) (int16_t) (int8_t) mask;
+  return ( (value & wide) | (old & ~wide) );
+}
+
+
+static inline byte_t setNZ (byte_t const status, byte_t const value)
+{
+  byte_t const flags = ( (value & NegativeFlag) | ( (value == 0)? ZeroFlag : 0 ) );
+  return ( (status & ~(NegativeFlag | ZeroFlag)) | flags );
+}
+
+
+static void gatherLane (data_t* d, size_t const i)
+{
+  const cpu_t* c = d -> m_cpus[i];
+  d -> m_pc[i] = c -> pc;
+  d -> m_abs[i] = c -> abs;
+  d -> m_a[i] = c -> a;
+  d -> m_x[i] = c -> x;
+  d -> m_y[i] = c -> y;
+  d -> m_sp[i] = c -> sp;
+  d -> m_status[i] = c -> status;
+}
+
+
+static void scatterLane (data_t* d, size_t const i)
+{
+  cpu_t* c = d -> m_cpus[i];
+  c -> pc = d -> m_pc[i];
+  c -> abs = d -> m_abs[i];
+  c -> a = d -> m_a[i];
+  c -> x = d -> m_x[i];
+  c -> y = d -> m_y[i];
+  c -> sp = d -> m_sp[i];
+  c -> status = d -> m_status[i];
+}
+
+
+// executes the next instruction of the lane with the (scalar) CPU
+static void scalar (data_t* d, size_t const i)
+{
+  cpu_t* c = d -> m_cpus[i];
+  scatterLane(d, i);
+  d -> m_cycles[i] += c -> step(c);
+  gatherLane(d, i);
+}
+
+
+// fetches the instruction bytes at PC of the lane (straight from the page table if it can)
+static void fetch (const bus_t* bus, address_t const pc, size_t const length, byte_t* code)
+{
+  const byte_t* page = bus -> reads[pc >> 8];
+  bool const isInPage = ( (pc & 0x00ff) + length <= 0x0100 );
+  if (page != NULL && isInPage)
+  {
+    memcpy(code, page + (pc & 0x00ff), length);
+    return;
+  }
+
+  for (size_t i = 0; i != length; ++i)
+  {
+    code[i] = bus -> peek(bus, pc + i);
+  }
+}
+
+
+// fetches the instruction at PC of the lane, returns its length
+static size_t instruction (const bus_t* bus, address_t const pc, byte_t* code)
+{
+  fetch(bus, pc, 1, code);
+  size_t const length = lengths[cpu.decode(code[0]) -> mode];
+  fetch(bus, pc, length, code);
+  return length;
+}
+
+
+// returns the lane that is the furthest behind (or the count if all have spent the budget)
+static size_t laggard (const data_t* d, uint64_t const budget)
+{
+  size_t lane = d -> m_count;
+  uint64_t least = budget;
+  for (size_t i = 0; i != d -> m_count; ++i)
+  {
+    if (d -> m_cycles[i] < least)
+    {
+      least = d -> m_cycles[i];
+      lane = i;
+    }
+  }
+
+  return lane;
+}
+
+
+// masks the lanes at the PC of the leader running the same code, returns their number
+// (the lanes whose bus is watched execute alone, with their scalar CPUs)
+static size_t group (data_t* d,
+		     group_t* g,
+		     size_t const leader,
+		     uint64_t const budget,
+		     const byte_t* code,
+		     size_t const length)
+{
+  size_t const n = d -> m_count;
+  address_t const pc = d -> m_pc[leader];
+  byte_t* restrict mask = d -> m_mask;
+  const address_t* restrict pcs = d -> m_pc;
+  const uint64_t* restrict cycles = d -> m_cycles;
+  for (size_t i = 0; i != n; ++i)
+  {
+    mask[i] = (pcs[i] == pc && cycles[i] < budget)? 0xff : 0x00;
+  }
+
+  bool const isMapped = (d -> m_cpus[leader] -> bus -> mapper != NULL);
+  size_t lanes = 0;
+  for (size_t i = 0; i != n; ++i)
+  {
+    if (mask[i])
+    {
+      byte_t bytes[3];
+      const bus_t* bus = d -> m_cpus[i] -> bus;
+      fetch(bus, pc, length, bytes);
+      bool const isSame = ( (bus -> mapper != NULL) == isMapped && bus -> countWatches == 0 &&
+			    memcmp(bytes, code, length) == 0 );
+      mask[i] = (isSame)? 0xff : 0x00;
+      lanes += (mask[i])? 1 : 0;
+    }
+  }
+
+  uint64_t lead = 0;
+  for (size_t i = 0; i != n; ++i)
+  {
+    lead = (mask[i] && cycles[i] > lead)? cycles[i] : lead;
+  }
+
+  g -> pc = pc;
+  g -> spent = 0;
+  g -> lead = lead;
+  return lanes;
+}
+
+
+// true for the operations that the lanes execute in lockstep, the rest are executed by
+// the scalar CPUs (BRK, RTI, JAM, and the unofficial operations)
+static bool isLockstep (byte_t const op)
+{
+  switch (op)
+  {
+    case BRK:
+    case RTI:
+    case JAM:
+      return false;
+    default:
+      return (op < ALR);
+  }
+}
+
+
+// true for the operations that read their operand
+static bool isRead (byte_t const op, byte_t const mode)
+{
+  switch (op)
+  {
+    case LDA: case LDX: case LDY: case AND: case ORA: case EOR: case ADC: case SBC:
+    case CMP: case CPX: case CPY: case BIT: case INC: case DEC: case ASL: case LSR:
+    case ROL: case ROR:
+      return (mode != IMP && mode != ACC);
+    default:
+      return false;
+  }
+}
+
+
+// computes the operand address of the lanes (and their page-crossing penalties)
+static void address (data_t* d,
+		     group_t* g,
+		     const instruction_t* instruction,
+		     address_t const operand)
+{
+  size_t const n = d -> m_count;
+  const byte_t* restrict mask = d -> m_mask;
+  address_t* restrict abs = d -> m_abs;
+  uint64_t* restrict cycles = d -> m_cycles;
+  const byte_t* restrict x = d -> m_x;
+  const byte_t* restrict y = d -> m_y;
+  uint64_t const penalty = instruction -> penalty;
+  uint64_t lead = g -> lead;
+  switch (instruction -> mode)
+  {
+    case ZP0:
+    case ABS:
+      for (size_t i = 0; i != n; ++i)
+      {
+	abs[i] = select16(mask[i], operand, abs[i]);
+      }
+      break;
+    case ZPX:
+    case ZPY:
+    {
+      const byte_t* restrict reg = (instruction -> mode == ZPX)? x : y;
+      for (size_t i = 0; i != n; ++i)
+      {
+	abs[i] = select16(mask[i], (operand + reg[i]) & 0x00ff, abs[i]);
+      }
+      break;
+    }
+    case ABX:
+    case ABY:
+    {
+      const byte_t* restrict reg = (instruction -> mode == ABX)? x : y;
+      for (size_t i = 0; i != n; ++i)
+      {
+	address_t const addr = (operand + reg[i]);
+	abs[i] = select16(mask[i], addr, abs[i]);
+	cycles[i] += (mask[i] & 1) * ( ( (operand ^ addr) & 0xff00 )? penalty : 0 );
+	lead = (mask[i] && cycles[i] > lead)? cycles[i] : lead;
+      }
+      break;
+    }
+    case IZX:
+      for (size_t i = 0; i != n; ++i)
+      {
+	if (mask[i])
+	{
+	  address_t const ptr = ( (operand + x[i]) & 0x00ff );
+	  abs[i] = ( (load(d, i, (ptr + 1) & 0x00ff) << 8) | load(d, i, ptr) );
+	}
+      }
+      break;
+    case IZY:
+      for (size_t i = 0; i != n; ++i)
+      {
+	if (mask[i])
+	{
+	  address_t const base = ( (load(d, i, (operand + 1) & 0x00ff) << 8) |
+				   load(d, i, operand & 0x00ff) );
+	  abs[i] = (base + y[i]);
+	  cycles[i] += ( (base ^ abs[i]) & 0xff00 )? penalty : 0;
+	  lead = (cycles[i] > lead)? cycles[i] : lead;
+	}
+      }
+      break;
+    default:
+      break;
+  }
+
+  g -> lead = lead;
+}
+
+
+// writes the byte, flags the lanes stale if it may have changed the code (written RAM
+// code or a mapper register, possibly switching banks)
+static void write (data_t* d, size_t const i, address_t const address, byte_t const value)
+{
+  // the RAM that holds no decoded code of the lane is written straight:
+  bool const isPlainRAM = (address < NES_CPU_WORK_RAM && d -> m_pages[i][address >> 8] == 0);
+  if (isPlainRAM)
+  {
+    d -> m_ram[i][address] = value;
+  }
+  else
+  {
+    bus_t* bus = d -> m_cpus[i] -> bus;
+    bus -> write(bus, address, value);
+    cpu.halts(d -> m_cpus[i]);		// (no console stalls the lanes, the DMA is counted)
+  }
+
+  d -> m_isStale |= (address >= 0x8000 || d -> m_code[address >> 8]);
+}
+
+
+// writes the values of the lanes to their operand addresses
+static void store (data_t* d, const byte_t* value)
+{
+  for (size_t i = 0; i != d -> m_count; ++i)
+  {
+    if (d -> m_mask[i])
+    {
+      write(d, i, d -> m_abs[i], value[i]);
+    }
+  }
+}
+
+
+static void push (data_t* d, size_t const i, byte_t const value)
+{
+  write(d, i, 0x0100 | d -> m_sp[i], value);
+  --d -> m_sp[i];
+}
+
+
+static byte_t pull (data_t* d, size_t const i)
+{
+  ++d -> m_sp[i];
+  return load(d, i, 0x0100 | d -> m_sp[i]);
+}
+
+
+// hands the PC and the spent cycles of the group to its lanes
+static void flush (data_t* d, group_t* g)
+{
+  size_t const n = d -> m_count;
+  const byte_t* restrict mask = d -> m_mask;
+  address_t* restrict pcs = d -> m_pc;
+  uint64_t* restrict cycles = d -> m_cycles;
+  for (size_t i = 0; i != n; ++i)
+  {
+    pcs[i] = select16(mask[i], g -> pc, pcs[i]);
+    cycles[i] += (mask[i] & 1) * g -> spent;
+  }
+
+  g -> lead += g -> spent;
+  g -> spent = 0;
+}
+
+
+// true if the lanes (flushed) jumped to the same PC, which becomes the PC of the group
+static bool isUniform (data_t* d, group_t* g, size_t const leader)
+{
+  size_t const n = d -> m_count;
+  const byte_t* restrict mask = d -> m_mask;
+  const address_t* restrict pcs = d -> m_pc;
+  address_t const pc = pcs[leader];
+  byte_t same = 0xff;
+  for (size_t i = 0; i != n; ++i)
+  {
+    same &= (pcs[i] == pc)? 0xff : ~mask[i];
+  }
+
+  g -> pc = pc;
+  return (same != 0x00);
+}
+
+
+#define LANES for (size_t i = 0; i != n; ++i)
+#define MASKED if (mask[i])
+
+
+// executes the instruction at the PC of the group on its lanes
+static lockstep_t lockstep (data_t* d, group_t* g, size_t const leader, const byte_t* code)
+{
+  const instruction_t* instruction = cpu.decode(code[0]);
+  byte_t const op = instruction -> op;
+  byte_t const mode = instruction -> mode;
+  if (!isLockstep(op))
+  {
+    return LockstepScalar;
+  }
+
+  size_t const n = d -> m_count;
+  const byte_t* restrict mask = d -> m_mask;
+  address_t* restrict pcs = d -> m_pc;
+  byte_t* restrict a = d -> m_a;
+  byte_t* restrict x = d -> m_x;
+  byte_t* restrict y = d -> m_y;
+  byte_t* restrict sp = d -> m_sp;
+  byte_t* restrict p = d -> m_status;
+  byte_t* restrict v = d -> m_value;
+  uint64_t* restrict cycles = d -> m_cycles;
+
+  size_t const length = lengths[mode];
+  address_t const next = (g -> pc + length);
+  address_t const operand = (length == 3)? (code[1] | (code[2] << 8)) :
+			    (length == 2)? code[1] : 0x0000;
+  g -> pc = next;
+  g -> spent += instruction -> cycles;
+  address(d, g, instruction, operand);
+
+  // fetches the operands:
+  if (mode == IMM)
+  {
+    LANES
+    {
+      v[i] = code[1];
+    }
+  }
+  else if (isRead(op, mode))
+  {
+    LANES MASKED
+    {
+      v[i] = load(d, i, d -> m_abs[i]);
+    }
+  }
+
+  // executes the operation:
+  switch (op)
+  {
+    case LDA:
+      LANES
+      {
+	a[i] = select8(mask[i], v[i], a[i]);
+	p[i] = select8(mask[i], setNZ(p[i], v[i]), p[i]);
+      }
+      break;
+    case LDX:
+      LANES
+      {
+	x[i] = select8(mask[i], v[i], x[i]);
+	p[i] = select8(mask[i], setNZ(p[i], v[i]), p[i]);
+      }
+      break;
+    case LDY:
+      LANES
+      {
+	y[i] = select8(mask[i], v[i], y[i]);
+	p[i] = select8(mask[i], setNZ(p[i], v[i]), p[i]);
+      }
+      break;
+    case STA:
+      store(d, a);
+      break;
+    case STX:
+      store(d, x);
+      break;
+    case STY:
+      store(d, y);
+      break;
+    case TAX:
+    case TAY:
+    case TSX:
+    case TXA:
+    case TYA:
+    case TXS:
+    {
+      const byte_t* restrict src = (op == TAX || op == TAY)? a : (op == TSX)? sp :
+				   (op == TYA)? y : x;
+      byte_t* restrict dst = (op == TAX || op == TSX)? x : (op == TAY)? y :
+			     (op == TXS)? sp : a;
+      byte_t const flags = (op == TXS)? 0x00 : 0xff;
+      LANES
+      {
+	byte_t const value = src[i];
+	dst[i] = select8(mask[i], value, dst[i]);
+	p[i] = select8(mask[i] & flags, setNZ(p[i], value), p[i]);
+      }
+      break;
+    }
+    case INX:
+    case INY:
+    case DEX:
+    case DEY:
+    {
+      byte_t* restrict reg = (op == INX || op == DEX)? x : y;
+      byte_t const step = (op == INX || op == INY)? 0x01 : 0xff;
+      LANES
+      {
+	byte_t const value = (reg[i] + step);
+	reg[i] = select8(mask[i], value, reg[i]);
+	p[i] = select8(mask[i], setNZ(p[i], value), p[i]);
+      }
+      break;
+    }
+    case CLC:
+    case CLD:
+    case CLI:
+    case CLV:
+    {
+      byte_t const flag = (op == CLC)? CarryFlag : (op == CLD)? DecimalFlag :
+			  (op == CLI)? InterruptDisableFlag : OverflowFlag;
+      LANES
+      {
+	p[i] &= ~(mask[i] & flag);
+      }
+      break;
+    }
+    case SEC:
+    case SED:
+    case SEI:
+    {
+      byte_t const flag = (op == SEC)? CarryFlag : (op == SED)? DecimalFlag :
+			  InterruptDisableFlag;
+      LANES
+      {
+	p[i] |= (mask[i] & flag);
+      }
+      break;
+    }
+    case AND:
+    case ORA:
+    case EOR:
+      LANES
+      {
+	byte_t const value = (op == AND)? (a[i] & v[i]) : (op == ORA)? (a[i] | v[i]) :
+			     (a[i] ^ v[i]);
+	a[i] = select8(mask[i], value, a[i]);
+	p[i] = select8(mask[i], setNZ(p[i], value), p[i]);
+      }
+      break;
+    case ADC:
+    case SBC:
+    {
+      byte_t const invert = (op == SBC)? 0xff : 0x00;
+      LANES
+      {
+	byte_t const value = (v[i] ^ invert);
+	uint16_t const sum = (a[i] + value + (p[i] & CarryFlag));
+	byte_t const res = (byte_t) sum;
+	byte_t const overflow = ( (~(a[i] ^ value) & (a[i] ^ res) & 0x80) >> 1 );
+	byte_t flags = p[i] & ~(CarryFlag | OverflowFlag);
+	flags |= (sum >> 8) | overflow;
+	a[i] = select8(mask[i], res, a[i]);
+	p[i] = select8(mask[i], setNZ(flags, res), p[i]);
+      }
+      break;
+    }
+    case CMP:
+    case CPX:
+    case CPY:
+    {
+      const byte_t* restrict reg = (op == CMP)? a : (op == CPX)? x : y;
+      LANES
+      {
+	byte_t const res = (reg[i] - v[i]);
+	byte_t const flags = (p[i] & ~CarryFlag) | ( (reg[i] >= v[i])? CarryFlag : 0 );
+	p[i] = select8(mask[i], setNZ(flags, res), p[i]);
+      }
+      break;
+    }
+    case BIT:
+      LANES
+      {
+	byte_t const flags = (p[i] & ~(NegativeFlag | OverflowFlag | ZeroFlag)) |
+			     (v[i] & (NegativeFlag | OverflowFlag)) |
+			     ( (a[i] & v[i])? 0 : ZeroFlag );
+	p[i] = select8(mask[i], flags, p[i]);
+      }
+      break;
+    case INC:
+    case DEC:
+    {
+      byte_t const step = (op == INC)? 0x01 : 0xff;
+      LANES
+      {
+	v[i] += step;
+	p[i] = select8(mask[i], setNZ(p[i], v[i]), p[i]);
+      }
+      store(d, v);
+      break;
+    }
+    case ASL_A:
+    case LSR_A:
+    case ROL_A:
+    case ROR_A:
+    case ASL:
+    case LSR:
+    case ROL:
+    case ROR:
+    {
+      bool const isAccumulator = (mode == ACC);
+      bool const isLeft = (op == ASL || op == ASL_A || op == ROL || op == ROL_A);
+      bool const isRotate = (op == ROL || op == ROL_A || op == ROR || op == ROR_A);
+      LANES
+      {
+	byte_t const value = (isAccumulator)? a[i] : v[i];
+	byte_t const carry = (isRotate)? (p[i] & CarryFlag) : 0;
+	byte_t const out = (isLeft)? (value >> 7) : (value & 0x01);
+	byte_t const res = (isLeft)? ( (value << 1) | carry ) : ( (value >> 1) | (carry << 7) );
+	byte_t const flags = (p[i] & ~CarryFlag) | out;
+	p[i] = select8(mask[i], setNZ(flags, res), p[i]);
+	a[i] = (isAccumulator)? select8(mask[i], res, a[i]) : a[i];
+	v[i] = res;
+      }
+
+      if (!isAccumulator)
+      {
+	store(d, v);
+      }
+      break;
+    }
+    case BCC:
+    case BCS:
+    case BNE:
+    case BEQ:
+    case BPL:
+    case BMI:
+    case BVC:
+    case BVS:
+    {
+      byte_t const flag = (op == BCC || op == BCS)? CarryFlag : (op == BNE || op == BEQ)?
+			  ZeroFlag : (op == BPL || op == BMI)? NegativeFlag : OverflowFlag;
+      byte_t const isSet = (op == BCS || op == BEQ || op == BMI || op == BVS)? flag : 0;
+      address_t const target = (next + (int8_t) operand);
+      uint64_t const extra = 1 + ( ( (target ^ next) & 0xff00 )? 1 : 0 );
+      byte_t any = 0x00;
+      byte_t all = 0xff;
+      LANES
+      {
+	byte_t const taken = ( (p[i] & flag) == isSet )? mask[i] : 0x00;
+	v[i] = taken;
+	any |= taken;
+	all &= (taken | ~mask[i]);
+      }
+
+      if (any == 0x00)
+      {
+	break;
+      }
+
+      if (all == 0xff)
+      {
+	g -> pc = target;
+	g -> spent += extra;
+	break;
+      }
+
+      // the lanes split:
+      flush(d, g);
+      LANES
+      {
+	pcs[i] = select16(v[i], target, pcs[i]);
+	cycles[i] += (v[i] & 1) * extra;
+      }
+
+      return LockstepDiverged;
+    }
+    case JMP:
+      if (mode == IND)				// caters hardware bug (no carry into the high byte)
+      {
+	address_t const high = ( (operand & 0xff00) | ( (operand + 1) & 0x00ff ) );
+	flush(d, g);
+	LANES MASKED
+	{
+	  pcs[i] = ( (load(d, i, high) << 8) | load(d, i, operand) );
+	}
+
+	return (isUniform(d, g, leader))? LockstepWhole : LockstepDiverged;
+      }
+
+      g -> pc = operand;
+      break;
+    case JSR:
+    {
+      address_t const ret = (next - 1);
+      LANES MASKED
+      {
+	push(d, i, ret >> 8);
+	push(d, i, ret & 0x00ff);
+      }
+
+      g -> pc = operand;
+      break;
+    }
+    case RTS:
+      flush(d, g);
+      LANES MASKED
+      {
+	address_t const lo = pull(d, i);
+	address_t const hi = pull(d, i);
+	pcs[i] = ( (hi << 8) | lo ) + 1;
+      }
+
+      return (isUniform(d, g, leader))? LockstepWhole : LockstepDiverged;
+    case PHA:
+      LANES MASKED
+      {
+	push(d, i, a[i]);
+      }
+      break;
+    case PHP:
+      LANES MASKED
+      {
+	push(d, i, p[i] | BreakFlag | UnusedFlag);
+      }
+      break;
+    case PLA:
+      LANES MASKED
+      {
+	a[i] = pull(d, i);
+	p[i] = setNZ(p[i], a[i]);
+      }
+      break;
+    case PLP:
+      LANES MASKED
+      {
+	p[i] = (pull(d, i) & ~BreakFlag) | UnusedFlag;
+      }
+      break;
+    default:					// NOP
+      break;
+  }
+
+  return LockstepWhole;
+}
+
+
+#undef LANES
+#undef MASKED
+
+
+// executes the budget of cycles on each instance, the instances at the same PC execute
+// together (in lockstep), the one that falls behind alone executes with its scalar CPU;
+// returns the largest number of elapsed cycles (each instance may overshoot the budget)
+static size_t run (void* vbatch, size_t const budget)
+{
+  cpuBatch_t* batch = vbatch;
+  data_t* d = batch -> data;
+  if (budget == 0)
+  {
+    return 0;
+  }
+
+  for (size_t i = 0; i != d -> m_count; ++i)
+  {
+    gatherLane(d, i);
+    d -> m_cycles[i] = 0;
+    d -> m_clock[i] = d -> m_cpus[i] -> clock_count;
+  }
+
+  // the lane furthest behind leads (so that the lanes converge):
+  for (size_t leader = laggard(d, budget); leader != d -> m_count; leader = laggard(d, budget))
+  {
+    group_t g;
+    byte_t code[3] = { 0x00, 0x00, 0x00 };
+    const bus_t* bus = d -> m_cpus[leader] -> bus;
+    if (bus -> countWatches != 0)
+    {
+      scalar(d, leader);
+      continue;
+    }
+
+    size_t const length = instruction(bus, d -> m_pc[leader], code);
+    size_t const lanes = group(d, &g, leader, budget, code, length);
+    if (lanes == 1)
+    {
+      scalar(d, leader);
+      continue;
+    }
+
+    // executes the group in lockstep while it stays whole in the same 8KB page of ROM
+    // (the RAM code and the other pages may differ among the lanes, so these regroup):
+    address_t const page = (g.pc & 0xe000);
+    lockstep_t outcome = LockstepWhole;
+    while (outcome == LockstepWhole)
+    {
+      bool const isROM = (g.pc >= 0x8000 && bus -> mapper != NULL);
+      if (!isROM)
+      {
+	d -> m_code[g.pc >> 8] = 0x01;
+	d -> m_code[( (g.pc + 2) >> 8 ) & 0xff] = 0x01;
+      }
+
+      d -> m_isStale = false;
+      outcome = lockstep(d, &g, leader, code);
+      if (outcome == LockstepScalar)
+      {
+	flush(d, &g);
+	for (size_t i = 0; i != d -> m_count; ++i)
+	{
+	  if (d -> m_mask[i])
+	  {
+	    scalar(d, i);
+	  }
+	}
+      }
+      else if (outcome == LockstepWhole)
+      {
+	bool const isInPage = ( (g.pc & 0xe000) == page && (g.pc & 0x1fff) <= 0x1ffd );
+	bool const isShort = (g.lead + g.spent < budget);
+	if (isROM && isInPage && isShort && !d -> m_isStale)
+	{
+	  instruction(bus, g.pc, code);
+	}
+	else
+	{
+	  flush(d, &g);
+	  outcome = LockstepDiverged;
+	}
+      }
+    }
+  }
+
+  size_t elapsed = 0;
+  for (size_t i = 0; i != d -> m_count; ++i)
+  {
+    scatterLane(d, i);
+    d -> m_cpus[i] -> clock_count = d -> m_clock[i] + d -> m_cycles[i];
+    elapsed = (d -> m_cycles[i] > elapsed)? d -> m_cycles[i] : elapsed;
+  }
+
+  return elapsed;
+}
+
+
+static size_t getCount (const void* vbatch)
+{
+  const cpuBatch_t* batch = vbatch;
+  const data_t* d = batch -> data;
+  return d -> m_count;
+}
+
+
+// allocates a (zeroed) array of the lanes aligned for the vector registers
+static void* lanes (size_t const count, size_t const size)
+{
+  size_t const bytes = (count * size + NES_CPU_BATCH_ALIGNMENT - 1) &
+		       ~(NES_CPU_BATCH_ALIGNMENT - 1);
+  void* array = aligned_alloc(NES_CPU_BATCH_ALIGNMENT, bytes);
+  if (array != NULL)
+  {
+    memset(array, 0, bytes);
+  }
+
+  return array;
+}
+
+
+static void release (data_t* d)
+{
+  free(d -> m_cpus);
+  free(d -> m_ram);
+  free(d -> m_pages);
+  free(d -> m_pc);
+  free(d -> m_abs);
+  free(d -> m_a);
+  free(d -> m_x);
+  free(d -> m_y);
+  free(d -> m_sp);
+  free(d -> m_status);
+  free(d -> m_mask);
+  free(d -> m_value);
+  free(d -> m_cycles);
+  free(d -> m_clock);
+}
+
+
+static cpuBatch_t* create (cpu_t** cpus, size_t const count)
+{
+  if (cpus == NULL || count == 0)
+  {
+    printf("CPU::Batch() expects one or more CPUs\n");
+    return NULL;
+  }
+
+  cpuBatch_t* batch = malloc( sizeof(cpuBatch_t) );
+  if (batch == NULL)
+  {
+    printf("CPU::Batch() failed to allocate the CPU batch!\n");
+    return batch;
+  }
+
+  batch -> data = (data_t*) malloc( sizeof(data_t) );
+  if (batch -> data == NULL)
+  {
+    free(batch);
+    batch = NULL;
+    printf("CPU::Batch() failed to allocate the CPU batch data!\n");
+    return batch;
+  }
+
+  data_t* d = batch -> data;
+  d -> m_count = count;
+  d -> m_cpus = lanes(count, sizeof(cpu_t*));
+  d -> m_ram = lanes(count, sizeof(byte_t*));
+  d -> m_pages = lanes(count, sizeof(const byte_t*));
+  d -> m_pc = lanes(count, sizeof(address_t));
+  d -> m_abs = lanes(count, sizeof(address_t));
+  d -> m_a = lanes(count, sizeof(byte_t));
+  d -> m_x = lanes(count, sizeof(byte_t));
+  d -> m_y = lanes(count, sizeof(byte_t));
+  d -> m_sp = lanes(count, sizeof(byte_t));
+  d -> m_status = lanes(count, sizeof(byte_t));
+  d -> m_mask = lanes(count, sizeof(byte_t));
+  d -> m_value = lanes(count, sizeof(byte_t));
+  d -> m_cycles = lanes(count, sizeof(uint64_t));
+  d -> m_clock = lanes(count, sizeof(uint64_t));
+  bool const isAllocated = (d -> m_cpus != NULL && d -> m_ram != NULL &&
+			    d -> m_pages != NULL && d -> m_pc != NULL && d -> m_abs != NULL &&
+			    d -> m_a != NULL && d -> m_x != NULL && d -> m_y != NULL &&
+			    d -> m_sp != NULL && d -> m_status != NULL &&
+			    d -> m_mask != NULL && d -> m_value != NULL &&
+			    d -> m_cycles != NULL && d -> m_clock != NULL);
+  if (!isAllocated)
+  {
+    release(d);
+    free(batch -> data);
+    batch -> data = NULL;
+    free(batch);
+    batch = NULL;
+    printf("CPU::Batch() failed to allocate the lanes!\n");
+    return batch;
+  }
+
+  memcpy(d -> m_cpus, cpus, count * sizeof(cpu_t*));
+  for (size_t i = 0; i != count; ++i)
+  {
+    d -> m_ram[i] = cpus[i] -> ram;
+    d -> m_pages[i] = cpus[i] -> cache -> pages;
+  }
+
+  memset(d -> m_code, 0, sizeof(d -> m_code));
+
+  batch -> run = run;
+  batch -> getCount = getCount;
+  return batch;
+}
+
+
+static cpuBatch_t* destroy (cpuBatch_t* batch)
+{
+  if (batch == NULL)
+  {
+    return batch;
+  }
+
+  release(batch -> data);
+  free(batch -> data);
+  batch -> data = NULL;
+
+  free(batch);
+  batch = NULL;
+  return batch;
+}
+
+
+cpuBatch_namespace_t const cpuBatch = {
+  .create = create,
+  .destroy = destroy
+};
+
+
+// NES Emulation					October 18, 2026
+//
+//			Academic Purpose
+//
+// source: cpuBatch.c
+// author: @misael-diaz
+//
+// Synopsis:
+// Implements the methods of the CPU batch object.
+// The registers of the instances are stored as struct-of-arrays. On each step the lane
+// that is furthest behind leads: the lanes at its PC running the same code execute the
+// instruction together, the register and flag updates are branchless loops over the
+// lanes (masked by selects) that the compiler vectorizes (-O2 -ftree-vectorize, AVX2
+// with -mavx2), while the memory accesses go through the bus of each lane. A lane that
+// diverged from the rest, and the operations not executed in lockstep (BRK, RTI, JAM,
+// and the unofficial operations), are executed by the scalar CPU of the lane.
+//
+// Copyright (c) 2023 Misael Diaz-Maldonado
+// This file is released under the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// References:
+// [0] https://github.com/amhndu/SimpleNES
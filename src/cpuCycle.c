@@ -0,0 +1,690 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "cpuCycle.h"
+
+extern cpu_namespace_t const cpu;
+
+typedef enum	// CPU::Cycle::Access (of the operation to its operand)
+{
+  ReadAccess,				// reads the operand
+  WriteAccess,				// writes the operand
+  ModifyAccess,				// reads, modifies, and writes back the operand
+  OtherAccess,				// implied, stack, and control transfer (own sequence)
+} access_t;
+
+#define READ(address) ( bus -> read(bus, (address)) )
+#define WRITE(address, value) ( bus -> write(bus, (address), (value)) )
+#define STACK(sp) ( 0x0100 | (sp) )
+#define SET_FLAG(flag, cond) ( c -> status = ( (cond)?			\
+  (c -> status | (flag)) : (c -> status & ~(flag)) ) )
+#define SET_NZ(value) setNZ(c, (value))
+
+
+static void setNZ (cpu_t* c, byte_t const value)
+{
+  SET_FLAG(NegativeFlag, value & 0x80);
+  SET_FLAG(ZeroFlag, value == 0);
+}
+
+
+// adds with carry, sets the C and V flags (the caller sets the N and Z flags)
+static byte_t adc (cpu_t* c, byte_t const value)
+{
+  byte_t const a = c -> a;
+  uint16_t const sum = (a + value + (c -> status & CarryFlag));
+  byte_t const res = (byte_t) sum;
+  SET_FLAG(CarryFlag, sum > 0xff);
+  SET_FLAG(OverflowFlag, ~(a ^ value) & (a ^ res) & 0x80);
+  return res;
+}
+
+
+static void compare (cpu_t* c, byte_t const reg, byte_t const value)
+{
+  SET_FLAG(CarryFlag, reg >= value);
+  SET_NZ(reg - value);
+}
+
+
+static access_t kindOf (const instruction_t* instruction)
+{
+  byte_t const op = instruction -> op;
+  byte_t const mode = instruction -> mode;
+  if (mode == IMP || mode == ACC || mode == REL || op == JMP || op == JSR)
+  {
+    return OtherAccess;
+  }
+
+  switch (op)
+  {
+    case STA: case STX: case STY: case SAX: case SHA: case SHX: case SHY: case TAS:
+      return WriteAccess;
+    case ASL: case LSR: case ROL: case ROR: case INC: case DEC:
+    case SLO: case RLA: case SRE: case RRA: case DCP: case ISC:
+      return ModifyAccess;
+    default:
+      return ReadAccess;
+  }
+}
+
+
+// executes the operation on the operand it read
+static void operate (cpu_t* c, byte_t const op, byte_t const value)
+{
+  switch (op)
+  {
+    case ADC: c -> a = adc(c, value); SET_NZ(c -> a); break;
+    case SBC: c -> a = adc(c, ~value); SET_NZ(c -> a); break;
+    case AND: c -> a &= value; SET_NZ(c -> a); break;
+    case ORA: c -> a |= value; SET_NZ(c -> a); break;
+    case EOR: c -> a ^= value; SET_NZ(c -> a); break;
+    case CMP: compare(c, c -> a, value); break;
+    case CPX: compare(c, c -> x, value); break;
+    case CPY: compare(c, c -> y, value); break;
+    case BIT:
+      SET_FLAG(OverflowFlag, value & OverflowFlag);
+      SET_FLAG(NegativeFlag, value & NegativeFlag);
+      SET_FLAG(ZeroFlag, (c -> a & value) == 0);
+      break;
+    case LDA: c -> a = value; SET_NZ(c -> a); break;
+    case LDX: c -> x = value; SET_NZ(c -> x); break;
+    case LDY: c -> y = value; SET_NZ(c -> y); break;
+    case LAX: c -> a = c -> x = value; SET_NZ(c -> a); break;
+    case ANC: c -> a &= value; SET_NZ(c -> a); SET_FLAG(CarryFlag, c -> a & 0x80); break;
+    case ALR:
+      c -> a &= value;
+      SET_FLAG(CarryFlag, c -> a & 0x01);
+      c -> a >>= 1;
+      SET_NZ(c -> a);
+      break;
+    case ARR:
+    {
+      byte_t const a = ( (c -> a & value) >> 1 ) | ( (c -> status & CarryFlag) << 7 );
+      c -> a = a;
+      SET_NZ(a);
+      SET_FLAG(CarryFlag, a & 0x40);
+      SET_FLAG(OverflowFlag, ( (a >> 6) ^ (a >> 5) ) & 0x01);
+      break;
+    }
+    case AXS:
+    {
+      byte_t const ax = (c -> a & c -> x);
+      SET_FLAG(CarryFlag, ax >= value);
+      c -> x = (ax - value);
+      SET_NZ(c -> x);
+      break;
+    }
+    case XAA: c -> a = (c -> a | 0xee) & c -> x & value; SET_NZ(c -> a); break;
+    case LXA: c -> a = c -> x = (c -> a | 0xee) & value; SET_NZ(c -> a); break;
+    case LAS: c -> a = c -> x = c -> sp = (c -> sp & value); SET_NZ(c -> a); break;
+    default:				// NOP (reads the operand all the same)
+      break;
+  }
+}
+
+
+// returns the value the operation writes to its operand
+static byte_t stored (cpu_t* c, byte_t const op)
+{
+  byte_t const hi = ( (c -> abs >> 8) + 1 );
+  switch (op)
+  {
+    case STA: return c -> a;
+    case STX: return c -> x;
+    case STY: return c -> y;
+    case SAX: return (c -> a & c -> x);
+    case SHA: return (c -> a & c -> x & hi);
+    case SHX: return (c -> x & hi);
+    case SHY: return (c -> y & hi);
+    default:				// TAS
+      c -> sp = (c -> a & c -> x);
+      return (c -> sp & hi);
+  }
+}
+
+
+// returns the modified operand (read-modify-write operations)
+static byte_t modify (cpu_t* c, byte_t const op, byte_t value)
+{
+  byte_t const carry = (c -> status & CarryFlag);
+  switch (op)
+  {
+    case ASL:
+    case SLO:
+      SET_FLAG(CarryFlag, value & 0x80);
+      value <<= 1;
+      break;
+    case LSR:
+    case SRE:
+      SET_FLAG(CarryFlag, value & 0x01);
+      value >>= 1;
+      break;
+    case ROL:
+    case RLA:
+      SET_FLAG(CarryFlag, value & 0x80);
+      value = (value << 1) | carry;
+      break;
+    case ROR:
+    case RRA:
+      SET_FLAG(CarryFlag, value & 0x01);
+      value = (value >> 1) | (carry << 7);
+      break;
+    case INC:
+    case ISC:
+      ++value;
+      break;
+    default:				// DEC, DCP
+      --value;
+      break;
+  }
+
+  switch (op)
+  {
+    case SLO: c -> a |= value; SET_NZ(c -> a); break;
+    case RLA: c -> a &= value; SET_NZ(c -> a); break;
+    case SRE: c -> a ^= value; SET_NZ(c -> a); break;
+    case RRA: c -> a = adc(c, value); SET_NZ(c -> a); break;
+    case ISC: c -> a = adc(c, ~value); SET_NZ(c -> a); break;
+    case DCP: compare(c, c -> a, value); break;
+    default: SET_NZ(value); break;
+  }
+
+  return value;
+}
+
+
+// executes the (register or flag) operation of the implied and accumulator modes
+static void implied (cpu_t* c, byte_t const op)
+{
+  byte_t const carry = (c -> status & CarryFlag);
+  switch (op)
+  {
+    case TAX: c -> x = c -> a; SET_NZ(c -> x); break;
+    case TAY: c -> y = c -> a; SET_NZ(c -> y); break;
+    case TSX: c -> x = c -> sp; SET_NZ(c -> x); break;
+    case TXA: c -> a = c -> x; SET_NZ(c -> a); break;
+    case TXS: c -> sp = c -> x; break;
+    case TYA: c -> a = c -> y; SET_NZ(c -> a); break;
+    case INX: ++c -> x; SET_NZ(c -> x); break;
+    case INY: ++c -> y; SET_NZ(c -> y); break;
+    case DEX: --c -> x; SET_NZ(c -> x); break;
+    case DEY: --c -> y; SET_NZ(c -> y); break;
+    case CLC: c -> status &= ~CarryFlag; break;
+    case CLD: c -> status &= ~DecimalFlag; break;
+    case CLI: c -> status &= ~InterruptDisableFlag; break;
+    case CLV: c -> status &= ~OverflowFlag; break;
+    case SEC: c -> status |= CarryFlag; break;
+    case SED: c -> status |= DecimalFlag; break;
+    case SEI: c -> status |= InterruptDisableFlag; break;
+    case ASL_A: SET_FLAG(CarryFlag, c -> a & 0x80); c -> a <<= 1; SET_NZ(c -> a); break;
+    case LSR_A: SET_FLAG(CarryFlag, c -> a & 0x01); c -> a >>= 1; SET_NZ(c -> a); break;
+    case ROL_A:
+      SET_FLAG(CarryFlag, c -> a & 0x80);
+      c -> a = (c -> a << 1) | carry;
+      SET_NZ(c -> a);
+      break;
+    case ROR_A:
+      SET_FLAG(CarryFlag, c -> a & 0x01);
+      c -> a = (c -> a >> 1) | (carry << 7);
+      SET_NZ(c -> a);
+      break;
+    default:				// NOP
+      break;
+  }
+}
+
+
+static bool isTaken (const cpu_t* c, byte_t const op)
+{
+  byte_t const p = c -> status;
+  switch (op)
+  {
+    case BCC: return !(p & CarryFlag);
+    case BCS: return (p & CarryFlag);
+    case BNE: return !(p & ZeroFlag);
+    case BEQ: return (p & ZeroFlag);
+    case BPL: return !(p & NegativeFlag);
+    case BMI: return (p & NegativeFlag);
+    case BVC: return !(p & OverflowFlag);
+    default: return (p & OverflowFlag);	// BVS
+  }
+}
+
+
+// executes the cycle (after the opcode fetch) of the operations that access an operand,
+// returns true on the last one; the addressing takes the cycles of ref[1] (the dummy
+// reads included) and then the operand is read, written, or read-modified-written
+static bool operand (cpu_t* c, const instruction_t* instruction, access_t const kind,
+		     byte_t const tick)
+{
+  bus_t* bus = c -> bus;
+  byte_t const mode = instruction -> mode;
+  byte_t const index = (mode == ZPY || mode == ABY || mode == IZY)? c -> y : c -> x;
+  byte_t start = 0;			// cycle of the first access to the operand
+  switch (mode)
+  {
+    case IMM:
+      c -> abs = (tick == 1)? c -> pc++ : c -> abs;
+      start = 1;
+      break;
+    case ZP0:
+      if (tick == 1)
+      {
+	c -> abs = READ(c -> pc++);
+	return false;
+      }
+
+      start = 2;
+      break;
+    case ZPX:
+    case ZPY:
+      if (tick == 1)
+      {
+	c -> abs = READ(c -> pc++);
+	return false;
+      }
+
+      if (tick == 2)
+      {
+	READ(c -> abs);			// (reads the base while adding the index)
+	c -> abs = ( (c -> abs + index) & 0x00ff );
+	return false;
+      }
+
+      start = 3;
+      break;
+    case ABS:
+    case ABX:
+    case ABY:
+      if (tick == 1)
+      {
+	c -> abs = READ(c -> pc++);
+	return false;
+      }
+
+      if (tick == 2)
+      {
+	address_t const base = ( (READ(c -> pc++) << 8) | c -> abs );
+	c -> abs = base + ( (mode == ABS)? 0 : index );
+	c -> rel = ( (base & 0xff00) | (c -> abs & 0x00ff) );	// (before the fix up)
+	return false;
+      }
+
+      start = 3;
+      break;
+    case IZX:
+      switch (tick)
+      {
+	case 1:
+	  c -> fetched = READ(c -> pc++);
+	  return false;
+	case 2:
+	  READ(c -> fetched);		// (reads the pointer while adding the index)
+	  c -> fetched += index;
+	  return false;
+	case 3:
+	  c -> abs = READ(c -> fetched);
+	  return false;
+	case 4:
+	  c -> abs |= ( READ( (byte_t) (c -> fetched + 1) ) << 8 );
+	  return false;
+      }
+
+      start = 5;
+      break;
+    default:				// IZY
+      switch (tick)
+      {
+	case 1:
+	  c -> fetched = READ(c -> pc++);
+	  return false;
+	case 2:
+	  c -> abs = READ(c -> fetched);
+	  return false;
+	case 3:
+	{
+	  address_t const base = ( (READ( (byte_t) (c -> fetched + 1) ) << 8) | c -> abs );
+	  c -> abs = base + index;
+	  c -> rel = ( (base & 0xff00) | (c -> abs & 0x00ff) );
+	  return false;
+	}
+      }
+
+      start = 4;
+      break;
+  }
+
+  // the indexed modes read the address before fixing up its high byte, if the index
+  // crossed the page (or always, if the operation writes) ref[1]:
+  if (mode == ABX || mode == ABY || mode == IZY)
+  {
+    bool const fixes = (c -> abs != c -> rel || kind != ReadAccess);
+    if (fixes && tick == start)
+    {
+      READ(c -> rel);
+      return false;
+    }
+
+    start += (fixes)? 1 : 0;
+  }
+
+  byte_t const op = instruction -> op;
+  switch (kind)
+  {
+    case ReadAccess:
+      operate(c, op, READ(c -> abs));
+      return true;
+    case WriteAccess:
+      WRITE(c -> abs, stored(c, op));
+      return true;
+    default:				// ModifyAccess
+      if (tick == start)
+      {
+	c -> fetched = READ(c -> abs);
+	return false;
+      }
+
+      if (tick == start + 1)
+      {
+	WRITE(c -> abs, c -> fetched);	// (writes back the value while modifying it)
+	c -> fetched = modify(c, op, c -> fetched);
+	return false;
+      }
+
+      WRITE(c -> abs, c -> fetched);
+      return true;
+  }
+}
+
+
+// executes the cycle (after the opcode fetch) of the implied, stack, and control
+// transfer operations, returns true on the last one ref[1]
+static bool sequence (cpu_t* c, const instruction_t* instruction, byte_t const tick)
+{
+  bus_t* bus = c -> bus;
+  byte_t const op = instruction -> op;
+  switch (op)
+  {
+    case BRK:
+      switch (tick)
+      {
+	case 1:
+	  READ(c -> pc++);		// (the padding byte)
+	  return false;
+	case 2:
+	  WRITE(STACK(c -> sp--), c -> pc >> 8);
+	  return false;
+	case 3:
+	  WRITE(STACK(c -> sp--), c -> pc & 0x00ff);
+	  return false;
+	case 4:
+	  WRITE(STACK(c -> sp--), c -> status | BreakFlag | UnusedFlag);
+	  c -> status |= InterruptDisableFlag;
+	  return false;
+	case 5:
+	  c -> abs = READ(0xfffe);
+	  return false;
+	default:
+	  c -> pc = ( (READ(0xffff) << 8) | c -> abs );
+	  return true;
+      }
+    case JSR:
+      switch (tick)
+      {
+	case 1:
+	  c -> abs = READ(c -> pc++);
+	  return false;
+	case 2:
+	  READ(STACK(c -> sp));
+	  return false;
+	case 3:
+	  WRITE(STACK(c -> sp--), c -> pc >> 8);
+	  return false;
+	case 4:
+	  WRITE(STACK(c -> sp--), c -> pc & 0x00ff);
+	  return false;
+	default:
+	  c -> pc = ( (READ(c -> pc) << 8) | c -> abs );
+	  return true;
+      }
+    case RTS:
+      switch (tick)
+      {
+	case 1:
+	  READ(c -> pc);
+	  return false;
+	case 2:
+	  READ(STACK(c -> sp));
+	  return false;
+	case 3:
+	  c -> abs = READ(STACK(++c -> sp));
+	  return false;
+	case 4:
+	  c -> abs |= ( READ(STACK(++c -> sp)) << 8 );
+	  return false;
+	default:
+	  READ(c -> abs);
+	  c -> pc = (c -> abs + 1);
+	  return true;
+      }
+    case RTI:
+      switch (tick)
+      {
+	case 1:
+	  READ(c -> pc);
+	  return false;
+	case 2:
+	  READ(STACK(c -> sp));
+	  return false;
+	case 3:
+	  c -> status = ( (READ(STACK(++c -> sp)) & ~BreakFlag) | UnusedFlag );
+	  return false;
+	case 4:
+	  c -> abs = READ(STACK(++c -> sp));
+	  return false;
+	default:
+	  c -> pc = ( (READ(STACK(++c -> sp)) << 8) | c -> abs );
+	  return true;
+      }
+    case PHA:
+    case PHP:
+      if (tick == 1)
+      {
+	READ(c -> pc);
+	return false;
+      }
+
+      WRITE(STACK(c -> sp--), (op == PHA)? c -> a : (c -> status | BreakFlag | UnusedFlag));
+      return true;
+    case PLA:
+    case PLP:
+      if (tick == 1)
+      {
+	READ(c -> pc);
+	return false;
+      }
+
+      if (tick == 2)
+      {
+	READ(STACK(c -> sp));
+	return false;
+      }
+
+      if (op == PLA)
+      {
+	c -> a = READ(STACK(++c -> sp));
+	SET_NZ(c -> a);
+	return true;
+      }
+
+      c -> status = ( (READ(STACK(++c -> sp)) & ~BreakFlag) | UnusedFlag );
+      return true;
+    case JMP:
+      switch (tick)
+      {
+	case 1:
+	  c -> abs = READ(c -> pc++);
+	  return false;
+	case 2:
+	  if (instruction -> mode == ABS)
+	  {
+	    c -> pc = ( (READ(c -> pc) << 8) | c -> abs );
+	    return true;
+	  }
+
+	  c -> abs |= ( READ(c -> pc++) << 8 );
+	  return false;
+	case 3:
+	  c -> fetched = READ(c -> abs);
+	  return false;
+	default:			// caters hardware bug (no carry into the high byte)
+	{
+	  address_t const next = ( (c -> abs & 0xff00) | ( (c -> abs + 1) & 0x00ff ) );
+	  c -> pc = ( (READ(next) << 8) | c -> fetched );
+	  return true;
+	}
+      }
+    case JAM:				// halts (re-executes itself, reading the bus)
+      READ(c -> pc);
+      --c -> pc;
+      return true;
+  }
+
+  if (instruction -> mode != REL)
+  {
+    READ(c -> pc);			// (reads the next byte and discards it)
+    implied(c, op);
+    return true;
+  }
+
+  // branches take one more cycle if taken and yet another if crossing the page:
+  switch (tick)
+  {
+    case 1:
+      c -> fetched = READ(c -> pc++);
+      return !isTaken(c, op);
+    case 2:
+      READ(c -> pc);
+      c -> abs = c -> pc + (int8_t) c -> fetched;
+      if ( (c -> abs ^ c -> pc) & 0xff00 )
+      {
+	return false;
+      }
+
+      c -> pc = c -> abs;
+      return true;
+    default:
+      READ( (c -> pc & 0xff00) | (c -> abs & 0x00ff) );
+      c -> pc = c -> abs;
+      return true;
+  }
+}
+
+
+// executes one cycle (one bus access) of the instruction, returns true on its last one
+static bool cycle (cpu_t* c)
+{
+  bus_t* bus = c -> bus;
+  byte_t const tick = c -> tick;
+  ++c -> clock_count;
+  if (tick == 0)
+  {
+    address_t const pc = c -> pc++;
+    c -> opcode = READ(pc);
+    if (bus -> watched[pc >> 8] & WatchExecute)
+    {
+      bus -> notify(bus, pc, c -> opcode, WatchExecute);
+    }
+
+    c -> tick = 1;
+    return false;
+  }
+
+  const instruction_t* instruction = cpu.decode(c -> opcode);
+  access_t const kind = kindOf(instruction);
+  bool const isLast = (kind == OtherAccess)?
+    sequence(c, instruction, tick) : operand(c, instruction, kind, tick);
+  c -> tick = (isLast)? 0 : (tick + 1);
+  return isLast;
+}
+
+
+static void clock (void* vcpu)
+{
+  cpu_t* c = vcpu;
+  cycle(c);
+}
+
+
+// executes the rest of the instruction (or the next one, if at the boundary)
+static size_t step (void* vcpu)
+{
+  cpu_t* c = vcpu;
+  size_t cycles = 0;
+  bool isLast = false;
+  do
+  {
+    isLast = cycle(c);
+    ++cycles;
+  } while (!isLast);
+
+  return cycles;
+}
+
+
+// executes cycle by cycle until the budget is spent, the run ends (as with the fast
+// engines) on the boundary of the instructions so the last one may overshoot the budget
+static size_t run (void* vcpu, size_t const budget)
+{
+  cpu_t* c = vcpu;
+  size_t cycles = 0;
+  bool isHalted = false;
+  while (cycles < budget && !isHalted)
+  {
+    cycles += step(c);
+    isHalted = cpu.halts(c);
+  }
+
+  return cycles;
+}
+
+
+#undef READ
+#undef WRITE
+#undef STACK
+#undef SET_FLAG
+#undef SET_NZ
+
+
+cpuCycle_namespace_t const cpuCycle = {
+  .clock = clock,
+  .step = step,
+  .run = run
+};
+
+
+// NES Emulation					October 18, 2026
+//
+//			Academic Purpose
+//
+// source: cpuCycle.c
+// author: @misael-diaz
+//
+// Synopsis:
+// Implements the accurate engine of the CPU.
+// Each call to clock() performs exactly one bus access, the one the 2A03 performs on that
+// cycle ref[1]: the dummy reads of the implied and indexed modes (at the unfixed address
+// when the index crosses the page), the dummy write of the read-modify-write operations,
+// and the stack reads of the pulls and returns. The clock count advances with each access
+// so that the devices on the bus see the exact cycle. The operations execute as with the
+// fast engines (the opcode table drives both), so that they reach the same state.
+//
+// Copyright (c) 2023 Misael Diaz-Maldonado
+// This file is released under the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// References:
+// [0] https://github.com/amhndu/SimpleNES
+// [1] https://www.nesdev.org/6502_cpu.txt
@@ -10,6 +10,39 @@ static void ConnectBus (void* vdev, void* vbus)
 }
 
 
+// claims the address range for the handlers (invoked with the context), the bus dispatches
+// the range to them once the device is connected to it
+static bool claim (void* vdev,
+		   address_t const first,
+		   address_t const last,
+		   byte_t (*read) (void*, const address_t),
+		   void (*write) (void*, const address_t, const byte_t),
+		   void* context)
+{
+  device_t* dev = vdev;
+  if (first > last || read == NULL || write == NULL)
+  {
+    printf("Device::claim() expects an address range and its read and write handlers\n");
+    return false;
+  }
+
+  if (dev -> countRanges == NES_DEVICE_RANGES)
+  {
+    printf("Device::claim() no room for more address ranges!\n");
+    return false;
+  }
+
+  deviceRange_t* range = &dev -> ranges[dev -> countRanges];
+  range -> first = first;
+  range -> last = last;
+  range -> read = read;
+  range -> write = write;
+  range -> context = context;
+  ++dev -> countRanges;
+  return true;
+}
+
+
 static device_t* create ()
 {
   device_t* dev = malloc( sizeof(device_t) );
@@ -19,7 +52,10 @@ static device_t* create ()
     return dev;
   }
 
+  dev -> vbus = NULL;
+  dev -> countRanges = 0;
   dev -> ConnectBus = ConnectBus;
+  dev -> claim = claim;
 
   return dev;
 }
@@ -53,6 +89,8 @@ device_namespace_t const device = {
 //
 // Synopsis:
 // Implements the methods of the device type.
+// The device only records the address ranges it claims, the bus resolves them into its
+// dispatch table at connect time.
 // Ports SimpleNES (reference [0]) to clang for learning purposes.
 //
 // Copyright (c) 2023 Misael Diaz-Maldonado
@@ -0,0 +1,512 @@
+#include <string.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "fingerprint.h"
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define NES_FINGERPRINT_X86 1
+#include <immintrin.h>
+#endif
+
+
+static uint32_t table_crc32[256];
+static bool has_CLMUL = false;				// PCLMULQDQ + SSE4.1
+static bool has_SHA = false;				// SHA extensions + SSSE3
+static pthread_once_t once = PTHREAD_ONCE_INIT;
+
+
+static void setup (void)
+{
+  // table of the (reflected) IEEE 802.3 polynomial used by zip, No-Intro, etc.
+  for (uint32_t i = 0; i != 256; ++i)
+  {
+    uint32_t c = i;
+    for (int k = 0; k != 8; ++k)
+    {
+      c = (c & 1)? (0xedb88320 ^ (c >> 1)) : (c >> 1);
+    }
+    table_crc32[i] = c;
+  }
+
+#if defined(NES_FINGERPRINT_X86)
+  __builtin_cpu_init();
+  has_CLMUL = (__builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1"));
+  has_SHA = (__builtin_cpu_supports("sha") && __builtin_cpu_supports("ssse3"));
+#endif
+}
+
+
+static uint32_t crc32_scalar (uint32_t crc, const byte_t* bytes, size_t const size)
+{
+  for (size_t i = 0; i != size; ++i)
+  {
+    crc = table_crc32[(crc ^ bytes[i]) & 0xff] ^ (crc >> 8);
+  }
+  return crc;
+}
+
+
+#if defined(NES_FINGERPRINT_X86)
+// folds 64 bytes per iteration with carry-less multiplications (ref[1], ref[2]);
+// expects at least 64 bytes and a size that is a multiple of 16
+__attribute__((target("pclmul,sse4.1")))
+static uint32_t crc32_clmul (uint32_t crc, const byte_t* bytes, size_t size)
+{
+  const __m128i k1k2 = _mm_set_epi64x(0x01c6e41596, 0x0154442bd4);
+  const __m128i k3k4 = _mm_set_epi64x(0x00ccaa009e, 0x01751997d0);
+  const __m128i k5k0 = _mm_set_epi64x(0x0000000000, 0x0163cd6124);
+  const __m128i poly = _mm_set_epi64x(0x01f7011641, 0x01db710641);
+  const __m128i mask = _mm_setr_epi32(~0, 0, ~0, 0);
+
+  __m128i x1 = _mm_loadu_si128( (const __m128i*) (bytes + 0x00) );
+  __m128i x2 = _mm_loadu_si128( (const __m128i*) (bytes + 0x10) );
+  __m128i x3 = _mm_loadu_si128( (const __m128i*) (bytes + 0x20) );
+  __m128i x4 = _mm_loadu_si128( (const __m128i*) (bytes + 0x30) );
+  x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(crc));
+  bytes += 64;
+  size -= 64;
+
+  while (size >= 64)
+  {
+    __m128i const x5 = _mm_clmulepi64_si128(x1, k1k2, 0x00);
+    __m128i const x6 = _mm_clmulepi64_si128(x2, k1k2, 0x00);
+    __m128i const x7 = _mm_clmulepi64_si128(x3, k1k2, 0x00);
+    __m128i const x8 = _mm_clmulepi64_si128(x4, k1k2, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k1k2, 0x11);
+    x2 = _mm_clmulepi64_si128(x2, k1k2, 0x11);
+    x3 = _mm_clmulepi64_si128(x3, k1k2, 0x11);
+    x4 = _mm_clmulepi64_si128(x4, k1k2, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x5),
+		       _mm_loadu_si128( (const __m128i*) (bytes + 0x00) ));
+    x2 = _mm_xor_si128(_mm_xor_si128(x2, x6),
+		       _mm_loadu_si128( (const __m128i*) (bytes + 0x10) ));
+    x3 = _mm_xor_si128(_mm_xor_si128(x3, x7),
+		       _mm_loadu_si128( (const __m128i*) (bytes + 0x20) ));
+    x4 = _mm_xor_si128(_mm_xor_si128(x4, x8),
+		       _mm_loadu_si128( (const __m128i*) (bytes + 0x30) ));
+    bytes += 64;
+    size -= 64;
+  }
+
+  // folds into 128 bits:
+  __m128i x5;
+  x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+  x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+  x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+  x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+  x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+  x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+  x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+  x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+  x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+  while (size >= 16)
+  {
+    x2 = _mm_loadu_si128( (const __m128i*) bytes );
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+    bytes += 16;
+    size -= 16;
+  }
+
+  // folds 128 bits into 64 bits:
+  x2 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+  x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+  x2 = _mm_srli_si128(x1, 4);
+  x1 = _mm_and_si128(x1, mask);
+  x1 = _mm_clmulepi64_si128(x1, k5k0, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+
+  // Barrett reduction into 32 bits:
+  x2 = _mm_and_si128(x1, mask);
+  x2 = _mm_clmulepi64_si128(x2, poly, 0x10);
+  x2 = _mm_and_si128(x2, mask);
+  x2 = _mm_clmulepi64_si128(x2, poly, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+
+  return _mm_extract_epi32(x1, 1);
+}
+
+
+// four rounds of SHA-1 with the message schedule of the next rounds (ref[3])
+#define NES_SHA1_ROUNDS(E_CUR, E_NXT, M0, M1, M2, M3, FUNC)	\
+  E_CUR = _mm_sha1nexte_epu32(E_CUR, M0);			\
+  E_NXT = abcd;							\
+  M1 = _mm_sha1msg2_epu32(M1, M0);				\
+  abcd = _mm_sha1rnds4_epu32(abcd, E_CUR, FUNC);		\
+  M3 = _mm_sha1msg1_epu32(M3, M0);				\
+  M2 = _mm_xor_si128(M2, M0);
+
+
+__attribute__((target("sha,ssse3,sse4.1")))
+static void sha1_ni (uint32_t* state, const byte_t* bytes, size_t blocks)
+{
+  const __m128i shuffle = _mm_set_epi64x(0x0001020304050607, 0x08090a0b0c0d0e0f);
+  __m128i abcd = _mm_shuffle_epi32(_mm_loadu_si128( (const __m128i*) state ), 0x1b);
+  __m128i e0 = _mm_set_epi32(state[4], 0, 0, 0);
+  __m128i e1;
+
+  for (; blocks != 0; --blocks, bytes += 64)
+  {
+    __m128i const abcd_save = abcd;
+    __m128i const e0_save = e0;
+
+    __m128i m0 = _mm_shuffle_epi8(_mm_loadu_si128( (const __m128i*) (bytes + 0x00) ),
+				  shuffle);
+    __m128i m1 = _mm_shuffle_epi8(_mm_loadu_si128( (const __m128i*) (bytes + 0x10) ),
+				  shuffle);
+    __m128i m2 = _mm_shuffle_epi8(_mm_loadu_si128( (const __m128i*) (bytes + 0x20) ),
+				  shuffle);
+    __m128i m3 = _mm_shuffle_epi8(_mm_loadu_si128( (const __m128i*) (bytes + 0x30) ),
+				  shuffle);
+
+    // rounds 0-15 (the message schedule is still being loaded):
+    e0 = _mm_add_epi32(e0, m0);
+    e1 = abcd;
+    abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+
+    e1 = _mm_sha1nexte_epu32(e1, m1);
+    e0 = abcd;
+    abcd = _mm_sha1rnds4_epu32(abcd, e1, 0);
+    m0 = _mm_sha1msg1_epu32(m0, m1);
+
+    e0 = _mm_sha1nexte_epu32(e0, m2);
+    e1 = abcd;
+    abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+    m1 = _mm_sha1msg1_epu32(m1, m2);
+    m0 = _mm_xor_si128(m0, m2);
+
+    NES_SHA1_ROUNDS(e1, e0, m3, m0, m1, m2, 0);
+
+    // rounds 16-63:
+    NES_SHA1_ROUNDS(e0, e1, m0, m1, m2, m3, 0);
+    NES_SHA1_ROUNDS(e1, e0, m1, m2, m3, m0, 1);
+    NES_SHA1_ROUNDS(e0, e1, m2, m3, m0, m1, 1);
+    NES_SHA1_ROUNDS(e1, e0, m3, m0, m1, m2, 1);
+    NES_SHA1_ROUNDS(e0, e1, m0, m1, m2, m3, 1);
+    NES_SHA1_ROUNDS(e1, e0, m1, m2, m3, m0, 1);
+    NES_SHA1_ROUNDS(e0, e1, m2, m3, m0, m1, 2);
+    NES_SHA1_ROUNDS(e1, e0, m3, m0, m1, m2, 2);
+    NES_SHA1_ROUNDS(e0, e1, m0, m1, m2, m3, 2);
+    NES_SHA1_ROUNDS(e1, e0, m1, m2, m3, m0, 2);
+    NES_SHA1_ROUNDS(e0, e1, m2, m3, m0, m1, 2);
+    NES_SHA1_ROUNDS(e1, e0, m3, m0, m1, m2, 3);
+    NES_SHA1_ROUNDS(e0, e1, m0, m1, m2, m3, 3);
+    NES_SHA1_ROUNDS(e1, e0, m1, m2, m3, m0, 3);
+    NES_SHA1_ROUNDS(e0, e1, m2, m3, m0, m1, 3);
+
+    // rounds 76-79:
+    e1 = _mm_sha1nexte_epu32(e1, m3);
+    e0 = abcd;
+    abcd = _mm_sha1rnds4_epu32(abcd, e1, 3);
+
+    e0 = _mm_sha1nexte_epu32(e0, e0_save);
+    abcd = _mm_add_epi32(abcd, abcd_save);
+  }
+
+  _mm_storeu_si128( (__m128i*) state, _mm_shuffle_epi32(abcd, 0x1b) );
+  state[4] = _mm_extract_epi32(e0, 3);
+}
+
+#undef NES_SHA1_ROUNDS
+#endif
+
+
+static uint32_t crc32 (uint32_t crc, const byte_t* bytes, size_t const size)
+{
+#if defined(NES_FINGERPRINT_X86)
+  if (has_CLMUL && size >= 64)
+  {
+    size_t const size_folded = (size & ~( (size_t) 0x0f ));
+    crc = crc32_clmul(crc, bytes, size_folded);
+    crc = crc32_scalar(crc, bytes + size_folded, size - size_folded);
+    return crc;
+  }
+#endif
+  return crc32_scalar(crc, bytes, size);
+}
+
+
+static uint32_t rol (uint32_t const x, int const n)
+{
+  return ( (x << n) | (x >> (32 - n)) );
+}
+
+
+static void sha1_scalar (uint32_t* state, const byte_t* bytes, size_t blocks)	// ref[4]
+{
+  for (; blocks != 0; --blocks, bytes += 64)
+  {
+    uint32_t w[80];
+    for (int i = 0; i != 16; ++i)
+    {
+      const byte_t* b = (bytes + 4 * i);
+      w[i] = ( ( (uint32_t) b[0] << 24 ) | ( (uint32_t) b[1] << 16 ) |
+	       ( (uint32_t) b[2] << 8 ) | ( (uint32_t) b[3] ) );
+    }
+
+    for (int i = 16; i != 80; ++i)
+    {
+      w[i] = rol(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+    }
+
+    uint32_t a = state[0];
+    uint32_t b = state[1];
+    uint32_t c = state[2];
+    uint32_t d = state[3];
+    uint32_t e = state[4];
+    for (int i = 0; i != 80; ++i)
+    {
+      uint32_t f, k;
+      if (i < 20)
+      {
+	f = ( (b & c) | (~b & d) );
+	k = 0x5a827999;
+      }
+      else if (i < 40)
+      {
+	f = (b ^ c ^ d);
+	k = 0x6ed9eba1;
+      }
+      else if (i < 60)
+      {
+	f = ( (b & c) | (b & d) | (c & d) );
+	k = 0x8f1bbcdc;
+      }
+      else
+      {
+	f = (b ^ c ^ d);
+	k = 0xca62c1d6;
+      }
+
+      uint32_t const t = rol(a, 5) + f + e + k + w[i];
+      e = d;
+      d = c;
+      c = rol(b, 30);
+      b = a;
+      a = t;
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+  }
+}
+
+
+static void sha1 (uint32_t* state, const byte_t* bytes, size_t const blocks)
+{
+#if defined(NES_FINGERPRINT_X86)
+  if (has_SHA)
+  {
+    sha1_ni(state, bytes, blocks);
+    return;
+  }
+#endif
+  sha1_scalar(state, bytes, blocks);
+}
+
+
+static uint32_t gf2_times (const uint32_t* mat, uint32_t vec)
+{
+  uint32_t sum = 0;
+  for (; vec != 0; vec >>= 1, ++mat)
+  {
+    if (vec & 1)
+    {
+      sum ^= *mat;
+    }
+  }
+  return sum;
+}
+
+
+static void gf2_square (uint32_t* square, const uint32_t* mat)
+{
+  for (int n = 0; n != 32; ++n)
+  {
+    square[n] = gf2_times(mat, mat[n]);
+  }
+}
+
+
+// CRC32 of the concatenation of two messages out of their CRC32s (ref[5])
+static uint32_t crc32_combine (uint32_t crc1, uint32_t const crc2, uint64_t size2)
+{
+  if (size2 == 0)
+  {
+    return crc1;
+  }
+
+  uint32_t even[32];
+  uint32_t odd[32];
+  odd[0] = 0xedb88320;
+  uint32_t row = 1;
+  for (int n = 1; n != 32; ++n)
+  {
+    odd[n] = row;
+    row <<= 1;
+  }
+
+  gf2_square(even, odd);
+  gf2_square(odd, even);
+  do
+  {
+    gf2_square(even, odd);
+    if (size2 & 1)
+    {
+      crc1 = gf2_times(even, crc1);
+    }
+    size2 >>= 1;
+    if (size2 == 0)
+    {
+      break;
+    }
+
+    gf2_square(odd, even);
+    if (size2 & 1)
+    {
+      crc1 = gf2_times(odd, crc1);
+    }
+    size2 >>= 1;
+  } while (size2 != 0);
+
+  return (crc1 ^ crc2);
+}
+
+
+static void init (fingerprint_t* fp)
+{
+  pthread_once(&once, setup);
+  fp -> size = 0;
+  fp -> size_section = 0;
+  fp -> crc = 0xffffffff;
+  fp -> crc_total = 0;
+  fp -> sha1[0] = 0x67452301;
+  fp -> sha1[1] = 0xefcdab89;
+  fp -> sha1[2] = 0x98badcfe;
+  fp -> sha1[3] = 0x10325476;
+  fp -> sha1[4] = 0xc3d2e1f0;
+  fp -> fill = 0;
+}
+
+
+// fingerprints the bytes that just streamed in (while they are still in the cache)
+static void update (fingerprint_t* fp, const byte_t* bytes, size_t size)
+{
+  fp -> crc = crc32(fp -> crc, bytes, size);
+  fp -> size += size;
+  fp -> size_section += size;
+
+  if (fp -> fill != 0)
+  {
+    size_t const count = (64 - fp -> fill < size)? (64 - fp -> fill) : size;
+    memcpy(fp -> block + fp -> fill, bytes, count);
+    fp -> fill += count;
+    bytes += count;
+    size -= count;
+    if (fp -> fill != 64)
+    {
+      return;
+    }
+
+    sha1(fp -> sha1, fp -> block, 1);
+    fp -> fill = 0;
+  }
+
+  size_t const blocks = (size / 64);
+  sha1(fp -> sha1, bytes, blocks);
+  bytes += (64 * blocks);
+  size -= (64 * blocks);
+
+  memcpy(fp -> block, bytes, size);
+  fp -> fill = size;
+}
+
+
+// ends the current section (PRG-ROM, CHR-ROM, ...) returning its CRC32
+static uint32_t section (fingerprint_t* fp)
+{
+  uint32_t const crc = ~(fp -> crc);
+  fp -> crc_total = crc32_combine(fp -> crc_total, crc, fp -> size_section);
+  fp -> crc = 0xffffffff;
+  fp -> size_section = 0;
+  return crc;
+}
+
+
+// yields the CRC32 and the SHA-1 (20 bytes) of all the bytes fingerprinted
+static void final (fingerprint_t* fp, uint32_t* crc, byte_t* digest)
+{
+  section(fp);
+  *crc = fp -> crc_total;
+
+  uint64_t const bits = (8 * fp -> size);
+  byte_t pad[128];
+  size_t const size_pad = (fp -> fill < 56)? (64 - fp -> fill) : (128 - fp -> fill);
+  memset(pad, 0, sizeof(pad));
+  pad[0] = 0x80;
+  for (int i = 0; i != 8; ++i)
+  {
+    pad[size_pad - 1 - i] = (byte_t) (bits >> (8 * i));
+  }
+
+  memcpy(fp -> block + fp -> fill, pad, 64 - fp -> fill);
+  sha1(fp -> sha1, fp -> block, 1);
+  if (size_pad > 64)
+  {
+    sha1(fp -> sha1, pad + (64 - fp -> fill), 1);
+  }
+  fp -> fill = 0;
+
+  for (int i = 0; i != 5; ++i)
+  {
+    uint32_t const h = fp -> sha1[i];
+    digest[4 * i + 0] = (byte_t) (h >> 24);
+    digest[4 * i + 1] = (byte_t) (h >> 16);
+    digest[4 * i + 2] = (byte_t) (h >> 8);
+    digest[4 * i + 3] = (byte_t) (h);
+  }
+}
+
+
+fingerprint_namespace_t const fingerprint = {
+  .init = init,
+  .update = update,
+  .section = section,
+  .final = final
+};
+
+
+// NES Emulation					October 18, 2026
+//
+//			Academic Purpose
+//
+// source: fingerprint.c
+// author: @misael-diaz
+//
+// Synopsis:
+// Implements the methods of the fingerprint object.
+// Computes the CRC32 and SHA-1 of a ROM while its bytes stream in. Uses carry-less
+// multiplication (PCLMULQDQ) to fold the CRC32 and the SHA extensions for SHA-1 when
+// the processor supports them, falls back to portable code otherwise.
+//
+// NOTE: the SSE4.2 crc32 instruction computes the CRC32C (Castagnoli) polynomial which
+// does not match the CRC32 of the ROM databases, that is why we fold with PCLMULQDQ.
+//
+// Copyright (c) 2023 Misael Diaz-Maldonado
+// This file is released under the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// References:
+// [0] https://github.com/amhndu/SimpleNES
+// [1] V. Gopal et al., Fast CRC Computation for Generic Polynomials Using PCLMULQDQ
+//     Instruction, Intel (2009)
+// [2] https://chromium.googlesource.com/chromium/src/third_party/zlib/+/HEAD/crc32_simd.c
+// [3] https://www.intel.com/content/www/us/en/developer/articles/technical/intel-sha-extensions.html
+// [4] https://doi.org/10.6028/NIST.FIPS.180-4
+// [5] https://github.com/madler/zlib/blob/master/crc32.c
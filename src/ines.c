@@ -0,0 +1,241 @@
+#include <stdint.h>
+#include "ines.h"
+
+
+static bool isValid (const byte_t* header)
+{
+  bool const isValidMagic = (header[0] == 'N' &&
+			     header[1] == 'E' &&
+			     header[2] == 'S' &&
+			     header[3] == 0x1a);
+  return isValidMagic;
+}
+
+
+// NES 2.0 headers set bits 3 (clear bit 2) of flags 7 (ref[6])
+static bool isNES20 (const byte_t* header)
+{
+  bool const isNES20Header = ( (header[7] & 0x0c) == 0x08 );
+  return isNES20Header;
+}
+
+
+static bool hasTrainer (const byte_t* header)			// ref[2]
+{
+  byte_t const isTrainerBitSet = (header[6] & 0x04);
+  return (isTrainerBitSet)? true : false;
+}
+
+
+// NES 2.0 ROM size given the LSB and the MSB nybble of the number of banks (ref[7]),
+// yields SIZE_MAX for (exponent-multiplier) sizes that cannot be addressed
+static size_t getSizeNES20 (byte_t const lsb, byte_t const msb, size_t const size_bank)
+{
+  if (msb != 0x0f)
+  {
+    size_t const banks = ( ( (size_t) msb << 8 ) | lsb );
+    return (size_bank * banks);
+  }
+
+  size_t const exponent = (lsb >> 2);
+  size_t const multiplier = ( 2 * (lsb & 0x03) + 1 );
+  if (exponent >= 8 * sizeof(size_t) - 3)
+  {
+    return SIZE_MAX;
+  }
+
+  return ( ( (size_t) 1 << exponent ) * multiplier );
+}
+
+
+static size_t getSizeROM (const byte_t* header)			// ref[1]
+{
+  if (isNES20(header))
+  {
+    return getSizeNES20(header[4], header[9] & 0x0f, 0x4000);
+  }
+
+  byte_t const banks = header[4];
+  size_t const size = (0x4000 * banks);
+  return size;
+}
+
+
+static size_t getSizeVROM (const byte_t* header)		// ref[1]
+{
+  if (isNES20(header))
+  {
+    return getSizeNES20(header[5], (header[9] >> 4) & 0x0f, 0x2000);
+  }
+
+  byte_t const vbanks = header[5];
+  size_t const size = (0x2000 * vbanks);
+  return size;
+}
+
+
+// NES 2.0 RAM sizes are shift counts, 64 << count bytes (zero means none) ref[8]
+static size_t getSizeShift (byte_t const count)
+{
+  return (count)? ( (size_t) 64 << count ) : 0;
+}
+
+
+// PRG-RAM size (volatile and non-volatile), iNES 1.0 ROMs do not tell
+static size_t getSizePRGRAM (const byte_t* header)
+{
+  if (!isNES20(header))
+  {
+    return 0;
+  }
+
+  size_t const size = ( getSizeShift(header[10] & 0x0f) +
+			getSizeShift( (header[10] >> 4) & 0x0f ) );
+  return size;
+}
+
+
+// CHR-RAM size (volatile and non-volatile), iNES 1.0 ROMs without CHR-ROM have 8KB
+static size_t getSizeCHRRAM (const byte_t* header)
+{
+  if (!isNES20(header))
+  {
+    return (header[5] == 0)? 0x2000 : 0;
+  }
+
+  size_t const size = ( getSizeShift(header[11] & 0x0f) +
+			getSizeShift( (header[11] >> 4) & 0x0f ) );
+  return size;
+}
+
+
+static nameTableMirroring_t getNameTableMirroring (const byte_t* header)	// ref[2]
+{
+  byte_t const isFourScreenMirroringEnabled = (header[6] & 0x08);
+  if (isFourScreenMirroringEnabled)
+  {
+    return FourScreen;
+  }
+
+  byte_t const isVerticalMirroringEnabled = (header[6] & 0x01);
+  return (isVerticalMirroringEnabled)? Vertical : Horizontal;
+}
+
+
+static uint16_t getMapperNumber (const byte_t* header)
+{
+  byte_t const lowerMapperNumberNybble = ( (header[6] >> 4) & 0x0f );	// ref[2]
+  byte_t const upperMapperNumberNybble = (header[7] & 0xf0);		// ref[3]
+  uint16_t m_mapperNumber = (upperMapperNumberNybble | lowerMapperNumberNybble);
+  if (isNES20(header))
+  {
+    uint16_t const highestMapperNumberNybble = (header[8] & 0x0f);	// ref[6]
+    m_mapperNumber |= (highestMapperNumberNybble << 8);
+  }
+  return m_mapperNumber;
+}
+
+
+static byte_t getSubmapperNumber (const byte_t* header)			// ref[6]
+{
+  return (isNES20(header))? ( (header[8] >> 4) & 0x0f ) : 0;
+}
+
+
+static bool hasExtendedRAM (const byte_t* header)
+{
+  byte_t const isExtendedRAMBitSet = (header[6] & 0x02); 		// ref[2]
+  return (isExtendedRAMBitSet)? true : false;
+}
+
+
+// official specification
+static tvSystem_t getTVSystemOfficial (const byte_t* header)
+{
+  byte_t const isPALEnabled = (header[0x09] & 0x01);			// ref[4]
+  return (isPALEnabled)? PAL : NTSC;
+}
+
+
+// unofficial specification (few emulators use it, see ref[5])
+static tvSystem_t getTVSystemUnofficial (const byte_t* header)
+{
+  byte_t const byte = (header[0x0a] & 0x03);				// ref[5]
+  switch (byte)
+  {
+    case 0:
+      return NTSC;
+    case 2:
+      return PAL;
+    default:
+      return MultipleRegion;
+  }
+}
+
+
+// the official specification wins, the unofficial one can only tell us about PAL;
+// NES 2.0 ROMs state the CPU/PPU timing instead (ref[9])
+static tvSystem_t getTVSystem (const byte_t* header)
+{
+  if (isNES20(header))
+  {
+    tvSystem_t const timing = (header[12] & 0x03);
+    return timing;
+  }
+
+  tvSystem_t const official = getTVSystemOfficial(header);
+  if (official == PAL)
+  {
+    return official;
+  }
+
+  tvSystem_t const unofficial = getTVSystemUnofficial(header);
+  return unofficial;
+}
+
+
+ines_namespace_t const ines = {
+  .isValid = isValid,
+  .isNES20 = isNES20,
+  .hasTrainer = hasTrainer,
+  .getSizeROM = getSizeROM,
+  .getSizeVROM = getSizeVROM,
+  .getSizePRGRAM = getSizePRGRAM,
+  .getSizeCHRRAM = getSizeCHRRAM,
+  .getNameTableMirroring = getNameTableMirroring,
+  .getMapperNumber = getMapperNumber,
+  .getSubmapperNumber = getSubmapperNumber,
+  .hasExtendedRAM = hasExtendedRAM,
+  .getTVSystemOfficial = getTVSystemOfficial,
+  .getTVSystemUnofficial = getTVSystemUnofficial,
+  .getTVSystem = getTVSystem
+};
+
+
+// NES Emulation					October 18, 2026
+//
+//			Academic Purpose
+//
+// source: ines.c
+// author: @misael-diaz
+//
+// Synopsis:
+// Implements the methods that decode the iNES (and NES 2.0) header.
+// Ports SimpleNES (reference [0]) to clang for learning purposes.
+//
+// Copyright (c) 2023 Misael Diaz-Maldonado
+// This file is released under the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// References:
+// [0] https://github.com/amhndu/SimpleNES
+// [1] https://www.nesdev.org/wiki/INES
+// [2] https://www.nesdev.org/wiki/INES#Flags_6
+// [3] https://www.nesdev.org/wiki/INES#Flags_7
+// [4] https://www.nesdev.org/wiki/INES#Flags_9
+// [5] https://www.nesdev.org/wiki/INES#Flags_10
+// [6] https://www.nesdev.org/wiki/NES_2.0#Header
+// [7] https://www.nesdev.org/wiki/NES_2.0#PRG-ROM_Area
+// [8] https://www.nesdev.org/wiki/NES_2.0#PRG-(NV)RAM/EEPROM
+// [9] https://www.nesdev.org/wiki/NES_2.0#CPU/PPU_Timing
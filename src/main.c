@@ -19,40 +19,186 @@
 // [1] https://www.howtogeek.com/428987/whats-the-difference-between-ntsc-and-pal/
 
 #include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+#include <zlib.h>
+#include <unistd.h>
+#include <utime.h>
+#include <sys/stat.h>
 
+#include "nes.h"
 #include "cpu.h"
+#include "cpuBatch.h"
 #include "cartridge.h"
+#include "catalog.h"
+#include "fingerprint.h"
+#include "ines.h"
 #include "mapperAxROM.h"
 #include "mapperCNROM.h"
+#include "mapperData.h"
 
 #define SUCCESS ( (int) 0x00000000 )
 #define FAILURE ( (int) 0xffffffff )
 
 // using (temporarily) the core mapper protected data for testing the mapper AxROM:
-typedef struct
-{
-  cartridge_t* m_cartridge;
-  mapperKind_t m_kind;
-  void* next;
-} data_t;
+typedef mapperData_t data_t;
 
+extern nes_namespace_t const nes;
 extern cpu_namespace_t const cpu;
+extern cpuBatch_namespace_t const cpuBatch;
 extern bus_namespace_t const bus;
 extern device_namespace_t const device;
 extern cartridge_namespace_t const cartridge;
+extern catalog_namespace_t const catalog;
+extern fingerprint_namespace_t const fingerprint;
+extern ines_namespace_t const ines;
+extern mapper_namespace_t const mapper;
 extern mapperAxROM_namespace_t const mapperAxROM;
 extern mapperCNROM_namespace_t const mapperCNROM;
 
+// copy-add loop over a 256-byte buffer (in RAM, so that the code may be recompiled):
+static const byte_t copyProgram[] = {
+  0xa2, 0x00,			// $0600: LDX #$00
+  0xbd, 0x00, 0x02,		// $0602: LDA $0200,X
+  0x18,				// $0605: CLC
+  0x69, 0x03,			// $0606: ADC #$03
+  0x9d, 0x00, 0x03,		// $0608: STA $0300,X
+  0xa4, 0x10,			// $060B: LDY $10
+  0xc8,				// $060D: INY
+  0x84, 0x10,			// $060E: STY $10
+  0xe8,				// $0610: INX
+  0xd0, 0xef,			// $0611: BNE $0602
+  0x4c, 0x00, 0x06		// $0613: JMP $0600
+};
+
+// multiplies the bytes at $10 and $11 (the product goes to A and $12):
+static const byte_t multiplyProgram[] = {
+  0xa9, 0x00,			// $0600: LDA #$00
+  0xa2, 0x08,			// $0602: LDX #$08
+  0x46, 0x10,			// $0604: LSR $10
+  0x90, 0x03,			// $0606: BCC $060B
+  0x18,				// $0608: CLC
+  0x65, 0x11,			// $0609: ADC $11
+  0x6a,				// $060B: ROR A
+  0x66, 0x12,			// $060C: ROR $12
+  0xca,				// $060E: DEX
+  0xd0, 0xf3,			// $060F: BNE $0604
+  0xe6, 0x10,			// $0611: INC $10
+  0xc9, 0x80,			// $0613: CMP #$80
+  0x24, 0x11,			// $0615: BIT $11
+  0x4c, 0x00, 0x06		// $0617: JMP $0600
+};
+
+// calls a subroutine and loops (the stack starts at $01FF):
+static const byte_t subroutineProgram[] = {
+  0x20, 0x06, 0x06,		// $0600: JSR $0606
+  0x4c, 0x03, 0x06,		// $0603: JMP $0603
+  0x60				// $0606: RTS
+};
+
+// rewrites its own code: the loop at $060E stores through the pointers of the zero page
+// (which point to $0000) until it is hot enough to run natively, and then through the last
+// one, which points to the operand of the LDA at $0600:
+static const byte_t selfModifyingProgram[] = {
+  0xa9, 0x00,			// $0600: LDA #$00
+  0x85, 0x12,			// $0602: STA $12
+  0xa9, 0x01,			// $0604: LDA #$01
+  0x85, 0x70,			// $0606: STA $70
+  0xa9, 0x06,			// $0608: LDA #$06
+  0x85, 0x71,			// $060A: STA $71
+  0xa2, 0x00,			// $060C: LDX #$00
+  0xa5, 0x11,			// $060E: LDA $11
+  0x81, 0x20,			// $0610: STA ($20,X)
+  0xe8,				// $0612: INX
+  0xe8,				// $0613: INX
+  0xe0, 0x52,			// $0614: CPX #$52
+  0xd0, 0xf6,			// $0616: BNE $060E
+  0xe6, 0x11,			// $0618: INC $11
+  0x4c, 0x00, 0x06		// $061A: JMP $0600
+};
+
+// switches the 32KB PRG-ROM bank (AxROM) by the parity of X and then loads the byte
+// following the switch (which differs by bank) into the sums stored at $0200,X:
+static const byte_t bankSwitchProgram[] = {
+  0xa2, 0x00,			// $8000: LDX #$00
+  0x8a,				// $8002: TXA
+  0x29, 0x01,			// $8003: AND #$01
+  0x8d, 0x00, 0x80,		// $8005: STA $8000
+  0xa9, 0x00,			// $8008: LDA #(bank)
+  0x18,				// $800A: CLC
+  0x65, 0x10,			// $800B: ADC $10
+  0x85, 0x10,			// $800D: STA $10
+  0x9d, 0x00, 0x02,		// $800F: STA $0200,X
+  0xe8,				// $8012: INX
+  0x4c, 0x02, 0x80		// $8013: JMP $8002
+};
+
 void mirroringCallBack();
 int test_mapperAxROM();
 int test_mapperCNROM();
 void tests();
+void bench(cpu_t* CPU);
+void benchEngine(cpuEngine_t engine);
+void benchFlags();
+void benchBatch();
+int checkEngines();
+int checkRecompiler();
+int checkBatch();
+int checkWatches();
+int checkROMs();
+int checkArchives();
+int checkDevices();
+int checkCatalog();
+int checkFingerprint();
+int checkHeaders();
+int play(const char* path, size_t frames, cpuEngine_t engine, bool skipsIdle);
 
-int main ()
+int main (int argc, char* argv[])
 {
+  if (argc >= 3 && strcmp(argv[1], "run") == 0)
+  {
+    size_t const frames = (argc >= 4)? strtoul(argv[3], NULL, 10) : 60;
+    cpuEngine_t engine = InterpreterEngine;
+    bool skipsIdle = true;
+    for (int i = 4; i < argc; ++i)
+    {
+      engine = (strcmp(argv[i], "recompiler") == 0)? RecompilerEngine : engine;
+      engine = (strcmp(argv[i], "accurate") == 0)? AccurateEngine : engine;
+      skipsIdle = skipsIdle && (strcmp(argv[i], "noidle") != 0);
+    }
+
+    return play(argv[2], frames, engine, skipsIdle);
+  }
+
+  if (argc == 2 && strcmp(argv[1], "check") == 0)
+  {
+    int (*checks[]) () = {
+      checkEngines, checkRecompiler, checkBatch, checkWatches, checkROMs, checkArchives,
+      checkDevices, checkCatalog, checkFingerprint, checkHeaders
+    };
+    int stat = SUCCESS;
+    for (size_t i = 0; i != sizeof(checks) / sizeof(checks[0]); ++i)
+    {
+      stat = (checks[i]() == SUCCESS)? stat : FAILURE;
+    }
+
+    return stat;
+  }
+
   device_t* devCPU = device.create();
   bus_t* Bus = bus.create(devCPU);
-  cpu_t* CPU = cpu.create(devCPU);
+  cpu_t* CPU = cpu.create(devCPU, InterpreterEngine);
+
+  if (argc == 2 && strcmp(argv[1], "bench") == 0)
+  {
+    bench(CPU);
+    benchEngine(InterpreterEngine);
+    benchEngine(RecompilerEngine);
+    benchEngine(AccurateEngine);
+    benchFlags();
+    benchBatch();
+  }
 
   devCPU = device.destroy(devCPU);
   Bus = bus.destroy(Bus);
@@ -75,6 +221,1538 @@ void tests ()
 }
 
 
+static double walltime ()
+{
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return ( (double) t.tv_sec + 1.0e-9 * ( (double) t.tv_nsec ) );
+}
+
+
+// loads the program at $0600 (in RAM) and resets the CPU to it (there is no cartridge to
+// hold the reset vector)
+static void load (cpu_t* CPU, const byte_t* program, size_t const size)
+{
+  for (size_t i = 0; i != size; ++i)
+  {
+    CPU -> write(CPU, 0x0600 + i, program[i]);
+  }
+
+  CPU -> reset(CPU);
+  CPU -> pc = 0x0600;
+}
+
+
+// loads the image of the work RAM (the program at $0600) and resets the CPU to $0600
+static void loadRAM (cpu_t* CPU, const byte_t* ram)
+{
+  for (size_t i = 0; i != 0x0600; ++i)
+  {
+    CPU -> write(CPU, i, ram[i]);
+  }
+
+  load(CPU, ram + 0x0600, NES_CPU_WORK_RAM - 0x0600);
+}
+
+
+// runs the fast engine and the accurate engine (which catches up with it instruction by
+// instruction) frame by frame, returns false if their states ever differ
+static bool compareEngines (cpu_t* fast, cpu_t* accurate, size_t const frames)
+{
+  size_t const budget = 29781;			// (one NTSC frame)
+  bool isSame = true;
+  for (size_t frame = 0; isSame && frame != frames; ++frame)
+  {
+    fast -> run(fast, budget);
+    while (accurate -> clock_count < fast -> clock_count)
+    {
+      accurate -> step(accurate);
+    }
+
+    isSame = (fast -> clock_count == accurate -> clock_count &&
+	      fast -> pc == accurate -> pc &&
+	      fast -> a == accurate -> a &&
+	      fast -> x == accurate -> x &&
+	      fast -> y == accurate -> y &&
+	      fast -> sp == accurate -> sp &&
+	      fast -> status == accurate -> status &&
+	      memcmp(fast -> ram, accurate -> ram, NES_CPU_WORK_RAM) == 0);
+  }
+
+  return isSame;
+}
+
+
+// runs the program with the fast engine and the accurate engine, returns false if their
+// states ever differ
+static bool checkEngine (const byte_t* program, size_t const size, cpuEngine_t const engine)
+{
+  device_t* devices[2] = { device.create(), device.create() };
+  bus_t* buses[2] = { bus.create(devices[0]), bus.create(devices[1]) };
+  cpu_t* fast = cpu.create(devices[0], engine);
+  cpu_t* accurate = cpu.create(devices[1], AccurateEngine);
+  bool isSame = (fast != NULL && accurate != NULL);
+  if (isSame)
+  {
+    load(fast, program, size);
+    load(accurate, program, size);
+    fast -> skipsIdle = false;
+    isSame = compareEngines(fast, accurate, 60);
+  }
+
+  for (size_t i = 0; i != 2; ++i)
+  {
+    devices[i] = device.destroy(devices[i]);
+    buses[i] = bus.destroy(buses[i]);
+  }
+
+  fast = cpu.destroy(fast);
+  accurate = cpu.destroy(accurate);
+  return isSame;
+}
+
+
+// (the AxROM mapper switches the name table mirroring silently)
+static void mirroringQuiet ()
+{
+}
+
+
+// runs the bank-switch program out of the PRG-ROM (two 32KB banks of AxROM) with the fast
+// engine and the accurate engine, returns false if their states ever differ or if the byte
+// following a switch was not read from the bank just switched to
+static bool checkBankSwitch (cpuEngine_t const engine)
+{
+  size_t const sizeBank = 0x8000;
+  size_t const size = 16 + 2 * sizeBank;
+  byte_t* image = calloc(size, sizeof(byte_t));
+  if (image == NULL)
+  {
+    return false;
+  }
+
+  byte_t const header[16] = { 'N', 'E', 'S', 0x1a, 4, 0, 0x70 };
+  memcpy(image, header, 16);
+  byte_t const constants[] = { 0x11, 0x35 };
+  for (size_t bank = 0; bank != 2; ++bank)
+  {
+    byte_t* prg = image + 16 + bank * sizeBank;
+    memcpy(prg, bankSwitchProgram, sizeof(bankSwitchProgram));
+    prg[0x0009] = constants[bank];
+    prg[0x7ffc] = 0x00;				// (reset vector)
+    prg[0x7ffd] = 0x80;
+  }
+
+  cartridge_t* c = cartridge.create();
+  bool isSame = (c != NULL && c -> loadFromMemory(c, image, size));
+  free(image);
+
+  mapper_t* mappers[2] = { NULL, NULL };
+  device_t* devices[2] = { device.create(), device.create() };
+  bus_t* buses[2] = { bus.create(devices[0]), bus.create(devices[1]) };
+  cpu_t* fast = cpu.create(devices[0], engine);
+  cpu_t* accurate = cpu.create(devices[1], AccurateEngine);
+  isSame = isSame && (fast != NULL && accurate != NULL);
+  for (size_t i = 0; isSame && i != 2; ++i)
+  {
+    mappers[i] = mapperAxROM.create(c, mirroringQuiet);
+    isSame = (mappers[i] != NULL);
+    if (isSame)
+    {
+      buses[i] -> ConnectMapper(buses[i], mappers[i]);
+    }
+  }
+
+  if (isSame)
+  {
+    fast -> reset(fast);
+    accurate -> reset(accurate);
+    fast -> skipsIdle = false;
+    isSame = compareEngines(fast, accurate, 10) &&
+	     (byte_t) (fast -> ram[0x0201] - fast -> ram[0x0200]) == constants[1] &&
+	     (byte_t) (fast -> ram[0x0202] - fast -> ram[0x0201]) == constants[0];
+  }
+
+  fast = cpu.destroy(fast);
+  accurate = cpu.destroy(accurate);
+  for (size_t i = 0; i != 2; ++i)
+  {
+    buses[i] = bus.destroy(buses[i]);
+    devices[i] = device.destroy(devices[i]);
+    if (mappers[i] != NULL)
+    {
+      mappers[i] = mapperAxROM.destroy(mappers[i]);
+    }
+  }
+
+  c = cartridge.destroy(c);
+  return isSame;
+}
+
+
+// validates the fast engines against the accurate engine on the same test programs
+int checkEngines ()
+{
+  const byte_t* programs[] = { copyProgram, multiplyProgram, selfModifyingProgram };
+  size_t const sizes[] = {
+    sizeof(copyProgram) / sizeof(byte_t),
+    sizeof(multiplyProgram) / sizeof(byte_t),
+    sizeof(selfModifyingProgram) / sizeof(byte_t)
+  };
+  const char* names[] = { "copy-add", "multiply", "self-modifying" };
+  cpuEngine_t const engines[] = { InterpreterEngine, RecompilerEngine };
+  const char* engineNames[] = { "interpreter", "recompiler" };
+
+  int stat = SUCCESS;
+  for (size_t i = 0; i != 3; ++i)
+  {
+    for (size_t j = 0; j != 2; ++j)
+    {
+      bool const isSame = checkEngine(programs[i], sizes[i], engines[j]);
+      printf("CPU engines: %s program, %s and accurate engines: %s\n",
+	     names[i], engineNames[j], (isSame)? "OK" : "FAILED");
+      stat = (isSame)? stat : FAILURE;
+    }
+  }
+
+  for (size_t j = 0; j != 2; ++j)
+  {
+    bool const isSame = checkBankSwitch(engines[j]);
+    printf("CPU engines: bank-switch program (AxROM), %s and accurate engines: %s\n",
+	   engineNames[j], (isSame)? "OK" : "FAILED");
+    stat = (isSame)? stat : FAILURE;
+  }
+
+  return stat;
+}
+
+
+// xorshift generator of the random programs
+static uint32_t random32 (uint32_t* state)
+{
+  uint32_t x = *state;
+  x ^= (x << 13);
+  x ^= (x >> 17);
+  x ^= (x << 5);
+  *state = x;
+  return x;
+}
+
+
+// true if the opcode may be generated in the body of a random program: no jumps, calls,
+// returns, or branches (placed by the generator) and nothing that halts or moves the stack
+static bool isRandomOpcode (byte_t const opcode, bool const isUnofficial)
+{
+  const instruction_t* instruction = cpu.decode(opcode);
+  byte_t const op = instruction -> op;
+  return (instruction -> mode != REL &&
+	  op != JMP && op != JSR && op != RTS && op != RTI && op != BRK && op != JAM &&
+	  op != TXS && (isUnofficial || op < ALR));
+}
+
+
+// generates a random program into the work RAM: a loop (at $0600) of random instructions
+// accessing the zero page, the stack, and the data at $0200 - $05FF (the code itself, too,
+// if self-modifying), forward branches, and calls of a subroutine at $07C0
+static void generate (byte_t* ram, uint32_t* state, bool const isSelfModifying)
+{
+  for (size_t i = 0; i != NES_CPU_WORK_RAM; ++i)
+  {
+    ram[i] = (byte_t) random32(state);
+  }
+
+  // the pointers of the zero page point to the data:
+  for (size_t i = 1; i < 0x100; i += 2)
+  {
+    ram[i] = (byte_t) (0x02 + random32(state) % 3);
+  }
+
+  size_t pc = 0x0600;
+  ram[pc++] = 0xa9;				// LDA #(iterations)
+  ram[pc++] = (byte_t) (20 + random32(state) % 40);
+  ram[pc++] = 0x85;				// STA $F0 (the loop counter)
+  ram[pc++] = 0xf0;
+  size_t const loop = pc;
+  for (size_t i = 0; i != 40; ++i)
+  {
+    uint32_t const kind = random32(state) % 100;
+    if (kind < 8)				// (branches over the next byte or two)
+    {
+      const byte_t branches[] = { 0x10, 0x30, 0x50, 0x70, 0x90, 0xb0, 0xd0, 0xf0 };
+      ram[pc++] = branches[random32(state) % 8];
+      ram[pc++] = (byte_t) (random32(state) % 3);
+      continue;
+    }
+
+    if (kind < 11)				// JSR $07C0
+    {
+      ram[pc++] = 0x20;
+      ram[pc++] = 0xc0;
+      ram[pc++] = 0x07;
+      continue;
+    }
+
+    if (kind < 14)				// PHA, PHP, PLA, PLP
+    {
+      const byte_t stack[] = { 0x48, 0x08, 0x68, 0x28 };
+      ram[pc++] = stack[random32(state) % 4];
+      continue;
+    }
+
+    byte_t opcode = 0;
+    bool const isUnofficial = (random32(state) % 10 == 0);
+    do
+    {
+      opcode = (byte_t) random32(state);
+    }
+    while (!isRandomOpcode(opcode, isUnofficial));
+
+    byte_t const mode = cpu.decode(opcode) -> mode;
+    ram[pc++] = opcode;
+    if (mode == IMP || mode == ACC)
+    {
+      continue;
+    }
+
+    ram[pc++] = (byte_t) random32(state);
+    if (mode == ABS || mode == ABX || mode == ABY)
+    {
+      uint32_t const page = (isSelfModifying)? (0x02 + random32(state) % 6) :
+				(0x02 + random32(state) % 3);
+      ram[pc++] = (byte_t) page;
+    }
+  }
+
+  const byte_t tail[] = {
+    0xc6, 0xf0,					// DEC $F0
+    0xf0, 0x03,					// BEQ +3
+    0x4c, (byte_t) loop, (byte_t) (loop >> 8),	// JMP (loop)
+    0x4c, 0x00, 0x06				// JMP $0600
+  };
+
+  memcpy(ram + pc, tail, sizeof(tail));
+
+  // the subroutine (of implied instructions that leave the stack be):
+  size_t sub = 0x07c0;
+  for (size_t i = 0; i != 5; ++i)
+  {
+    byte_t opcode = 0;
+    do
+    {
+      opcode = (byte_t) random32(state);
+    }
+    while (!isRandomOpcode(opcode, false) || cpu.decode(opcode) -> mode != IMP ||
+	   opcode == 0x48 || opcode == 0x08 || opcode == 0x68 || opcode == 0x28);
+
+    ram[sub++] = opcode;
+  }
+
+  ram[sub] = 0x60;				// RTS
+}
+
+
+// runs the random program with the recompiler (a block at a time) and the interpreter
+// (which catches up with it), returns false if their states ever differ
+static bool checkRandomProgram (uint32_t const seed)
+{
+  device_t* devices[2] = { device.create(), device.create() };
+  bus_t* buses[2] = { bus.create(devices[0]), bus.create(devices[1]) };
+  cpu_t* recompiler = cpu.create(devices[0], RecompilerEngine);
+  cpu_t* interpreter = cpu.create(devices[1], InterpreterEngine);
+  byte_t* ram = malloc(NES_CPU_WORK_RAM);
+  bool isSame = (recompiler != NULL && interpreter != NULL && ram != NULL);
+  if (isSame)
+  {
+    uint32_t state = seed;
+    generate(ram, &state, (seed % 3 == 0));
+    loadRAM(recompiler, ram);
+    loadRAM(interpreter, ram);
+    recompiler -> sp = interpreter -> sp = 0xfd;
+    recompiler -> a = interpreter -> a = (byte_t) random32(&state);
+    recompiler -> x = interpreter -> x = (byte_t) random32(&state);
+    recompiler -> y = interpreter -> y = (byte_t) random32(&state);
+    recompiler -> status = interpreter -> status = (byte_t) (0x24 | (random32(&state) & 0xcb));
+    recompiler -> skipsIdle = interpreter -> skipsIdle = false;
+  }
+
+  for (size_t i = 0; isSame && i != 4000; ++i)
+  {
+    recompiler -> run(recompiler, 1);
+    while (interpreter -> clock_count < recompiler -> clock_count)
+    {
+      interpreter -> step(interpreter);
+    }
+
+    isSame = (recompiler -> clock_count == interpreter -> clock_count &&
+	      recompiler -> pc == interpreter -> pc &&
+	      recompiler -> a == interpreter -> a &&
+	      recompiler -> x == interpreter -> x &&
+	      recompiler -> y == interpreter -> y &&
+	      recompiler -> sp == interpreter -> sp &&
+	      recompiler -> status == interpreter -> status &&
+	      memcmp(recompiler -> ram, interpreter -> ram, NES_CPU_WORK_RAM) == 0);
+  }
+
+  for (size_t i = 0; i != 2; ++i)
+  {
+    devices[i] = device.destroy(devices[i]);
+    buses[i] = bus.destroy(buses[i]);
+  }
+
+  recompiler = cpu.destroy(recompiler);
+  interpreter = cpu.destroy(interpreter);
+  free(ram);
+  return isSame;
+}
+
+
+// validates the recompiler against the interpreter on random programs (a third of them
+// self-modifying), block by block
+int checkRecompiler ()
+{
+  size_t const programs = 96;
+  size_t failures = 0;
+  for (size_t i = 0; i != programs; ++i)
+  {
+    failures += (checkRandomProgram(0x9e3779b9 * (i + 1)))? 0 : 1;
+  }
+
+  printf("CPU engines: %zu random programs, recompiler and interpreter engines: %s\n",
+	 programs, (failures == 0)? "OK" : "FAILED");
+  return (failures == 0)? SUCCESS : FAILURE;
+}
+
+
+// builds the image of an NROM ROM (a 16KB PRG-ROM bank, mirrored at $C000) holding the
+// test program at $8000 (its closing JMP $0600 jumps to $8000 instead), returns its size
+static size_t buildProgramROM (byte_t* image, const byte_t* program, size_t const size)
+{
+  byte_t const header[16] = { 'N', 'E', 'S', 0x1a, 1, 0 };
+  memset(image, 0, 16 + 0x4000);
+  memcpy(image, header, 16);
+  byte_t* prg = image + 16;
+  memcpy(prg, program, size);
+  prg[size - 1] = 0x80;				// (JMP $8000)
+  prg[0x3ffc] = 0x00;				// (reset vector)
+  prg[0x3ffd] = 0x80;
+  return 16 + 0x4000;
+}
+
+
+typedef struct	// instance of the batch checks (the CPU on a bus of its own, NROM mapped)
+{
+  device_t* dev;
+  bus_t* bus;
+  mapper_t* map;
+  cpu_t* cpu;
+} instance_t;
+
+
+// creates the instance (interpreter), returns false if it failed to
+static bool createInstance (instance_t* instance, cartridge_t* c)
+{
+  instance -> dev = device.create();
+  instance -> bus = bus.create(instance -> dev);
+  instance -> map = (c != NULL)? mapper.create(c, NROM) : NULL;
+  instance -> cpu = (instance -> bus != NULL)?
+    cpu.create(instance -> dev, InterpreterEngine) : NULL;
+  if (instance -> cpu == NULL || (c != NULL && instance -> map == NULL))
+  {
+    return false;
+  }
+
+  instance -> bus -> ConnectMapper(instance -> bus, instance -> map);
+  return true;
+}
+
+
+static void destroyInstance (instance_t* instance)
+{
+  instance -> cpu = cpu.destroy(instance -> cpu);
+  instance -> bus = bus.destroy(instance -> bus);
+  instance -> dev = device.destroy(instance -> dev);
+  if (instance -> map != NULL)
+  {
+    instance -> map = mapper.destroy(instance -> map);
+  }
+}
+
+
+// runs the image of the work RAM (holding the program at $0600, or the data of the program
+// of the cartridge) with a batch of CPUs and with their scalar twins, most lanes holding
+// data of their own (at $0010 - $0011 and $0200 - $02FF, so that they part at the branches
+// and meet again), returns false if any lane ever differs from its twin
+static bool checkBatchImage (const byte_t* image, cartridge_t* c, uint32_t* state)
+{
+  size_t const count = 64;
+  instance_t lanes[64];
+  instance_t twins[64];
+  cpu_t* cpus[64];
+  memset(lanes, 0, sizeof(lanes));
+  memset(twins, 0, sizeof(twins));
+  byte_t* ram = malloc(NES_CPU_WORK_RAM);
+  bool isSame = (ram != NULL);
+  for (size_t i = 0; isSame && i != count; ++i)
+  {
+    isSame = createInstance(&lanes[i], c) && createInstance(&twins[i], c);
+    if (isSame)
+    {
+      memcpy(ram, image, NES_CPU_WORK_RAM);
+      for (size_t j = 0x0010; (i % 4 != 0) && j != 0x0300; ++j)
+      {
+	ram[j] = (j < 0x0012 || j >= 0x0200)? (byte_t) random32(state) : ram[j];
+      }
+
+      cpu_t* CPUs[2] = { lanes[i].cpu, twins[i].cpu };
+      for (size_t k = 0; k != 2; ++k)
+      {
+	loadRAM(CPUs[k], ram);
+	if (c != NULL)
+	{
+	  CPUs[k] -> reset(CPUs[k]);		// (to the program of the cartridge)
+	}
+
+	CPUs[k] -> skipsIdle = false;
+      }
+
+      cpus[i] = lanes[i].cpu;
+    }
+  }
+
+  cpuBatch_t* batch = (isSame)? cpuBatch.create(cpus, count) : NULL;
+  isSame = (batch != NULL);
+  for (size_t frame = 0; isSame && frame != 20; ++frame)
+  {
+    size_t const budget = 100 + random32(state) % 3000;
+    size_t longest = 0;
+    for (size_t i = 0; i != count; ++i)
+    {
+      cpu_t* twin = twins[i].cpu;
+      size_t cycles = 0;
+      while (cycles < budget)
+      {
+	cycles += twin -> step(twin);
+      }
+
+      longest = (cycles > longest)? cycles : longest;
+    }
+
+    isSame = (batch -> run(batch, budget) == longest);
+    for (size_t i = 0; isSame && i != count; ++i)
+    {
+      const cpu_t* lane = lanes[i].cpu;
+      const cpu_t* twin = twins[i].cpu;
+      isSame = (lane -> clock_count == twin -> clock_count &&
+		lane -> pc == twin -> pc &&
+		lane -> a == twin -> a &&
+		lane -> x == twin -> x &&
+		lane -> y == twin -> y &&
+		lane -> sp == twin -> sp &&
+		lane -> status == twin -> status &&
+		memcmp(lane -> ram, twin -> ram, NES_CPU_WORK_RAM) == 0);
+    }
+  }
+
+  batch = cpuBatch.destroy(batch);
+  for (size_t i = 0; i != count; ++i)
+  {
+    destroyInstance(&lanes[i]);
+    destroyInstance(&twins[i]);
+  }
+
+  free(ram);
+  return isSame;
+}
+
+
+// validates the batch (lockstep) execution against the scalar CPUs on the test programs
+// (in RAM and in the PRG-ROM of an NROM cartridge) and on random programs
+int checkBatch ()
+{
+  byte_t* image = calloc(NES_CPU_WORK_RAM, sizeof(byte_t));
+  byte_t* rom = malloc(16 + 0x4000);
+  if (image == NULL || rom == NULL)
+  {
+    free(image);
+    free(rom);
+    return FAILURE;
+  }
+
+  const byte_t* programs[] = { copyProgram, multiplyProgram };
+  size_t const sizes[] = {
+    sizeof(copyProgram) / sizeof(byte_t), sizeof(multiplyProgram) / sizeof(byte_t)
+  };
+  const char* names[] = { "copy-add", "multiply" };
+  uint32_t state = 0x2a03;
+  int stat = SUCCESS;
+  for (size_t i = 0; i != 2; ++i)
+  {
+    memset(image, 0, NES_CPU_WORK_RAM);
+    memcpy(image + 0x0600, programs[i], sizes[i]);
+    bool const isSame = checkBatchImage(image, NULL, &state);
+
+    memset(image, 0, NES_CPU_WORK_RAM);
+    cartridge_t* c = cartridge.create();
+    bool const isLoaded = (c != NULL &&
+			   c -> loadFromMemory(c, rom, buildProgramROM(rom, programs[i], sizes[i])));
+    bool const isSameROM = (isLoaded && checkBatchImage(image, c, &state));
+    c = cartridge.destroy(c);
+
+    printf("CPU batch: %s program (RAM), 64 lanes and scalar CPUs: %s\n",
+	   names[i], (isSame)? "OK" : "FAILED");
+    printf("CPU batch: %s program (PRG-ROM), 64 lanes and scalar CPUs: %s\n",
+	   names[i], (isSameROM)? "OK" : "FAILED");
+    stat = (isSame && isSameROM)? stat : FAILURE;
+  }
+
+  size_t const programsRandom = 8;
+  size_t failures = 0;
+  for (size_t i = 0; i != programsRandom; ++i)
+  {
+    generate(image, &state, false);
+    failures += (checkBatchImage(image, NULL, &state))? 0 : 1;
+  }
+
+  printf("CPU batch: %zu random programs, 64 lanes and scalar CPUs: %s\n",
+	 programsRandom, (failures == 0)? "OK" : "FAILED");
+  free(image);
+  free(rom);
+  return (failures == 0)? stat : FAILURE;
+}
+
+// counts the accesses notified by the bus (by kind)
+static void count (void* vcounts, address_t const address, byte_t const value,
+		   busWatchKind_t const kind)
+{
+  size_t* counts = vcounts;
+  (void) address;
+  (void) value;
+  ++counts[kind];
+}
+
+
+// runs the subroutine call with the top of the stack ($01FF) watched, returns false unless
+// the engine notifies the push of the return address and its pull
+static bool checkStackWatch (cpuEngine_t const engine)
+{
+  device_t* dev = device.create();
+  bus_t* Bus = bus.create(dev);
+  cpu_t* CPU = cpu.create(dev, engine);
+  size_t counts[WatchExecute + 1] = { 0 };
+  bool isNotified = (CPU != NULL && Bus -> watch(Bus, 0x01ff, 0x01ff,
+						  WatchRead | WatchWrite, count, counts));
+  if (isNotified)
+  {
+    load(CPU, subroutineProgram, sizeof(subroutineProgram) / sizeof(byte_t));
+    CPU -> sp = 0xff;
+    CPU -> run(CPU, 64);
+    isNotified = (counts[WatchWrite] == 1 && counts[WatchRead] != 0);
+  }
+
+  CPU = cpu.destroy(CPU);
+  Bus = bus.destroy(Bus);
+  dev = device.destroy(dev);
+  return isNotified;
+}
+
+
+// reads the addresses with the range watched, returns false unless just the reads of the
+// range (at any of its mirrors) are notified and unwatching the range removes it
+static bool checkRangeWatch (address_t const first,
+			     address_t const last,
+			     const address_t* inside,
+			     const address_t* outside,
+			     size_t const size)
+{
+  device_t* dev = device.create();
+  bus_t* Bus = bus.create(dev);
+  size_t counts[WatchExecute + 1] = { 0 };
+  bool isExact = Bus -> watch(Bus, first, last, WatchRead, count, counts);
+  for (size_t i = 0; isExact && i != size; ++i)
+  {
+    Bus -> read(Bus, inside[i]);
+    isExact = (counts[WatchRead] == i + 1);
+    Bus -> read(Bus, outside[i]);
+    isExact = isExact && (counts[WatchRead] == i + 1);
+  }
+
+  isExact = isExact && Bus -> unwatch(Bus, first, last) != 0 && Bus -> countWatches == 0;
+  Bus = bus.destroy(Bus);
+  dev = device.destroy(dev);
+  return isExact;
+}
+
+
+// validates the notification of the accesses watched
+int checkWatches ()
+{
+  cpuEngine_t const engines[] = { InterpreterEngine, RecompilerEngine, AccurateEngine };
+  const char* engineNames[] = { "interpreter", "recompiler", "accurate" };
+  int stat = SUCCESS;
+  for (size_t i = 0; i != 3; ++i)
+  {
+    bool const isNotified = checkStackWatch(engines[i]);
+    printf("Bus watchpoints: stack (JSR and RTS), %s engine: %s\n",
+	   engineNames[i], (isNotified)? "OK" : "FAILED");
+    stat = (isNotified)? stat : FAILURE;
+  }
+
+  // a range over a mirror of the PPU registers, wrapping around the work RAM, and
+  // straddling the work RAM and the PPU registers:
+  address_t const firsts[] = { 0x2000, 0x0700, 0x1f00 };
+  address_t const lasts[] = { 0x2010, 0x0900, 0x2003 };
+  address_t const inside[][2] = { { 0x2005, 0x3ff8 }, { 0x0080, 0x0f50 }, { 0x0700, 0x2002 } };
+  address_t const outside[][2] = { { 0x4000, 0x1fff }, { 0x0400, 0x0c00 }, { 0x06ff, 0x2005 } };
+  for (size_t i = 0; i != 3; ++i)
+  {
+    bool const isExact = checkRangeWatch(firsts[i], lasts[i], inside[i], outside[i], 2);
+    printf("Bus watchpoints: range $%04X - $%04X: %s\n",
+	   firsts[i], lasts[i], (isExact)? "OK" : "FAILED");
+    stat = (isExact)? stat : FAILURE;
+  }
+
+  return stat;
+}
+
+
+// builds the image of an NROM ROM (a 16KB PRG-ROM bank and an 8KB CHR-ROM bank of
+// pseudo-random bytes, so that they do not compress away) with the flags 6 given
+static size_t buildROM (byte_t* image, byte_t const flags6)
+{
+  byte_t const header[16] = { 'N', 'E', 'S', 0x1a, 1, 1, flags6 };
+  size_t const size = 16 + 0x4000 + 0x2000;
+  memcpy(image, header, 16);
+  uint32_t seed = 0x2a03;
+  for (size_t i = 16; i != size; ++i)
+  {
+    seed = 1664525 * seed + 1013904223;
+    image[i] = (byte_t) (seed >> 24);
+  }
+
+  return size;
+}
+
+
+// compresses the image into a gzip archive (with the zlib compression level given),
+// returns the size of the archive (zero if it does not fit)
+static size_t gzipROM (byte_t* archive, size_t const capacity,
+		       const byte_t* image, size_t const size, int const level)
+{
+  z_stream z;
+  memset(&z, 0, sizeof(z));
+  if (deflateInit2(&z, level, Z_DEFLATED, 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+  {
+    return 0;
+  }
+
+  z.next_in = (Bytef*) image;
+  z.avail_in = size;
+  z.next_out = archive;
+  z.avail_out = capacity;
+  int const stat = deflate(&z, Z_FINISH);
+  size_t const count = z.total_out;
+  deflateEnd(&z);
+  return (stat == Z_STREAM_END)? count : 0;
+}
+
+
+// loads the image, returns true if the cartridge loads it (or fails to) as expected
+static bool checkROM (const byte_t* image, size_t const size, bool const isValid)
+{
+  cartridge_t* c = cartridge.create();
+  if (c == NULL)
+  {
+    return false;
+  }
+
+  bool const isLoaded = c -> loadFromMemory(c, image, size);
+  bool const isExpected = (isLoaded == isValid) &&
+			  ((c -> getROM(c) != NULL) == isValid) &&
+			  ((c -> getSizeROM(c) != 0) == isValid);
+  c = cartridge.destroy(c);
+  return isExpected;
+}
+
+
+// validates that the cartridge rejects the malformed ROMs (rather than handing out the
+// PRG-ROM it freed on failing to load them)
+int checkROMs ()
+{
+  size_t const capacity = 0x8000;
+  byte_t* image = malloc(capacity);
+  byte_t* archive = malloc(capacity);
+  if (image == NULL || archive == NULL)
+  {
+    free(image);
+    free(archive);
+    return FAILURE;
+  }
+
+  size_t const size = buildROM(image, 0x00);
+  size_t const sizeArchive = gzipROM(archive, capacity, image, size, Z_BEST_COMPRESSION);
+  bool const isValid[] = {
+    checkROM(image, size, true),
+    checkROM(image, 16, false),
+    checkROM(archive, sizeArchive / 2, false)
+  };
+
+  buildROM(image, 0x04);
+  bool const isTrainerRejected = checkROM(image, size, false);
+  const char* names[] = { "plain", "header only", "gzip truncated by half", "trainer" };
+  bool const isOK[] = { isValid[0], isValid[1], sizeArchive != 0 && isValid[2],
+			isTrainerRejected };
+
+  int stat = SUCCESS;
+  for (size_t i = 0; i != 4; ++i)
+  {
+    printf("ROM loading: %s: %s\n", names[i], (isOK[i])? "OK" : "FAILED");
+    stat = (isOK[i])? stat : FAILURE;
+  }
+
+  free(image);
+  free(archive);
+  return stat;
+}
+
+
+// stores the 16-bit and the 32-bit values (little-endian) of the zip records
+static byte_t* put16 (byte_t* p, uint16_t const value)
+{
+  p[0] = (byte_t) value;
+  p[1] = (byte_t) (value >> 8);
+  return (p + 2);
+}
+
+
+static byte_t* put32 (byte_t* p, uint32_t const value)
+{
+  return put16(put16(p, (uint16_t) value), (uint16_t) (value >> 16));
+}
+
+
+// archives the image as the entry "rom.nes" of a zip archive, stored (method 0) or
+// deflated (method 8), returns the size of the archive (zero if it does not fit)
+static size_t zipROM (byte_t* archive, size_t const capacity,
+		      const byte_t* image, size_t const size, uint16_t const method)
+{
+  const char name[] = "rom.nes";
+  size_t const len_name = sizeof(name) - 1;
+  size_t const offset_data = 30 + len_name;
+  if (capacity < offset_data + size + 46 + len_name + 22)
+  {
+    return 0;
+  }
+
+  size_t size_compressed = size;
+  if (method == 0)
+  {
+    memcpy(archive + offset_data, image, size);
+  }
+  else
+  {
+    z_stream z;
+    memset(&z, 0, sizeof(z));
+    if (deflateInit2(&z, Z_BEST_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8,
+		     Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+      return 0;
+    }
+
+    z.next_in = (Bytef*) image;
+    z.avail_in = size;
+    z.next_out = archive + offset_data;
+    z.avail_out = capacity - (offset_data + 46 + len_name + 22);
+    int const stat = deflate(&z, Z_FINISH);
+    size_compressed = z.total_out;
+    deflateEnd(&z);
+    if (stat != Z_STREAM_END)
+    {
+      return 0;
+    }
+  }
+
+  uint32_t const crc = crc32(crc32(0, Z_NULL, 0), image, size);
+  byte_t* p = put32(archive, 0x04034b50);		// local file header
+  p = put16(put16(put16(p, 20), 0), method);
+  p = put32(put32(put32(put32(p, 0), crc), size_compressed), size);
+  p = put16(put16(p, len_name), 0);
+  memcpy(p, name, len_name);
+
+  size_t const offset_cd = offset_data + size_compressed;
+  p = put32(archive + offset_cd, 0x02014b50);		// central directory entry
+  p = put16(put16(put16(put16(p, 20), 20), 0), method);
+  p = put32(put32(put32(put32(p, 0), crc), size_compressed), size);
+  p = put16(put16(put16(put16(put16(p, len_name), 0), 0), 0), 0);
+  p = put32(put32(p, 0), 0);
+  memcpy(p, name, len_name);
+  p += len_name;
+
+  size_t const size_cd = (size_t) (p - (archive + offset_cd));
+  p = put32(p, 0x06054b50);				// end of central directory
+  p = put16(put16(put16(put16(p, 0), 0), 1), 1);
+  p = put16(put32(put32(p, size_cd), offset_cd), 0);
+  return (size_t) (p - archive);
+}
+
+
+// validates that the archived ROMs load and that the corrupted ones (a flipped byte, a
+// truncated gzip trailer) are rejected on their CRC32 (or on failing to inflate)
+int checkArchives ()
+{
+  size_t const capacity = 0x8000;
+  byte_t* image = malloc(capacity);
+  byte_t* archive = malloc(capacity);
+  if (image == NULL || archive == NULL)
+  {
+    free(image);
+    free(archive);
+    return FAILURE;
+  }
+
+  size_t const size = buildROM(image, 0x00);
+  const char* names[] = {
+    "gzip", "zip (deflated)", "zip (stored)",
+    "gzip (stored) with a flipped byte", "gzip without its trailer",
+    "zip (stored) with a flipped byte", "zip (deflated) with a flipped byte"
+  };
+
+  int stat = SUCCESS;
+  for (size_t i = 0; i != 7; ++i)
+  {
+    size_t sizeArchive = 0;
+    switch (i)
+    {
+      case 0: case 4:
+	sizeArchive = gzipROM(archive, capacity, image, size, Z_BEST_COMPRESSION);
+	break;
+      case 1: case 6:
+	sizeArchive = zipROM(archive, capacity, image, size, 8);
+	break;
+      case 2: case 5:
+	sizeArchive = zipROM(archive, capacity, image, size, 0);
+	break;
+      case 3:
+	sizeArchive = gzipROM(archive, capacity, image, size, Z_NO_COMPRESSION);
+	break;
+    }
+
+    bool const isValid = (i < 3);
+    if (i == 3 || i == 5 || i == 6)
+    {
+      archive[sizeArchive / 2] ^= 0x10;
+    }
+    else if (i == 4)
+    {
+      sizeArchive -= 8;				// (the CRC32 and the size of the ROM)
+    }
+
+    bool const isOK = (sizeArchive != 0 && checkROM(archive, sizeArchive, isValid));
+    printf("ROM archives: %s: %s\n", names[i], (isOK)? "OK" : "FAILED");
+    stat = (isOK)? stat : FAILURE;
+  }
+
+  free(image);
+  free(archive);
+  return stat;
+}
+
+
+// reads the (controller) register as the low byte of its address
+static byte_t readRegister (void* context, address_t const address)
+{
+  (void) context;
+  return (byte_t) address;
+}
+
+
+static void writeRegister (void* context, address_t const address, byte_t const value)
+{
+  (void) context;
+  (void) address;
+  (void) value;
+}
+
+
+// connects a device claiming the range, returns true if the bus took it (and then reads it
+// through the handler of the device)
+static bool checkDevice (address_t const first, address_t const last)
+{
+  device_t* dev = device.create();
+  bus_t* Bus = bus.create(dev);
+  device_t* controllers = device.create();
+  bool isConnected = (controllers != NULL &&
+		      controllers -> claim(controllers, first, last,
+					   readRegister, writeRegister, NULL) &&
+		      Bus -> ConnectDevice(Bus, controllers));
+  isConnected = isConnected && (Bus -> read(Bus, last) == (byte_t) last);
+  controllers = device.destroy(controllers);
+  Bus = bus.destroy(Bus);
+  dev = device.destroy(dev);
+  return isConnected;
+}
+
+
+// validates that the devices claim the register pages but not the cartridge space (the CPU
+// decodes the code there straight out of the PRG-ROM banks, the claims would be ignored)
+int checkDevices ()
+{
+  address_t const firsts[] = { 0x4016, 0x5f00, 0x8000 };
+  address_t const lasts[] = { 0x4017, 0x60ff, 0xffff };
+  int stat = SUCCESS;
+  for (size_t i = 0; i != 3; ++i)
+  {
+    bool const isValid = (i == 0);
+    bool const isOK = (checkDevice(firsts[i], lasts[i]) == isValid);
+    printf("Bus devices: claim of $%04X - $%04X %s: %s\n", firsts[i], lasts[i],
+	   (isValid)? "connected" : "rejected", (isOK)? "OK" : "FAILED");
+    stat = (isOK)? stat : FAILURE;
+  }
+
+  return stat;
+}
+
+
+// writes the bytes to the file, returns false if it failed to
+static bool writeFile (const char* path, const byte_t* bytes, size_t const size)
+{
+  FILE* file = fopen(path, "wb");
+  if (file == NULL)
+  {
+    return false;
+  }
+
+  bool const isWritten = (fwrite(bytes, sizeof(byte_t), size, file) == size);
+  return (fclose(file) == 0 && isWritten);
+}
+
+
+// true if the catalogs hold the same entries (field by field)
+static bool isSameCatalog (const catalog_t* cat, const catalog_t* other)
+{
+  bool isSame = (cat != NULL && other != NULL && cat -> count == other -> count);
+  for (size_t i = 0; isSame && i != cat -> count; ++i)
+  {
+    const catalogEntry_t* a = &cat -> entries[i];
+    const catalogEntry_t* b = &other -> entries[i];
+    isSame = (strcmp(a -> path, b -> path) == 0 &&
+	      a -> mtime == b -> mtime &&
+	      a -> size_file == b -> size_file &&
+	      a -> crc32 == b -> crc32 &&
+	      a -> size_ROM == b -> size_ROM &&
+	      a -> size_VROM == b -> size_VROM &&
+	      memcmp(a -> sha1, b -> sha1, sizeof(a -> sha1)) == 0 &&
+	      a -> mapperNumber == b -> mapperNumber &&
+	      a -> submapperNumber == b -> submapperNumber &&
+	      a -> nameTableMirroring == b -> nameTableMirroring &&
+	      a -> tvSystem == b -> tvSystem &&
+	      a -> extendedRAM == b -> extendedRAM &&
+	      a -> valid == b -> valid);
+  }
+
+  return isSame;
+}
+
+
+// scans a library of ROMs (in a temporary directory), saves the catalog and loads it back,
+// and rescans the library with the catalog loaded: the unchanged ROMs (same size and
+// modification time) keep their entries and the changed ones are indexed afresh
+int checkCatalog ()
+{
+  char dir[] = "/tmp/nes-catalog-XXXXXX";
+  size_t const capacity = 16 + 0x4000 + 0x2000 + 0x100;
+  byte_t* image = calloc(capacity, sizeof(byte_t));
+  if (image == NULL || mkdtemp(dir) == NULL)
+  {
+    free(image);
+    return FAILURE;
+  }
+
+  size_t const len = sizeof(dir) + 32;
+  char paths[5][len];
+  snprintf(paths[0], len, "%s/a.nes", dir);
+  snprintf(paths[1], len, "%s/games", dir);
+  snprintf(paths[2], len, "%s/games/b.NES", dir);
+  snprintf(paths[3], len, "%s/games/header.nes", dir);
+  snprintf(paths[4], len, "%s/index", dir);
+
+  // an NROM ROM, a vertically mirrored one, and a header (with no ROM) in a subdirectory:
+  size_t const size = buildROM(image, 0x00);
+  bool isOK = writeFile(paths[0], image, size) && mkdir(paths[1], 0700) == 0;
+  buildROM(image, 0x01);
+  isOK = isOK && writeFile(paths[2], image, size) && writeFile(paths[3], image, 16);
+
+  catalog_t* scanned = (isOK)? catalog.scan(dir, NULL, 2) : NULL;
+  isOK = (scanned != NULL && scanned -> count == 3 &&
+	  catalog.save(scanned, paths[4]) == SUCCESS);
+  catalog_t* loaded = (isOK)? catalog.load(paths[4]) : NULL;
+  bool const isRoundTrip = (isOK && isSameCatalog(scanned, loaded));
+
+  // rewrites a.nes (same size, its modification time restored) and grows b.NES:
+  const catalogEntry_t* a = (isOK)? catalog.find(loaded, paths[0]) : NULL;
+  isOK = (a != NULL && a -> valid);
+  uint32_t const crc32 = (isOK)? a -> crc32 : 0;
+  struct stat st;
+  isOK = isOK && stat(paths[0], &st) == 0;
+  struct utimbuf const times = { .actime = st.st_atime, .modtime = st.st_mtime };
+  image[16] ^= 0xff;
+  isOK = isOK && writeFile(paths[0], image, size) && utime(paths[0], &times) == 0;
+  isOK = isOK && writeFile(paths[2], image, capacity);
+
+  catalog_t* rescanned = (isOK)? catalog.scan(dir, loaded, 2) : NULL;
+  const catalogEntry_t* reused = (rescanned)? catalog.find(rescanned, paths[0]) : NULL;
+  const catalogEntry_t* indexed = (rescanned)? catalog.find(rescanned, paths[2]) : NULL;
+  const catalogEntry_t* header = (rescanned)? catalog.find(rescanned, paths[3]) : NULL;
+  const catalogEntry_t* old = (loaded)? catalog.find(loaded, paths[2]) : NULL;
+  bool const isRescanned = (reused != NULL && indexed != NULL && header != NULL &&
+			    old != NULL &&
+			    reused -> crc32 == crc32 &&
+			    indexed -> size_file == capacity &&
+			    indexed -> crc32 != old -> crc32 &&
+			    indexed -> nameTableMirroring == old -> nameTableMirroring &&
+			    !header -> valid);
+
+  scanned = catalog.destroy(scanned);
+  loaded = catalog.destroy(loaded);
+  rescanned = catalog.destroy(rescanned);
+  unlink(paths[4]);
+  unlink(paths[3]);
+  unlink(paths[2]);
+  rmdir(paths[1]);
+  unlink(paths[0]);
+  rmdir(dir);
+  free(image);
+
+  printf("ROM catalog: scan, save, and load: %s\n", (isRoundTrip)? "OK" : "FAILED");
+  printf("ROM catalog: rescan with the catalog loaded: %s\n", (isRescanned)? "OK" : "FAILED");
+  return (isRoundTrip && isRescanned)? SUCCESS : FAILURE;
+}
+
+
+// formats the SHA-1 (20 bytes) as a string of hexadecimal digits
+static void toHex (const byte_t* digest, char* hex)
+{
+  for (int i = 0; i != 20; ++i)
+  {
+    snprintf(hex + 2 * i, 3, "%02x", digest[i]);
+  }
+}
+
+
+// fingerprints the message in chunks of the given size (split into sections at the given
+// offset), returns false if the CRC32 or the SHA-1 does not match the expected one
+static bool checkDigest (const byte_t* message,
+			 size_t const size,
+			 size_t const chunk,
+			 size_t const split,
+			 uint32_t const crc,
+			 const char* sha1)
+{
+  fingerprint_t fp;
+  fingerprint.init(&fp);
+  bool isMatch = true;
+  for (size_t i = 0; i != size;)
+  {
+    size_t const end = (i < split && split < size)? split : size;
+    size_t const count = (end - i < chunk)? (end - i) : chunk;
+    fingerprint.update(&fp, message + i, count);
+    i += count;
+    if (i == split && split != size)
+    {
+      // the CRC32 of the section is the CRC32 of its bytes alone:
+      uint32_t const crc_section = crc32(0, message, split);
+      isMatch = (fingerprint.section(&fp) == crc_section) && isMatch;
+    }
+  }
+
+  uint32_t crc_total = 0;
+  byte_t digest[20];
+  char hex[41];
+  fingerprint.final(&fp, &crc_total, digest);
+  toHex(digest, hex);
+  return (isMatch && crc_total == crc && strcmp(hex, sha1) == 0);
+}
+
+
+// checks the CRC32 and the SHA-1 against known answers, updating the fingerprint in chunks
+// that end (and begin) anywhere relative to the 64-byte blocks of SHA-1 and with the ROM
+// split into sections, and the CRC32 against zlib for all the sizes the folding handles
+int checkFingerprint ()
+{
+  struct
+  {
+    const char* text;
+    size_t repeat;
+    uint32_t crc;
+    const char* sha1;
+  } const vectors[] = {
+    { "", 1, 0x00000000, "da39a3ee5e6b4b0d3255bfef95601890afd80709" },
+    { "abc", 1, 0x352441c2, "a9993e364706816aba3e25717850c26c9cd0d89d" },
+    { "123456789", 1, 0xcbf43926, "f7c3bc1d808e04732adf679965ccc34ca7ae3441" },
+    {
+      "The quick brown fox jumps over the lazy dog", 1,
+      0x414fa339, "2fd4e1c67a2d28fced849ee1bb76e7391b93eb12"
+    },
+    {
+      "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", 1,
+      0x171a3f5f, "84983e441c3bd26ebaae4aa1f95129e5e54670f1"
+    },
+    { "a", 55, 0xaadfe34e, "c1c8bbdc22796e28c0e15163d20899b65621d65a" },
+    { "a", 56, 0x79790d37, "c2db330f6083854c99d4b5bfb6e8f29f201be699" },
+    { "a", 64, 0x89b46555, "0098ba824b5c16427bd7a1122a5a442a25ec644d" },
+    { "a", 1000000, 0xdc25bfbc, "34aa973cd4c4daa4f61eeb2bdbad27316534016f" }
+  };
+
+  size_t const chunks[] = { 1, 3, 63, 64, 65, 1000, SIZE_MAX };
+  bool isKnown = true;
+  bool isSplit = true;
+  for (size_t i = 0; i != sizeof(vectors) / sizeof(vectors[0]); ++i)
+  {
+    size_t const len = strlen(vectors[i].text);
+    size_t const size = len * vectors[i].repeat;
+    byte_t* message = malloc(size + 1);
+    if (message == NULL)
+    {
+      return FAILURE;
+    }
+
+    for (size_t j = 0; j != vectors[i].repeat; ++j)
+    {
+      memcpy(message + j * len, vectors[i].text, len);
+    }
+
+    for (size_t c = 0; c != sizeof(chunks) / sizeof(chunks[0]); ++c)
+    {
+      bool const isMatch = checkDigest(message, size, chunks[c], size,
+				       vectors[i].crc, vectors[i].sha1);
+      isKnown = isMatch && isKnown;
+      bool const isSplitMatch = checkDigest(message, size, chunks[c], size / 2 + 1,
+					    vectors[i].crc, vectors[i].sha1);
+      isSplit = isSplitMatch && isSplit;
+    }
+
+    free(message);
+  }
+
+  // a pseudo-random message of every size (up to a few blocks) against zlib:
+  byte_t message[320];
+  uint32_t state = 0x2a03;
+  for (size_t i = 0; i != sizeof(message); ++i)
+  {
+    message[i] = (byte_t) random32(&state);
+  }
+
+  bool isZlib = true;
+  for (size_t size = 0; size != sizeof(message); ++size)
+  {
+    fingerprint_t fp;
+    uint32_t crc = 0;
+    byte_t digest[20];
+    fingerprint.init(&fp);
+    fingerprint.update(&fp, message + 1, size);
+    fingerprint.final(&fp, &crc, digest);
+    isZlib = (crc == crc32(0, message + 1, size)) && isZlib;
+  }
+
+  printf("Fingerprint: CRC32 and SHA-1 known answers: %s\n", (isKnown)? "OK" : "FAILED");
+  printf("Fingerprint: updates across the 64-byte blocks and sections: %s\n",
+	 (isSplit)? "OK" : "FAILED");
+  printf("Fingerprint: CRC32 against zlib: %s\n", (isZlib)? "OK" : "FAILED");
+  return (isKnown && isSplit && isZlib)? SUCCESS : FAILURE;
+}
+
+
+// decodes iNES 1.0 and NES 2.0 headers (sizes given by the MSB nybble and by the
+// exponent-multiplier notation, RAM shift counts, the 12-bit mapper, and the submapper)
+int checkHeaders ()
+{
+  struct
+  {
+    byte_t header[16];
+    bool isNES20;
+    size_t size_ROM;
+    size_t size_VROM;
+    size_t size_PRGRAM;
+    size_t size_CHRRAM;
+    uint16_t mapperNumber;
+    byte_t submapperNumber;
+    nameTableMirroring_t nameTableMirroring;
+    tvSystem_t tvSystem;
+  } const headers[] = {
+    {
+      // iNES 1.0: bytes 8 and up (but for the PAL bit) mean nothing
+      { 'N', 'E', 'S', 0x1a, 0x02, 0x00, 0x12, 0x40, 0x3f, 0x01 },
+      false, 0x8000, 0, 0, 0x2000, 0x041, 0, Horizontal, PAL
+    },
+    {
+      // NES 2.0: banks with the MSB nybbles (byte 9), mapper 0x314 submapper 5
+      { 'N', 'E', 'S', 0x1a, 0x02, 0x10, 0x41, 0x18, 0x53, 0x21, 0x70, 0x07, 0x03 },
+      true, 0x4000 * 0x102, 0x2000 * 0x210, 0x2000, 0x2000, 0x314, 5, Vertical, Dendy
+    },
+    {
+      // NES 2.0: exponent-multiplier sizes, 2^20 * 3 and 2^13 * 5 bytes
+      { 'N', 'E', 'S', 0x1a, 0x51, 0x36, 0x08, 0x08, 0x00, 0xff, 0x99, 0x00, 0x01 },
+      true, 0x300000, 0xa000, 0x10000, 0, 0x000, 0, FourScreen, PAL
+    },
+    {
+      // NES 2.0: an exponent past the size_t range and 2^26 * 7 bytes
+      { 'N', 'E', 'S', 0x1a, 0xfc, 0x6b, 0x00, 0x08, 0xf0, 0xff, 0x00, 0x11, 0x02 },
+      true, SIZE_MAX, 0x1c000000, 0, 0x100, 0x000, 15, Horizontal, MultipleRegion
+    }
+  };
+
+  bool isSized = true;
+  bool isDecoded = true;
+  for (size_t i = 0; i != sizeof(headers) / sizeof(headers[0]); ++i)
+  {
+    const byte_t* header = headers[i].header;
+    isSized = (ines.getSizeROM(header) == headers[i].size_ROM &&
+	       ines.getSizeVROM(header) == headers[i].size_VROM &&
+	       ines.getSizePRGRAM(header) == headers[i].size_PRGRAM &&
+	       ines.getSizeCHRRAM(header) == headers[i].size_CHRRAM &&
+	       isSized);
+    isDecoded = (ines.isValid(header) &&
+		 ines.isNES20(header) == headers[i].isNES20 &&
+		 ines.getMapperNumber(header) == headers[i].mapperNumber &&
+		 ines.getSubmapperNumber(header) == headers[i].submapperNumber &&
+		 ines.getNameTableMirroring(header) == headers[i].nameTableMirroring &&
+		 ines.getTVSystem(header) == headers[i].tvSystem &&
+		 isDecoded);
+  }
+
+  printf("iNES header: ROM and RAM sizes (NES 2.0 MSB and exponent-multiplier): %s\n",
+	 (isSized)? "OK" : "FAILED");
+  printf("iNES header: mapper, submapper, mirroring, and TV system: %s\n",
+	 (isDecoded)? "OK" : "FAILED");
+  return (isSized && isDecoded)? SUCCESS : FAILURE;
+}
+
+
+// benchmarks (in instructions per second) the table-driven execution of the CPU against
+// the decoding of the same instructions with the addressing-mode methods of the CPU
+void bench (cpu_t* CPU)
+{
+  // copy-add loop over a 256-byte buffer (in the work RAM of the bus):
+  const byte_t program[] = {
+    0xa2, 0x00,			// $0600: LDX #$00
+    0xbd, 0x00, 0x02,		// $0602: LDA $0200,X
+    0x18,			// $0605: CLC
+    0x69, 0x03,			// $0606: ADC #$03
+    0x9d, 0x00, 0x03,		// $0608: STA $0300,X
+    0xa4, 0x10,			// $060B: LDY $10
+    0xc8,			// $060D: INY
+    0x84, 0x10,			// $060E: STY $10
+    0xe8,			// $0610: INX
+    0xd0, 0xef,			// $0611: BNE $0602
+    0x4c, 0x00, 0x06		// $0613: JMP $0600
+  };
+
+  size_t const size = sizeof(program) / sizeof(byte_t);
+  load(CPU, program, size);
+
+  size_t const count = 50000000;
+  double const start = walltime();
+  for (size_t i = 0; i != count; ++i)
+  {
+    CPU -> step(CPU);
+  }
+  double const elapsed = walltime() - start;
+  printf("CPU::step(): %.1f million instructions per second\n", 1.0e-6 * count / elapsed);
+
+  // decodes the same instructions (straight-line) with the addressing-mode methods:
+  byte_t (*modes[]) (void*) = {
+    [IMP] = CPU -> IMP, [ACC] = CPU -> IMP, [IMM] = CPU -> IMM, [ZP0] = CPU -> ZP0,
+    [ZPX] = CPU -> ZPX, [ZPY] = CPU -> ZPY, [ABS] = CPU -> ABS, [ABX] = CPU -> ABX,
+    [ABY] = CPU -> ABY, [IND] = CPU -> IND, [IZX] = CPU -> INX, [IZY] = CPU -> INY,
+    [REL] = CPU -> REL
+  };
+
+  CPU -> pc = 0x0600;
+  double const begin = walltime();
+  for (size_t i = 0; i != count; ++i)
+  {
+    byte_t const opcode = CPU -> read(CPU, CPU -> pc++);
+    const instruction_t* instruction = cpu.decode(opcode);
+    modes[instruction -> mode](CPU);
+    if (CPU -> pc >= 0x0600 + size)
+    {
+      CPU -> pc = 0x0600;
+    }
+  }
+  double const time = walltime() - begin;
+  printf("CPU addressing modes: %.1f million instructions per second (decode only)\n",
+	 1.0e-6 * count / time);
+}
+
+
+// benchmarks (in cycles per second) the execution of the CPU engine against a cycle budget
+void benchEngine (cpuEngine_t const engine)
+{
+  device_t* devCPU = device.create();
+  bus_t* Bus = bus.create(devCPU);
+  cpu_t* CPU = cpu.create(devCPU, engine);
+  if (Bus == NULL || CPU == NULL)
+  {
+    devCPU = device.destroy(devCPU);
+    Bus = bus.destroy(Bus);
+    CPU = cpu.destroy(CPU);
+    return;
+  }
+
+  load(CPU, copyProgram, sizeof(copyProgram) / sizeof(byte_t));
+
+  size_t cycles = 0;
+  size_t const budget = 29781;			// (one NTSC frame)
+  double const start = walltime();
+  for (size_t i = 0; i != 10000; ++i)
+  {
+    cycles += CPU -> run(CPU, budget);
+  }
+  double const elapsed = walltime() - start;
+  const char* names[] = {
+    [InterpreterEngine] = "interpreter",
+    [RecompilerEngine] = "recompiler",
+    [AccurateEngine] = "accurate"
+  };
+  const char* name = names[CPU -> engine];
+  printf("CPU::run(): %.1f million cycles per second (%s)\n", 1.0e-6 * cycles / elapsed, name);
+
+  devCPU = device.destroy(devCPU);
+  Bus = bus.destroy(Bus);
+  CPU = cpu.destroy(CPU);
+}
+
+
+// benchmarks (in cycles per second) the interpreter on flag-heavy code (a shift-and-add
+// multiply), where most of the flags set by the operations are overwritten unread
+void benchFlags ()
+{
+  device_t* devCPU = device.create();
+  bus_t* Bus = bus.create(devCPU);
+  cpu_t* CPU = cpu.create(devCPU, InterpreterEngine);
+  if (Bus == NULL || CPU == NULL)
+  {
+    devCPU = device.destroy(devCPU);
+    Bus = bus.destroy(Bus);
+    CPU = cpu.destroy(CPU);
+    return;
+  }
+
+  load(CPU, multiplyProgram, sizeof(multiplyProgram) / sizeof(byte_t));
+  CPU -> write(CPU, 0x0011, 0xa7);
+
+  size_t cycles = 0;
+  size_t const budget = 29781;			// (one NTSC frame)
+  double const start = walltime();
+  for (size_t i = 0; i != 10000; ++i)
+  {
+    cycles += CPU -> run(CPU, budget);
+  }
+  double const elapsed = walltime() - start;
+  printf("CPU::run(): %.1f million cycles per second (interpreter, flags)\n",
+	 1.0e-6 * cycles / elapsed);
+
+  devCPU = device.destroy(devCPU);
+  Bus = bus.destroy(Bus);
+  CPU = cpu.destroy(CPU);
+}
+
+
+// benchmarks (in cycles per second) 1024 instances of the CPU running the copy-add
+// program out of the PRG-ROM of an NROM cartridge (each on data of its own), one after
+// the other (scalar) and as a batch (in lockstep)
+void benchBatch ()
+{
+  size_t const count = 1024;
+  instance_t* instances = calloc(count, sizeof(instance_t));
+  cpu_t** cpus = calloc(count, sizeof(cpu_t*));
+  byte_t* rom = malloc(16 + 0x4000);
+  cartridge_t* c = cartridge.create();
+  bool isCreated = (instances != NULL && cpus != NULL && rom != NULL && c != NULL &&
+		    c -> loadFromMemory(c, rom, buildProgramROM(rom, copyProgram,
+								sizeof(copyProgram))));
+  for (size_t i = 0; isCreated && i != count; ++i)
+  {
+    isCreated = createInstance(&instances[i], c);
+    cpus[i] = instances[i].cpu;
+    if (isCreated)
+    {
+      cpus[i] -> reset(cpus[i]);
+      cpus[i] -> skipsIdle = false;
+      cpus[i] -> write(cpus[i], 0x0200 + i % 0x100, (byte_t) i);
+    }
+  }
+
+  cpuBatch_t* batch = (isCreated)? cpuBatch.create(cpus, count) : NULL;
+  if (batch != NULL)
+  {
+    size_t const budget = 29781;		// (one NTSC frame)
+    size_t const frames = 10;
+    size_t cycles = 0;
+    double const start = walltime();
+    for (size_t frame = 0; frame != frames; ++frame)
+    {
+      for (size_t i = 0; i != count; ++i)
+      {
+	cycles += cpus[i] -> run(cpus[i], budget);
+      }
+    }
+    double const elapsed = walltime() - start;
+
+    size_t cyclesBatch = 0;
+    double const begin = walltime();
+    for (size_t frame = 0; frame != frames; ++frame)
+    {
+      cyclesBatch += count * batch -> run(batch, budget);
+    }
+    double const time = walltime() - begin;
+    printf("CPU::run(): %.1f million cycles per second (%zu instances, scalar)\n",
+	   1.0e-6 * cycles / elapsed, count);
+    printf("CPU::Batch::run(): %.1f million cycles per second (%zu instances, lockstep)\n",
+	   1.0e-6 * cyclesBatch / time, count);
+  }
+
+  batch = cpuBatch.destroy(batch);
+  for (size_t i = 0; instances != NULL && i != count; ++i)
+  {
+    destroyInstance(&instances[i]);
+  }
+
+  c = cartridge.destroy(c);
+  free(instances);
+  free(cpus);
+  free(rom);
+}
+
+// runs the ROM (headless) for the given number of frames
+int play (const char* path, size_t const frames, cpuEngine_t const engine, bool const skipsIdle)
+{
+  nes_t* console = nes.create(path, engine);
+  if (console == NULL)
+  {
+    return FAILURE;
+  }
+
+  console -> setIdleSkip(console, skipsIdle);
+
+  size_t cycles = 0;
+  double const start = walltime();
+  for (size_t i = 0; i != frames; ++i)
+  {
+    cycles += console -> runFrame(console);
+  }
+  double const elapsed = walltime() - start;
+
+  cpu_t* CPU = console -> getCPU(console);
+  printf("NES::runFrame(): %zu frames %zu cycles (PC: 0x%04x) %.1f frames per second\n",
+	 frames, cycles, CPU -> pc, (elapsed > 0)? frames / elapsed : 0.0);
+  printf("NES::runFrame(): %lu cycles skipped in idle loops\n",
+	 (unsigned long) console -> getSkippedCycles(console));
+
+  console = nes.destroy(console);
+  return SUCCESS;
+}
+
+
 void mirroringCallBack ()
 {
   printf("mirroring callback from mapper\n");
@@ -84,13 +1762,17 @@ void mirroringCallBack ()
 int test_mapperAxROM ()
 {
   cartridge_t* c = cartridge.create();
-  c -> loadFromFile(c);
-
   if (c == NULL)
   {
     return FAILURE;
   }
 
+  if (!c -> loadFromFile(c, "ROM"))
+  {
+    c = cartridge.destroy(c);
+    return FAILURE;
+  }
+
   printf("ROM size: %lu \n", c -> getSizeROM(c));
   if (c -> getROM(c) == NULL)
   {
@@ -133,13 +1815,17 @@ int test_mapperAxROM ()
 int test_mapperCNROM ()
 {
   cartridge_t* c = cartridge.create();
-  c -> loadFromFile(c);
-
   if (c == NULL)
   {
     return FAILURE;
   }
 
+  if (!c -> loadFromFile(c, "ROM"))
+  {
+    c = cartridge.destroy(c);
+    return FAILURE;
+  }
+
   printf("ROM size: %lu \n", c -> getSizeROM(c));
   if (c -> getROM(c) == NULL)
   {
@@ -1,23 +1,27 @@
 #include <stdio.h>
-#include "mapper.h"
+#include <stdint.h>
+#include "mapperDispatch.h"
 
 
 // mapper protected data typedef:
-typedef struct
-{
-  cartridge_t* m_cartridge;
-  mapperKind_t m_kind;
-  void* next;
-} data_t;
+typedef mapperData_t data_t;
+
+
+#if defined(NES_TRACE)
+extern trace_namespace_t const trace;
+#endif
 
 
+static byte_t openBus[0x2000];	// backs the unmapped CHR pages (never written)
+
+
+// reads are a lookup of the (8KB) page plus a mask, pages are remapped on bank switches
 static byte_t readPRG (const void* v_mapper, const address_t addr)
 {
   const mapper_t* mapper = v_mapper;
   const data_t* data = mapper -> data;
-  mapperKind_t const kind = data -> m_kind;
-  printf("Mapper::Mapper: %d reading PRG address %x ... done\n", kind, addr);
-  return 0;
+  byte_t const byte = mapper_readPRG(data, addr);
+  return byte;
 }
 
 
@@ -25,9 +29,8 @@ static byte_t readCHR (const void* v_mapper, const address_t addr)
 {
   const mapper_t* mapper = v_mapper;
   const data_t* data = mapper -> data;
-  mapperKind_t const kind = data -> m_kind;
-  printf("Mapper::Mapper: %d reading CHR address %x ... done\n", kind, addr);
-  return 0;
+  byte_t const byte = mapper_readCHR(data, addr);
+  return byte;
 }
 
 
@@ -35,8 +38,7 @@ static void writePRG (void* v_mapper, const address_t addr, const byte_t byte)
 {
   mapper_t* mapper = v_mapper;
   const data_t* data = mapper -> data;
-  mapperKind_t const kind = data -> m_kind;
-  printf("Mapper::Mapper: %d writing %x PRG address %x ... done\n", kind, byte, addr);
+  NES_TRACE_RECORD(data, TraceWritePRG, addr, byte);
 }
 
 
@@ -44,8 +46,86 @@ static void writeCHR (void* v_mapper, const address_t addr, const byte_t byte)
 {
   mapper_t* mapper = v_mapper;
   const data_t* data = mapper -> data;
-  mapperKind_t const kind = data -> m_kind;
-  printf("Mapper::Mapper: %d writing %x CHR address %x ... done\n", kind, byte, addr);
+  mapper_writeCHR(data, addr, byte);
+}
+
+
+// maps the PRG-ROM bank (of `size` bytes) at the 8KB pages starting at `page`, the bank
+// number wraps around the number of banks (the board ignores the bank bits it lacks)
+static void mapPRG (mapper_t* mapper, size_t const page, size_t const bank, size_t const size)
+{
+  data_t* data = mapper -> data;
+  size_t const size_PRG = data -> m_size_PRG;
+  size_t const num_banks = (size_PRG >= size)? (size_PRG / size) : 1;
+  size_t const base = ( (bank % num_banks) * size );
+  for (size_t i = 0; i != (size >> 13); ++i)
+  {
+    size_t const offset = ( (base + (i << 13)) % size_PRG );
+    data -> m_pagesPRG[(page + i) & 0x03] = (data -> m_PRG + offset);
+  }
+
+  ++data -> m_generation;
+  if (data -> m_remapped != NULL)
+  {
+    data -> m_remapped(data -> m_listener);
+  }
+}
+
+
+// maps the CHR bank (of `size` bytes) at the 1KB pages starting at `page`
+static void mapCHR (mapper_t* mapper, size_t const page, size_t const bank, size_t const size)
+{
+  data_t* data = mapper -> data;
+  size_t const size_CHR = data -> m_size_CHR;
+  if (data -> m_CHR == NULL)
+  {
+    for (size_t i = 0; i != (size >> 10); ++i)
+    {
+      data -> m_pagesCHR[(page + i) & 0x07] = openBus;
+    }
+
+    ++data -> m_generation;
+    return;
+  }
+
+  size_t const num_banks = (size_CHR >= size)? (size_CHR / size) : 1;
+  size_t const base = ( (bank % num_banks) * size );
+  for (size_t i = 0; i != (size >> 10); ++i)
+  {
+    size_t const offset = ( (base + (i << 10)) % size_CHR );
+    data -> m_pagesCHR[(page + i) & 0x07] = (data -> m_CHR + offset);
+  }
+
+  ++data -> m_generation;
+}
+
+
+// sets the memory backing the CHR pages (the CHR-ROM or the Character RAM)
+static void setCHR (mapper_t* mapper, byte_t* CHR, size_t const size, bool const writable)
+{
+  data_t* data = mapper -> data;
+  bool const isValid = (CHR != NULL && size != 0 && (size & 0x03ff) == 0);
+  data -> m_CHR = (isValid)? CHR : NULL;
+  data -> m_size_CHR = (isValid)? size : 0;
+  data -> m_writableCHR = (isValid && writable);
+  mapCHR(mapper, 0, 0, 0x2000);
+}
+
+
+// sets the callback notified (with the listener) whenever the PRG-ROM pages are remapped
+static void listen (mapper_t* mapper, void (*remapped) (void*), void* listener)
+{
+  data_t* data = mapper -> data;
+  data -> m_remapped = remapped;
+  data -> m_listener = listener;
+}
+
+
+// gets the count of the page remappings (cached translations are stale if it changed)
+static uint32_t getGeneration (const mapper_t* mapper)
+{
+  const data_t* data = mapper -> data;
+  return data -> m_generation;
 }
 
 
@@ -73,31 +153,75 @@ static void scanlineIRQ (void* v_mapper)
 {
   mapper_t* mapper = v_mapper;
   const data_t* data = mapper -> data;
-  mapperKind_t const kind = data -> m_kind;
-  printf("Mapper::Mapper: %d Mapper::scalineIRQ\n", kind);
+  NES_TRACE_RECORD(data, TraceScanlineIRQ, 0, 0);
 }
 
 
-static mapper_t* create (cartridge_t* cart, const mapperKind_t kind)
+// bytes of the block holding the core, its data, and the derived mapper (`size` bytes)
+static size_t footprint (size_t const size)
 {
-  mapper_t* mapper = malloc( sizeof(mapper_t) );
-  if (mapper == NULL)
+  size_t const size_core = NES_MAPPER_ALIGN( sizeof(mapper_t) );
+  size_t const size_data = NES_MAPPER_ALIGN( sizeof(data_t) );
+  size_t const size_derived = NES_MAPPER_ALIGN(size);
+  return (size_core + size_data + size_derived);
+}
+
+
+// constructs the core in the (cache-line aligned) block supplied by the caller, the data
+// follows the core and the derived mapper (if any) follows the data (see footprint())
+static mapper_t* createAt (void* block, cartridge_t* cart, const mapperKind_t kind)
+{
+  if ( block == NULL || ( (uintptr_t) block % NES_MAPPER_ALIGNMENT ) != 0 )
   {
-    return mapper;
+    printf("Mapper::Mapper: the mapper block is not aligned to a cache line!\n");
+    return NULL;
   }
 
-  mapper -> data = (data_t*) malloc( sizeof(data_t) );
-  if (mapper -> data == NULL)
+#if defined(NES_MAPPER_KIND)
+  if (kind != NES_MAPPER_KIND)
   {
-    free(mapper);
-    mapper = NULL;
-    printf("failed to allocate memory for the mapper data!\n");
-    return mapper;
+    printf("Mapper::Mapper: %d is not the mapper of this build!\n", kind);
+    return NULL;
+  }
+#endif
+
+  // maps the first 32KB of PRG-ROM (mirrors 16KB PRG-ROMs) and the first 8KB of CHR:
+  size_t const size_PRG = cart -> getSizeROM(cart);
+  if (size_PRG == 0 || (size_PRG & 0x1fff) != 0)
+  {
+    printf("Mapper::Mapper: PRG-ROM size is not a multiple of 8KB!\n");
+    return NULL;
   }
 
+  byte_t* bytes = block;
+  size_t const offset_data = NES_MAPPER_ALIGN( sizeof(mapper_t) );
+  size_t const offset_derived = offset_data + NES_MAPPER_ALIGN( sizeof(data_t) );
+  mapper_t* mapper = block;
+  mapper -> data = (data_t*) (bytes + offset_data);
+
   data_t* data = mapper -> data;
   data -> m_cartridge = cart;
   data -> m_kind = kind;
+  data -> next = (bytes + offset_derived);
+  data -> m_generation = 0;
+  data -> m_owned = false;
+  data -> m_remapped = NULL;
+  data -> m_listener = NULL;
+
+  data -> m_PRG = cart -> getROM(cart);
+  data -> m_size_PRG = size_PRG;
+  mapPRG(mapper, 0, 0, 0x8000);
+  setCHR(mapper, cart -> getVROM(cart), cart -> getSizeVROM(cart), false);
+
+#if defined(NES_TRACE)
+  data -> m_trace = trace.create(NES_TRACE_CAPACITY);
+  if (data -> m_trace == NULL)
+  {
+    mapper -> data = NULL;
+    mapper = NULL;
+    return mapper;
+  }
+#endif
 
   mapper -> readPRG = readPRG;
   mapper -> readCHR = readCHR;
@@ -111,36 +235,99 @@ static mapper_t* create (cartridge_t* cart, const mapperKind_t kind)
 }
 
 
-static mapper_t* destroy (mapper_t* mapper)
+static mapper_t* create (cartridge_t* cart, const mapperKind_t kind)
 {
+  void* block = aligned_alloc( NES_MAPPER_ALIGNMENT, footprint(0) );
+  if (block == NULL)
+  {
+    printf("failed to allocate memory for the mapper!\n");
+    return NULL;
+  }
+
+  mapper_t* mapper = createAt(block, cart, kind);
   if (mapper == NULL)
   {
+    free(block);
+    block = NULL;
     return mapper;
   }
 
-  if (mapper -> data == NULL)
+  data_t* data = mapper -> data;
+  data -> m_owned = true;
+  return mapper;
+}
+
+
+// saves the records of the trace so far (to $NES_TRACE_FILE, if defined, or to nes.trace)
+// for the offline decoder, returns how many were saved (none if built without tracing)
+static size_t saveTrace (mapper_t* mapper)
+{
+#if defined(NES_TRACE)
+  data_t* data = mapper -> data;
+  const char* path = getenv("NES_TRACE_FILE");
+  return trace.dump(data -> m_trace, (path != NULL)? path : "nes.trace");
+#else
+  (void) mapper;
+  return 0;
+#endif
+}
+
+
+// destroys the mapper, the block is freed only if the mapper allocated it
+static mapper_t* destroy (mapper_t* mapper)
+{
+  if (mapper == NULL)
   {
-    free(mapper);
-    mapper = NULL;
     return mapper;
   }
 
   data_t* data = mapper -> data;
+  bool const owned = data -> m_owned;
   data -> m_cartridge = NULL;
+  data -> next = NULL;
+#if defined(NES_TRACE)
+  saveTrace(mapper);
+  data -> m_trace = trace.destroy(data -> m_trace);
+#endif
 
-  free(mapper -> data);
   mapper -> data = NULL;
   data = NULL;
 
-  free(mapper);
+  if (owned)
+  {
+    free(mapper);
+  }
+
   mapper = NULL;
   return mapper;
 }
 
 
+// gets the trace of the mapper (NULL if the emulator was built without tracing)
+static trace_t* getTrace (const mapper_t* mapper)
+{
+#if defined(NES_TRACE)
+  const data_t* data = mapper -> data;
+  return data -> m_trace;
+#else
+  (void) mapper;
+  return NULL;
+#endif
+}
+
+
 mapper_namespace_t const mapper = {
   .create = create,
-  .destroy = destroy
+  .createAt = createAt,
+  .footprint = footprint,
+  .destroy = destroy,
+  .mapPRG = mapPRG,
+  .mapCHR = mapCHR,
+  .setCHR = setCHR,
+  .getGeneration = getGeneration,
+  .listen = listen,
+  .getTrace = getTrace,
+  .saveTrace = saveTrace
 };
 
 
@@ -1,14 +1,10 @@
 #include <stdio.h>
 #include "mapperAxROM.h"
+#include "mapperDispatch.h"
 
 
 // we need the typedef of the protected data of the core mapper
-typedef struct
-{
-  cartridge_t* m_cartridge;
-  mapperKind_t m_kind;
-  void* next;
-} data_t;
+typedef mapperData_t data_t;
 
 
 typedef struct
@@ -27,93 +23,21 @@ typedef struct
 extern mapper_namespace_t const mapper;
 
 
-static byte_t readPRG (const void* v_core, const address_t address)
-{
-  const mapper_t* core = v_core;
-  const data_t* data = core -> data;
-  mapperKind_t const kind = data -> m_kind;
-  const cartridge_t* cart = data -> m_cartridge;
-  const mapperAxROM_t* map = data -> next;
-  const byte_t* PRG = cart -> getROM(cart);
-  uint32_t const bank_PRG = map -> m_bank_PRG;
-
-  // NOTE: mixed type arithmetic (from snes), address is uint16_t and bank-PRG is uint32_t
-  uint32_t const addr = ( (bank_PRG * 0x8000) + (address & 0x7fff) );
-  byte_t const byte = PRG[addr];
-  printf("Mapper::Mapper: %d read %u from PRG at address 0x%x\n", kind, byte, addr);
-  return byte;
-}
-
-
-static byte_t readCHR (const void* v_core, const address_t addr)
-{
-  const mapper_t* core = v_core;
-  const data_t* data = core -> data;
-  mapperKind_t const kind = data -> m_kind;
-  const mapperAxROM_t* map = data -> next;
-  const byte_t* CHR = map -> m_characterRAM;
-
-  if (CHR == NULL)
-  {
-    printf("Mapper::Mapper: %d does not use Character RAM\n", kind);
-    return 0;
-  }
-
-  size_t const size_characterRAM = map -> m_size_characterRAM;
-  if (addr >= size_characterRAM)
-  {
-    const char log [] = "Mapper::Mapper: %d attempted to read CHR "
-			"at invalid address 0x%x\n";
-    printf(log, kind, addr);
-    return 0;
-  }
-
-  byte_t const byte = CHR[addr];
-  printf("Mapper::Mapper: %d read %u CHR at address 0x%x\n", kind, byte, addr);
-  return byte;
-}
-
-
-static void writePRG (void* v_core, const address_t addr, const byte_t byte)
+// bank switch (called directly by the inlined dispatch, see mapperDispatch.h)
+void mapperAxROM_writePRG (void* v_core, const address_t addr, const byte_t byte)
 {
   mapper_t* core = v_core;
   data_t* data = core -> data;
-  mapperKind_t const kind = data -> m_kind;
   mapperAxROM_t* map = data -> next;
   if (addr >= 0x8000)
   {
     map -> m_bank_PRG = (byte & 0x07);
     map -> m_mirroring = ( (byte & 0x10)? OneScreenHigher : OneScreenLower );
+    mapper.mapPRG(core, 0, map -> m_bank_PRG, 0x8000);
     map -> m_mirroringCallBack();
-    uint32_t const bank = map -> m_bank_PRG;
-    const char log[] = "Mapper::Mapper: %d wrote %u to bank-PRG\n";
-    printf(log, kind, bank);
   }
-}
 
-
-static void writeCHR (void* v_core, const address_t addr, const byte_t byte)
-{
-  mapper_t* core = v_core;
-  data_t* data = core -> data;
-  mapperKind_t const kind = data -> m_kind;
-  mapperAxROM_t* map = data -> next;
-  byte_t* CHR = map -> m_characterRAM;
-
-  if (CHR == NULL)
-  {
-    printf("Mapper::Mapper: %d does not use Character RAM\n", kind);
-    return;
-  }
-
-  size_t const size_characterRAM = map -> m_size_characterRAM;
-  if (addr >= size_characterRAM)
-  {
-    return;
-  }
-
-  CHR[addr] = byte;
-  printf("Mapper::Mapper: %d wrote %u to CHR at address 0x%x\n", kind, byte, addr);
+  NES_TRACE_RECORD(data, TraceWritePRG, addr, byte);
 }
 
 
@@ -127,42 +51,41 @@ static nameTableMirroring_t getNameTableMirroring (const void* v_core)
 }
 
 
-static mapper_t* create (cartridge_t* cart, void (*mirroring_cb) (void))
+// bytes of the mapper block: core, core data, mapper AxROM, and Character RAM (if any)
+static size_t footprint (const cartridge_t* cart)
+{
+  size_t const size_characterRAM = (cart -> getSizeVROM(cart) == 0)? 0x2000 : 0;
+  size_t const size = NES_MAPPER_ALIGN( sizeof(mapperAxROM_t) ) + size_characterRAM;
+  return mapper.footprint(size);
+}
+
+
+// constructs the mapper AxROM in the (cache-line aligned) block of footprint() bytes
+static mapper_t* createAt (void* block, cartridge_t* cart, void (*mirroring_cb) (void))
 {
   // constructs core (or super class):
   mapperKind_t kind = AxROM;
-  mapper_t* core = mapper.create(cart, kind);
+  mapper_t* core = mapper.createAt(block, cart, kind);
   if (core == NULL)
   {
     return core;
   }
 
-  // constructs derived AxROM mapper (or extending class):
-  mapperAxROM_t* map = malloc( sizeof(mapperAxROM_t) );
-  if (map == NULL)
-  {
-    core = mapper.destroy(core);
-    return core;
-  }
-
-  // binds core to mapper AxROM:
+  // the derived AxROM mapper (or extending class) follows the core data in the block:
   data_t* data = core -> data;
-  data -> next = map;
+  mapperAxROM_t* map = data -> next;
 
-  // overrides methods:
-  core -> readPRG = readPRG;
-  core -> readCHR = readCHR;
-  core -> writePRG = writePRG;
-  core -> writeCHR = writeCHR;
+  // overrides methods (reads and writes of CHR go through the pages of the core):
+  core -> writePRG = mapperAxROM_writePRG;
   core -> getNameTableMirroring = getNameTableMirroring;
 
-  // memory allocations:
   size_t const size_ROM = cart -> getSizeROM(cart);
   if (size_ROM >= 0x8000)
   {
     printf("Using PRG-ROM OK\n");
   }
 
+  // the Character RAM (if any) follows the mapper AxROM in the block:
   size_t size_characterRAM = 0;
   size_t const size_VROM = cart -> getSizeVROM(cart);
   if (size_VROM != 0)
@@ -173,7 +96,8 @@ static mapper_t* create (cartridge_t* cart, void (*mirroring_cb) (void))
   else
   {
     size_characterRAM = 0x2000;
-    map -> m_characterRAM = (byte_t*) malloc( size_characterRAM * sizeof(byte_t) );
+    byte_t* bytes = (byte_t*) map;
+    map -> m_characterRAM = ( bytes + NES_MAPPER_ALIGN( sizeof(mapperAxROM_t) ) );
     for (size_t i = 0; i != size_characterRAM; ++i)
     {
       map -> m_characterRAM[i] = ( (byte_t) 0x00 );
@@ -181,16 +105,6 @@ static mapper_t* create (cartridge_t* cart, void (*mirroring_cb) (void))
     printf("Uses Character RAM OK\n");
   }
 
-  if ( (size_VROM == 0) && (map -> m_characterRAM == NULL) )
-  {
-    core = mapper.destroy(core);
-    map -> m_core = NULL;
-    free(map);
-    map = NULL;
-    printf("failed to allocate Character RAM for mapper AxROM\n");
-    return core;
-  }
-
   // initializes mapper AxROM data:
   map -> m_core = core;
   map -> m_bank_PRG = ( (uint32_t) 0x00000000 );
@@ -198,6 +112,10 @@ static mapper_t* create (cartridge_t* cart, void (*mirroring_cb) (void))
   map -> m_size_VROM = size_VROM;
   map -> m_size_characterRAM = size_characterRAM;
   map -> m_mirroring = OneScreenLower;
+  if (map -> m_characterRAM != NULL)
+  {
+    mapper.setCHR(core, map -> m_characterRAM, size_characterRAM, true);
+  }
 
   map -> m_mirroringCallBack = mirroring_cb;
 
@@ -205,34 +123,52 @@ static mapper_t* create (cartridge_t* cart, void (*mirroring_cb) (void))
 }
 
 
-static mapper_t* destroy (mapper_t* core)
+static mapper_t* create (cartridge_t* cart, void (*mirroring_cb) (void))
 {
+  void* block = aligned_alloc( NES_MAPPER_ALIGNMENT, footprint(cart) );
+  if (block == NULL)
+  {
+    printf("failed to allocate memory for mapper AxROM\n");
+    return NULL;
+  }
+
+  mapper_t* core = createAt(block, cart, mirroring_cb);
   if (core == NULL)
   {
+    free(block);
+    block = NULL;
     return core;
   }
 
   data_t* data = core -> data;
-  mapperAxROM_t* map = data -> next;
-  core = mapper.destroy(core);
-  map -> m_core = NULL;
+  data -> m_owned = true;
+  return core;
+}
 
-  if (map -> m_characterRAM != NULL)
+
+static mapper_t* destroy (mapper_t* core)
+{
+  if (core == NULL)
   {
-    free(map -> m_characterRAM);
-    map -> m_characterRAM = NULL;
+    return core;
   }
 
+  data_t* data = core -> data;
+  mapperAxROM_t* map = data -> next;
+  map -> m_core = NULL;
+  map -> m_characterRAM = NULL;
   map -> m_mirroringCallBack = NULL;
-
-  free(map);
   map = NULL;
+
+  core = mapper.destroy(core);
   return core;
 }
 
 
 mapperAxROM_namespace_t const mapperAxROM = {
   .create = create,
+  .createAt = createAt,
+  .footprint = footprint,
   .destroy = destroy
 };
 
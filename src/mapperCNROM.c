@@ -1,14 +1,10 @@
 #include <stdio.h>
 #include "mapperCNROM.h"
+#include "mapperDispatch.h"
 
 
 // we need the typedef of the protected data of the core mapper
-typedef struct
-{
-  cartridge_t* m_cartridge;
-  mapperKind_t m_kind;
-  void* next;
-} data_t;
+typedef mapperData_t data_t;
 
 
 typedef struct
@@ -25,111 +21,45 @@ typedef struct
 extern mapper_namespace_t const mapper;
 
 
-static byte_t readPRG (const void* v_core, const address_t address)
-{
-  const mapper_t* core = v_core;
-  const data_t* data = core -> data;
-  mapperKind_t const kind = data -> m_kind;
-  const cartridge_t* cart = data -> m_cartridge;
-  const mapperCNROM_t* map = data -> next;
-  const byte_t* PRG = cart -> getROM(cart);
-  bool const mirrored = (map -> m_oneBank);
-
-  address_t const offset = (address - 0x8000);
-  address_t const addr = ( (mirrored)? (offset & 0x3fff) : (offset) );
-  byte_t const byte = PRG[addr];
-  printf("Mapper::Mapper: %d read %u from PRG at address 0x%x\n", kind, byte, addr);
-  return byte;
-}
-
-
-static byte_t readCHR (const void* v_core, const address_t address)
-{
-  const mapper_t* core = v_core;
-  const data_t* data = core -> data;
-  mapperKind_t const kind = data -> m_kind;
-  const cartridge_t* cart = data -> m_cartridge;
-  const mapperCNROM_t* map = data -> next;
-  const byte_t* VROM = cart -> getVROM(cart);
-
-  if (VROM == NULL)
-  {
-    printf("Mapper::Mapper: %d does not have VROM\n", kind);
-    return 0;
-  }
-
-  // sane check not in snes:
-  address_t const selectCHR = map -> m_selectCHR;
-  address_t const addr = ( address | (selectCHR << 13) );
-  size_t const size_VROM = map -> m_size_VROM;
-  if (addr >= size_VROM)
-  {
-    const char log [] = "Mapper::Mapper: %d attempted to read VROM "
-			"at invalid address 0x%x\n";
-    printf(log, kind, addr);
-    return 0;
-  }
-
-  byte_t const byte = VROM[addr];
-  printf("Mapper::Mapper: %d read %u VROM at address 0x%x\n", kind, byte, addr);
-  return byte;
-}
-
-
-static void writePRG (void* v_core, const address_t addr, const byte_t byte)
+// bank switch (called directly by the inlined dispatch, see mapperDispatch.h)
+void mapperCNROM_writePRG (void* v_core, const address_t addr, const byte_t byte)
 {
   mapper_t* core = v_core;
   data_t* data = core -> data;
-  mapperKind_t const kind = data -> m_kind;
   mapperCNROM_t* map = data -> next;
 
   byte_t const value = (byte & 0x03);
   map -> m_selectCHR = value;
-  const char log [] = "Mapper::Mapper: %d wrote %u to select-CHR. "
-		      "address (ignore unused): 0x%x\n";
-  printf(log, kind, value, addr);
+  mapper.mapCHR(core, 0, value, 0x2000);
+  NES_TRACE_RECORD(data, TraceWritePRG, addr, value);
 }
 
 
-static void writeCHR (void* v_core, const address_t addr, const byte_t byte)
+// bytes of the mapper block: core, core data, and mapper CNROM
+static size_t footprint (const cartridge_t* cart)
 {
-  mapper_t* core = v_core;
-  data_t* data = core -> data;
-  const mapperKind_t kind = data -> m_kind;
-
-  const char log [] = "Mapper::Mapper: %d attempted to write %u to "
-		      "read-only CHR at address 0x%x\n";
-  printf(log, kind, byte, addr);
+  (void) cart;
+  return mapper.footprint( sizeof(mapperCNROM_t) );
 }
 
 
-static mapper_t* create (cartridge_t* cart)
+// constructs the mapper CNROM in the (cache-line aligned) block of footprint() bytes
+static mapper_t* createAt (void* block, cartridge_t* cart)
 {
   // constructs core (or super class):
   mapperKind_t kind = CNROM;
-  mapper_t* core = mapper.create(cart, kind);
+  mapper_t* core = mapper.createAt(block, cart, kind);
   if (core == NULL)
   {
     return core;
   }
 
-  // constructs derived CNROM mapper (or extending class):
-  mapperCNROM_t* map = malloc( sizeof(mapperCNROM_t) );
-  if (map == NULL)
-  {
-    core = mapper.destroy(core);
-    return core;
-  }
-
-  // binds core to mapper CNROM:
+  // the derived CNROM mapper (or extending class) follows the core data in the block:
   data_t* data = core -> data;
-  data -> next = map;
+  mapperCNROM_t* map = data -> next;
 
-  // overrides methods:
-  core -> readPRG = readPRG;
-  core -> readCHR = readCHR;
-  core -> writePRG = writePRG;
-  core -> writeCHR = writeCHR;
+  // overrides methods (the core pages mirror 16KB PRG-ROMs and reject CHR-ROM writes):
+  core -> writePRG = mapperCNROM_writePRG;
 
   // gets [V]ROM info:
   size_t size_ROM = cart -> getSizeROM(cart);
@@ -147,6 +77,29 @@ static mapper_t* create (cartridge_t* cart)
 }
 
 
+static mapper_t* create (cartridge_t* cart)
+{
+  void* block = aligned_alloc( NES_MAPPER_ALIGNMENT, footprint(cart) );
+  if (block == NULL)
+  {
+    printf("failed to allocate memory for mapper CNROM\n");
+    return NULL;
+  }
+
+  mapper_t* core = createAt(block, cart);
+  if (core == NULL)
+  {
+    free(block);
+    block = NULL;
+    return core;
+  }
+
+  data_t* data = core -> data;
+  data -> m_owned = true;
+  return core;
+}
+
+
 static mapper_t* destroy (mapper_t* core)
 {
   if (core == NULL)
@@ -156,17 +109,18 @@ static mapper_t* destroy (mapper_t* core)
 
   data_t* data = core -> data;
   mapperCNROM_t* map = data -> next;
-  core = mapper.destroy(core);
   map -> m_core = NULL;
-
-  free(map);
   map = NULL;
+
+  core = mapper.destroy(core);
   return core;
 }
 
 
 mapperCNROM_namespace_t const mapperCNROM = {
   .create = create,
+  .createAt = createAt,
+  .footprint = footprint,
   .destroy = destroy
 };
 
@@ -0,0 +1,495 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "nes.h"
+#include "ines.h"
+#include "mapperAxROM.h"
+#include "mapperCNROM.h"
+
+// the master clock counts fifths of a PPU dot so that the PAL ratio of 3.2 PPU dots per
+// CPU cycle is exact; the fractional cycle left over carries to the next frame
+#define NES_DOTS_PER_SCANLINE ( (int64_t) 341 )
+#define NES_SUBDOTS_PER_DOT ( (int64_t) 5 )
+#define NES_SUBDOTS_PER_SCANLINE (NES_DOTS_PER_SCANLINE * NES_SUBDOTS_PER_DOT)
+#define NES_VBLANK_SCANLINE ( (int64_t) 241 )	// (the NMI is on its first dot)
+#define NES_DMA_CYCLES ( (uint64_t) 513 )	// OAM DMA stall (514 on an odd cycle)
+
+
+// nes private data typedef:
+typedef struct
+{
+  cartridge_t* m_cartridge;
+  mapper_t* m_mapper;
+  device_t* m_device;
+  bus_t* m_bus;
+  cpu_t* m_cpu;
+  scheduler_t* m_scheduler;
+  uint64_t m_frame;			// frames since power up
+  uint64_t m_time;			// master clock (of the CPU) since power up
+  uint64_t m_frameStart;		// master clock at the start of the frame
+  int64_t m_subdotsPerFrame;
+  int64_t m_subdotsPerCycle;
+  uint64_t m_dmas;			// OAM DMAs stalled so far
+  uint64_t m_dmaEnd;			// master clock at the end of the OAM DMA
+  bool m_isDMA;				// the CPU is stalled by the OAM DMA
+  trace_t* m_trace;			// of the mapper (NULL unless tracing)
+} data_t;
+
+
+extern cpu_namespace_t const cpu;
+extern scheduler_namespace_t const scheduler;
+extern bus_namespace_t const bus;
+extern device_namespace_t const device;
+extern cartridge_namespace_t const cartridge;
+extern mapper_namespace_t const mapper;
+extern mapperAxROM_namespace_t const mapperAxROM;
+extern mapperCNROM_namespace_t const mapperCNROM;
+
+
+static void mirroringCallBack ()
+{
+  return;
+}
+
+
+// schedules the events of the frame that starts at the master clock time (ref[2])
+static void scheduleFrame (data_t* d)
+{
+  scheduler_t* s = d -> m_scheduler;
+  uint64_t const start = d -> m_frameStart;
+  s -> schedule(s, start + NES_VBLANK_SCANLINE * NES_SUBDOTS_PER_SCANLINE +
+		NES_SUBDOTS_PER_DOT, NMIEvent);
+  s -> schedule(s, start + d -> m_subdotsPerFrame, FrameEndEvent);
+}
+
+
+// runs the CPU up to the master clock time (or past it by the last instruction)
+static size_t catchUp (data_t* d, uint64_t const time)
+{
+  if (d -> m_time >= time)
+  {
+    return 0;
+  }
+
+  cpu_t* CPU = d -> m_cpu;
+  uint64_t const subdotsPerCycle = d -> m_subdotsPerCycle;
+  size_t const budget = (time - d -> m_time + subdotsPerCycle - 1) / subdotsPerCycle;
+  size_t const cycles = CPU -> run(CPU, budget);
+  d -> m_time += (cycles * subdotsPerCycle);
+  return cycles;
+}
+
+
+// the CPU sits out the OAM DMA up to the master clock time, returns the stalled cycles
+static size_t stall (data_t* d, uint64_t const time)
+{
+  if (d -> m_time >= time)
+  {
+    return 0;
+  }
+
+  cpu_t* CPU = d -> m_cpu;
+  uint64_t const subdotsPerCycle = d -> m_subdotsPerCycle;
+  size_t const cycles = (time - d -> m_time + subdotsPerCycle - 1) / subdotsPerCycle;
+  d -> m_time += (cycles * subdotsPerCycle);
+  CPU -> clock_count += cycles;
+  return cycles;
+}
+
+
+// schedules the end of the OAM DMA if the CPU was halted by one, the DMA takes 513 cycles
+// (and one more to align with the reads if it starts on an odd cycle) ref[3]
+static void scheduleDMA (data_t* d)
+{
+  cpu_t* CPU = d -> m_cpu;
+  if (CPU -> dmas == d -> m_dmas)
+  {
+    return;
+  }
+
+  scheduler_t* s = d -> m_scheduler;
+  uint64_t const cycles = NES_DMA_CYCLES + (CPU -> clock_count & 1);
+  d -> m_dmas = CPU -> dmas;
+  d -> m_dmaEnd = d -> m_time + cycles * d -> m_subdotsPerCycle;
+  d -> m_isDMA = true;
+  s -> schedule(s, d -> m_dmaEnd, DMAEvent);
+}
+
+
+// handles the event that fell due, returns the CPU cycles it took (the interrupt entry)
+static size_t dispatch (data_t* d, const event_t* event)
+{
+  scheduler_t* s = d -> m_scheduler;
+  cpu_t* CPU = d -> m_cpu;
+  size_t cycles = 0;
+  switch (event -> kind)
+  {
+    case NMIEvent:
+    {
+      // the CPU takes the NMI once the OAM DMA is over:
+      if (d -> m_isDMA)
+      {
+	s -> schedule(s, d -> m_dmaEnd, NMIEvent);
+	break;
+      }
+
+      // the PPU is not emulated yet, its control register is latched by the bus:
+      const byte_t* ppu = d -> m_bus -> ppu;
+      if (ppu[0] & 0x80)
+      {
+	uint64_t const clock = CPU -> clock_count;
+	CPU -> nmi(CPU);
+	cycles = (CPU -> clock_count - clock);
+	d -> m_time += (cycles * d -> m_subdotsPerCycle);
+      }
+      break;
+    }
+    case DMAEvent:
+      d -> m_isDMA = false;
+      break;
+    case FrameEndEvent:
+      ++d -> m_frame;
+      d -> m_frameStart += d -> m_subdotsPerFrame;
+      scheduleFrame(d);
+      break;
+    default:
+      break;
+  }
+
+  return cycles;
+}
+
+
+// stamps the trace records of the mapper with the CPU cycle (the accesses of the CPU run
+// that follows get the cycle it starts on)
+static void stamp (data_t* d)
+{
+  if (d -> m_trace != NULL)
+  {
+    d -> m_trace -> cycle = d -> m_cpu -> clock_count;
+  }
+}
+
+
+// runs the console up to the master clock time, the CPU catches up to the next event
+// (or to the time) and then the events that fell due are handled; returns the cycles
+static size_t advance (data_t* d, uint64_t const time)
+{
+  scheduler_t* s = d -> m_scheduler;
+  size_t cycles = 0;
+  while (d -> m_time < time)
+  {
+    uint64_t const next = s -> next(s);
+    uint64_t const until = (next < time)? next : time;
+    stamp(d);
+    cycles += (d -> m_isDMA)? stall(d, until) : catchUp(d, until);
+    scheduleDMA(d);
+
+    event_t event;
+    while (s -> pop(s, d -> m_time, &event))
+    {
+      stamp(d);
+      cycles += dispatch(d, &event);
+    }
+  }
+
+  return cycles;
+}
+
+
+static size_t run (void* v_nes, size_t const budget)
+{
+  nes_t* nes = v_nes;
+  data_t* d = nes -> data;
+  uint64_t const time = d -> m_time + budget * d -> m_subdotsPerCycle;
+  return advance(d, time);
+}
+
+
+// runs the console for a video frame (ref[1]), returns the consumed cycles
+static size_t runFrame (void* v_nes)
+{
+  nes_t* nes = v_nes;
+  data_t* d = nes -> data;
+  uint64_t const end = d -> m_frameStart + d -> m_subdotsPerFrame;
+  size_t const cycles = advance(d, end);
+  // saves the trace frame by frame (the ring holds the records of a few frames):
+  if (d -> m_trace != NULL)
+  {
+    mapper.saveTrace(d -> m_mapper);
+  }
+
+  return cycles;
+}
+
+
+static cpu_t* getCPU (const void* v_nes)
+{
+  const nes_t* nes = v_nes;
+  const data_t* d = nes -> data;
+  return d -> m_cpu;
+}
+
+
+static uint64_t getFrameCount (const void* v_nes)
+{
+  const nes_t* nes = v_nes;
+  const data_t* d = nes -> data;
+  return d -> m_frame;
+}
+
+
+// fast-forwards the idle loops of the ROM (the default) or runs them as they are
+static void setIdleSkip (void* v_nes, bool const skipsIdle)
+{
+  nes_t* nes = v_nes;
+  data_t* d = nes -> data;
+  d -> m_cpu -> skipsIdle = skipsIdle;
+}
+
+
+static uint64_t getSkippedCycles (const void* v_nes)
+{
+  const nes_t* nes = v_nes;
+  const data_t* d = nes -> data;
+  return d -> m_cpu -> skipped;
+}
+
+
+// sets the frame duration and the CPU clock divider of the TV system of the ROM (ref[1])
+static void setTiming (data_t* d)
+{
+  byte_t const timing = d -> m_cartridge -> getTimingMode(d -> m_cartridge);
+  int64_t const scanlines = (timing == PAL || timing == Dendy)? 312 : 262;
+  int64_t const dotsPerCycle = (timing == PAL)? 16 : 15;	// 3.2 or 3 PPU dots
+  d -> m_subdotsPerFrame = (scanlines * NES_SUBDOTS_PER_SCANLINE);
+  d -> m_subdotsPerCycle = dotsPerCycle;
+}
+
+
+// size of the PRG-RAM of the cartridge (as given by the NES 2.0 header, or the 8KB of
+// the iNES battery-backed or extended RAM), the banked PRG-RAM is limited to one bank
+static size_t getSizePRGRAM (const cartridge_t* c)
+{
+  size_t const size = c -> getSizePRGRAM(c);
+  if (size == 0)
+  {
+    return (c -> hasExtendedRAM(c))? NES_BUS_PRG_RAM : 0;
+  }
+
+  return (size < NES_BUS_PRG_RAM)? size : NES_BUS_PRG_RAM;
+}
+
+
+static mapper_t* createMapper (cartridge_t* c)
+{
+  uint16_t const number = c -> getMapperNumber(c);
+  mapper_t* map = NULL;
+  switch (number)
+  {
+    case NROM:
+      map = mapper.create(c, NROM);
+      break;
+    case CNROM:
+      map = mapperCNROM.create(c);
+      break;
+    case AxROM:
+      map = mapperAxROM.create(c, mirroringCallBack);
+      break;
+    default:
+      printf("NES::NES() unsupported mapper %u\n", number);
+      break;
+  }
+
+  return map;
+}
+
+
+static mapper_t* destroyMapper (mapper_t* map, const cartridge_t* c)
+{
+  if (map == NULL)
+  {
+    return map;
+  }
+
+  uint16_t const number = c -> getMapperNumber(c);
+  switch (number)
+  {
+    case CNROM:
+      map = mapperCNROM.destroy(map);
+      break;
+    case AxROM:
+      map = mapperAxROM.destroy(map);
+      break;
+    default:
+      map = mapper.destroy(map);
+      break;
+  }
+
+  return map;
+}
+
+
+static nes_t* destroy (nes_t* nes)
+{
+  if (nes == NULL)
+  {
+    return nes;
+  }
+
+  data_t* d = nes -> data;
+  d -> m_scheduler = scheduler.destroy(d -> m_scheduler);
+  d -> m_cpu = cpu.destroy(d -> m_cpu);
+  d -> m_bus = bus.destroy(d -> m_bus);
+  d -> m_device = device.destroy(d -> m_device);
+  d -> m_mapper = destroyMapper(d -> m_mapper, d -> m_cartridge);
+  d -> m_cartridge = cartridge.destroy(d -> m_cartridge);
+
+  free(nes -> data);
+  nes -> data = NULL;
+  d = NULL;
+
+  free(nes);
+  nes = NULL;
+  return nes;
+}
+
+
+// loads the ROM (plain, gzip'd, or zip'd), wires the mapper and the CPU to the bus, and
+// resets the CPU
+static nes_t* create (const char* path, cpuEngine_t const engine)
+{
+  nes_t* nes = malloc( sizeof(nes_t) );
+  if (nes == NULL)
+  {
+    printf("NES::NES() failed to allocate the console!\n");
+    return nes;
+  }
+
+  nes -> data = (data_t*) malloc( sizeof(data_t) );
+  if (nes -> data == NULL)
+  {
+    free(nes);
+    nes = NULL;
+    printf("NES::NES() failed to allocate the console data!\n");
+    return nes;
+  }
+
+  data_t* d = nes -> data;
+  d -> m_mapper = NULL;
+  d -> m_device = NULL;
+  d -> m_bus = NULL;
+  d -> m_cpu = NULL;
+  d -> m_scheduler = NULL;
+  d -> m_frame = 0;
+  d -> m_time = 0;
+  d -> m_frameStart = 0;
+  d -> m_dmas = 0;
+  d -> m_dmaEnd = 0;
+  d -> m_isDMA = false;
+  d -> m_trace = NULL;
+  d -> m_cartridge = cartridge.create();
+  if (d -> m_cartridge == NULL)
+  {
+    nes = destroy(nes);
+    return nes;
+  }
+
+  cartridge_t* c = d -> m_cartridge;
+  if (!c -> loadFromArchive(c, path))
+  {
+    printf("NES::NES() failed to load the ROM %s\n", path);
+    nes = destroy(nes);
+    return nes;
+  }
+
+  d -> m_mapper = createMapper(c);
+  if (d -> m_mapper == NULL)
+  {
+    nes = destroy(nes);
+    return nes;
+  }
+
+  d -> m_trace = mapper.getTrace(d -> m_mapper);
+
+  d -> m_device = device.create();
+  if (d -> m_device == NULL)
+  {
+    nes = destroy(nes);
+    return nes;
+  }
+
+  d -> m_bus = bus.create(d -> m_device);
+  if (d -> m_bus == NULL)
+  {
+    nes = destroy(nes);
+    return nes;
+  }
+
+  d -> m_cpu = cpu.create(d -> m_device, engine);
+  if (d -> m_cpu == NULL)
+  {
+    nes = destroy(nes);
+    return nes;
+  }
+
+  d -> m_scheduler = scheduler.create(NES_SCHEDULER_CAPACITY);
+  if (d -> m_scheduler == NULL)
+  {
+    nes = destroy(nes);
+    return nes;
+  }
+
+  d -> m_bus -> ConnectMapper(d -> m_bus, d -> m_mapper);
+  size_t const sizePRGRAM = getSizePRGRAM(c);
+  if (sizePRGRAM != 0 && !d -> m_bus -> ConnectPRGRAM(d -> m_bus, sizePRGRAM))
+  {
+    nes = destroy(nes);
+    return nes;
+  }
+
+  d -> m_cpu -> reset(d -> m_cpu);
+  setTiming(d);
+  scheduleFrame(d);
+
+  nes -> runFrame = runFrame;
+  nes -> run = run;
+  nes -> getCPU = getCPU;
+  nes -> getFrameCount = getFrameCount;
+  nes -> setIdleSkip = setIdleSkip;
+  nes -> getSkippedCycles = getSkippedCycles;
+  return nes;
+}
+
+
+nes_namespace_t const nes = {
+  .create = create,
+  .destroy = destroy
+};
+
+
+// NES Emulation					October 18, 2026
+//
+//			Academic Purpose
+//
+// source: nes.c
+// author: @misael-diaz
+//
+// Synopsis:
+// Implements the methods of the console object.
+// The CPU runs whole instructions against a budget of cycles rather than one clock() call
+// per cycle; a frame is the budget of CPU cycles of one PPU frame of the TV system.
+// The timed events (NMI, DMA completion, frame end) come from the scheduler, the CPU runs
+// straight up to the next one and the event is handled when the CPU has caught up.
+// The OAM DMA halts the CPU (its run stops at the write to OAMDMA), the stall is charged
+// as the CPU sits out the time up to the DMA event that ends it.
+//
+// Copyright (c) 2023 Misael Diaz-Maldonado
+// This file is released under the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// References:
+// [0] https://github.com/amhndu/SimpleNES
+// [1] https://www.nesdev.org/wiki/Cycle_reference_chart
+// [2] https://www.nesdev.org/wiki/PPU_frame_timing
+// [3] https://www.nesdev.org/wiki/DMA
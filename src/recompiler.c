@@ -0,0 +1,998 @@
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include "recompiler.h"
+#include "cpu.h"
+
+#if defined(__GNUC__) && defined(__x86_64__) && defined(__unix__)
+#define NES_RECOMPILER_X86_64 1
+#include <sys/mman.h>
+#else
+#define NES_RECOMPILER_X86_64 0
+#endif
+
+
+// recompiler private data typedef:
+typedef struct
+{
+  byte_t* m_arena;			// executable code (read-write only while emitting)
+  size_t m_size;
+  size_t m_used;
+} data_t;
+
+
+#if NES_RECOMPILER_X86_64
+
+// the recompiled code keeps the 6502 registers in the CPU object and holds (callee-saved):
+//   rbx: the CPU object
+//   r12: the RAM (zero page, stack, and work RAM are accessed directly below $0800)
+//   r13: the page flags of the block cache (writes to flagged pages go to the bus)
+//   r14: the table of the N and Z flags of the values
+//   r15: the dynamic cycles (page crossings and taken branches)
+// and returns the cycles it consumed; the base cycles of the block are summed at compile
+// time, so the cycles are only counted at the exits of the block
+
+typedef enum	// x86-64 registers (the low ones, the others are fixed as above)
+{
+  RAX = 0,
+  RCX = 1,
+  RDX = 2,
+  RSI = 6,
+} reg_t;
+
+typedef struct	// Emitter (the machine code of the block being compiled)
+{
+  byte_t* code;
+  size_t size;
+  size_t used;				// may exceed the size (then the block does not fit)
+} emitter_t;
+
+typedef struct	// the 6502 instruction being compiled
+{
+  const blockOp_t* op;
+  address_t at;				// address of the instruction
+  address_t next;			// address of the next instruction
+  size_t before;			// base cycles of the block before the instruction
+  size_t through;			// base cycles of the block through the instruction
+} context_t;
+
+#define FIELD(field) ( (uint32_t) offsetof(cpu_t, field) )
+#define EMIT(...) emit(e, sizeof( (const byte_t[]) {__VA_ARGS__} ), (const byte_t[]) {__VA_ARGS__})
+
+#define NZ1(v) (byte_t) ( ( (v) & NegativeFlag ) | ( ( (v) == 0 )? ZeroFlag : 0 ) ),
+#define NZ4(v) NZ1(v) NZ1(v + 1) NZ1(v + 2) NZ1(v + 3)
+#define NZ16(v) NZ4(v) NZ4(v + 4) NZ4(v + 8) NZ4(v + 12)
+#define NZ64(v) NZ16(v) NZ16(v + 16) NZ16(v + 32) NZ16(v + 48)
+
+// the N and Z flags of the values:
+static const byte_t flagsNZ[256] = { NZ64(0) NZ64(64) NZ64(128) NZ64(192) };
+
+
+// helpers called by the recompiled code (the bus callbacks and the long operations):
+
+static byte_t helperRead (cpu_t* cpu, uint32_t const address)
+{
+  bus_t* bus = cpu -> bus;
+  return bus -> read(bus, address);
+}
+
+
+// returns true if the write may have changed the code (the block must be left)
+static bool helperWrite (cpu_t* cpu, uint32_t const address, uint32_t const value)
+{
+  bus_t* bus = cpu -> bus;
+  byte_t const flags = cpu -> cache -> pages[(address >> 8) & 0xff];
+  bus -> write(bus, address, value);
+  return (flags != 0);
+}
+
+
+static void helperADC (cpu_t* cpu, uint32_t const operand)
+{
+  byte_t const a = cpu -> a;
+  byte_t const value = operand;
+  uint16_t const sum = (a + value + (cpu -> status & CarryFlag));
+  byte_t const res = (byte_t) sum;
+  byte_t flags = cpu -> status & ~(CarryFlag | OverflowFlag | NegativeFlag | ZeroFlag);
+  flags |= (sum > 0xff)? CarryFlag : 0;
+  flags |= ( (~(a ^ value) & (a ^ res) & 0x80)? OverflowFlag : 0 );
+  flags |= flagsNZ[res];
+  cpu -> status = flags;
+  cpu -> a = res;
+}
+
+
+static byte_t shift (cpu_t* cpu, byte_t const res, bool const carry)
+{
+  byte_t flags = cpu -> status & ~(CarryFlag | NegativeFlag | ZeroFlag);
+  flags |= (carry)? CarryFlag : 0;
+  flags |= flagsNZ[res];
+  cpu -> status = flags;
+  return res;
+}
+
+
+static byte_t helperASL (cpu_t* cpu, uint32_t const value)
+{
+  return shift(cpu, value << 1, value & 0x80);
+}
+
+
+static byte_t helperLSR (cpu_t* cpu, uint32_t const value)
+{
+  return shift(cpu, (value & 0xff) >> 1, value & 0x01);
+}
+
+
+static byte_t helperROL (cpu_t* cpu, uint32_t const value)
+{
+  return shift(cpu, (value << 1) | (cpu -> status & CarryFlag), value & 0x80);
+}
+
+
+static byte_t helperROR (cpu_t* cpu, uint32_t const value)
+{
+  return shift(cpu, ( (value & 0xff) >> 1 ) | ( (cpu -> status & CarryFlag) << 7 ), value & 0x01);
+}
+
+
+// caters hardware bug (no carry into the high byte)
+static uint32_t helperIndirect (cpu_t* cpu, uint32_t const ptr)
+{
+  bus_t* bus = cpu -> bus;
+  address_t const next = ( (ptr & 0xff00) | ( (ptr + 1) & 0x00ff ) );
+  return ( (bus -> read(bus, next) << 8) | bus -> read(bus, ptr) );
+}
+
+
+// emitter primitives:
+
+static void emit (emitter_t* e, size_t const size, const byte_t* bytes)
+{
+  for (size_t i = 0; i != size; ++i)
+  {
+    if (e -> used < e -> size)
+    {
+      e -> code[e -> used] = bytes[i];
+    }
+    ++e -> used;
+  }
+}
+
+
+static void emit32 (emitter_t* e, uint32_t const value)
+{
+  EMIT(value, value >> 8, value >> 16, value >> 24);
+}
+
+
+static void emit64 (emitter_t* e, uint64_t const value)
+{
+  emit32(e, value);
+  emit32(e, value >> 32);
+}
+
+
+// emits the (short) conditional jump, returns the position of its displacement
+static size_t jump (emitter_t* e, byte_t const opcode)
+{
+  EMIT(opcode, 0x00);
+  return (e -> used - 1);
+}
+
+
+// points the (short) jump emitted at the position to the current position
+static void land (emitter_t* e, size_t const at)
+{
+  if (at < e -> size)
+  {
+    e -> code[at] = (byte_t) (e -> used - (at + 1));
+  }
+}
+
+
+// movzx reg, byte [rbx + field]
+static void loadField (emitter_t* e, reg_t const reg, uint32_t const field)
+{
+  EMIT(0x0f, 0xb6, 0x83 | (reg << 3));
+  emit32(e, field);
+}
+
+
+// mov byte [rbx + field], reg
+static void storeField (emitter_t* e, reg_t const reg, uint32_t const field)
+{
+  EMIT(0x88, 0x83 | (reg << 3));
+  emit32(e, field);
+}
+
+
+// mov word [rbx + pc], address
+static void storePC (emitter_t* e, address_t const address)
+{
+  EMIT(0x66, 0xc7, 0x83);
+  emit32(e, FIELD(pc));
+  EMIT(address, address >> 8);
+}
+
+
+// movzx reg, byte [r12 + address]
+static void loadRAM (emitter_t* e, reg_t const reg, uint32_t const address)
+{
+  EMIT(0x41, 0x0f, 0xb6, 0x84 | (reg << 3), 0x24);
+  emit32(e, address);
+}
+
+
+// mov eax, value
+static void loadImmediate (emitter_t* e, reg_t const reg, uint32_t const value)
+{
+  EMIT(0xb8 + reg);
+  emit32(e, value);
+}
+
+
+// calls the helper with the CPU object as the first argument (and esi, edx as set)
+static void call (emitter_t* e, const void* helper)
+{
+  EMIT(0x48, 0x89, 0xdf);		// mov rdi, rbx
+  EMIT(0x48, 0xb8);			// mov rax, helper
+  emit64(e, (uint64_t) (uintptr_t) helper);
+  EMIT(0xff, 0xd0);			// call rax
+}
+
+
+// updates the N and Z flags with the value in al (preserves eax)
+static void setNZ (emitter_t* e)
+{
+  EMIT(0x0f, 0xb6, 0xc0);		// movzx eax, al
+  loadField(e, RCX, FIELD(status));
+  EMIT(0x83, 0xe1, (byte_t) ~(NegativeFlag | ZeroFlag));	// and ecx, ~(N | Z)
+  EMIT(0x41, 0x0a, 0x0c, 0x06);		// or cl, [r14 + rax]
+  storeField(e, RCX, FIELD(status));
+}
+
+
+static void prologue (emitter_t* e)
+{
+  EMIT(0x53, 0x41, 0x54, 0x41, 0x55, 0x41, 0x56, 0x41, 0x57);	// push rbx, r12 - r15
+  EMIT(0x48, 0x89, 0xfb);		// mov rbx, rdi
+  EMIT(0x45, 0x31, 0xff);		// xor r15d, r15d
+  EMIT(0x4c, 0x8b, 0xa3);		// mov r12, [rbx + ram]
+  emit32(e, FIELD(ram));
+  EMIT(0x4c, 0x8b, 0xab);		// mov r13, [rbx + cache]
+  emit32(e, FIELD(cache));
+  EMIT(0x49, 0x81, 0xc5);		// add r13, pages
+  emit32(e, offsetof(blockCache_t, pages));
+  EMIT(0x49, 0xbe);			// mov r14, flagsNZ
+  emit64(e, (uint64_t) (uintptr_t) flagsNZ);
+}
+
+
+// leaves the block at the address, returning its base cycles plus the dynamic ones
+static void leave (emitter_t* e, address_t const address, size_t const cycles)
+{
+  storePC(e, address);
+  loadImmediate(e, RAX, cycles);
+  EMIT(0x4c, 0x01, 0xf8);		// add rax, r15
+  EMIT(0x41, 0x5f, 0x41, 0x5e, 0x41, 0x5d, 0x41, 0x5c, 0x5b);	// pop r15 - r12, rbx
+  EMIT(0xc3);				// ret
+}
+
+
+// adds the page-crossing penalty (address in esi, base in the register or the immediate)
+static void penalize (emitter_t* e, const blockOp_t* op, bool const isBaseInEDX)
+{
+  if (op -> penalty == 0)
+  {
+    return;
+  }
+
+  EMIT(0x89, 0xf1);			// mov ecx, esi
+  if (isBaseInEDX)
+  {
+    EMIT(0x31, 0xd1);			// xor ecx, edx
+  }
+  else
+  {
+    EMIT(0x81, 0xf1);			// xor ecx, base
+    emit32(e, op -> operand);
+  }
+  EMIT(0xf7, 0xc1, 0x00, 0xff, 0x00, 0x00);	// test ecx, 0xff00
+  EMIT(0x0f, 0x95, 0xc1);		// setnz cl
+  EMIT(0x0f, 0xb6, 0xc9);		// movzx ecx, cl
+  EMIT(0x49, 0x01, 0xcf);		// add r15, rcx
+}
+
+
+// computes the effective address into esi, false for the modes without one
+static bool address (emitter_t* e, const blockOp_t* op)
+{
+  uint32_t const operand = op -> operand;
+  switch (op -> mode)
+  {
+    case ZP0:
+    case ABS:
+      loadImmediate(e, RSI, operand);
+      return true;
+    case ZPX:
+    case ZPY:
+      loadField(e, RSI, (op -> mode == ZPX)? FIELD(x) : FIELD(y));
+      EMIT(0x81, 0xc6);			// add esi, operand
+      emit32(e, operand);
+      EMIT(0x81, 0xe6, 0xff, 0x00, 0x00, 0x00);	// and esi, 0xff
+      return true;
+    case ABX:
+    case ABY:
+      loadField(e, RSI, (op -> mode == ABX)? FIELD(x) : FIELD(y));
+      EMIT(0x81, 0xc6);			// add esi, operand
+      emit32(e, operand);
+      EMIT(0x0f, 0xb7, 0xf6);		// movzx esi, si
+      penalize(e, op, false);
+      return true;
+    case IZX:
+      loadField(e, RCX, FIELD(x));
+      EMIT(0x81, 0xc1);			// add ecx, operand
+      emit32(e, operand);
+      EMIT(0x81, 0xe1, 0xff, 0x00, 0x00, 0x00);	// and ecx, 0xff
+      EMIT(0x41, 0x0f, 0xb6, 0x34, 0x0c);	// movzx esi, byte [r12 + rcx]
+      EMIT(0xff, 0xc1);			// inc ecx
+      EMIT(0x81, 0xe1, 0xff, 0x00, 0x00, 0x00);	// and ecx, 0xff
+      EMIT(0x41, 0x0f, 0xb6, 0x0c, 0x0c);	// movzx ecx, byte [r12 + rcx]
+      EMIT(0xc1, 0xe1, 0x08);		// shl ecx, 8
+      EMIT(0x09, 0xce);			// or esi, ecx
+      return true;
+    case IZY:
+      loadRAM(e, RSI, operand & 0xff);
+      loadRAM(e, RCX, (operand + 1) & 0xff);
+      EMIT(0xc1, 0xe1, 0x08);		// shl ecx, 8
+      EMIT(0x09, 0xce);			// or esi, ecx
+      EMIT(0x89, 0xf2);			// mov edx, esi
+      loadField(e, RCX, FIELD(y));
+      EMIT(0x01, 0xce);			// add esi, ecx
+      EMIT(0x0f, 0xb7, 0xf6);		// movzx esi, si
+      penalize(e, op, true);
+      return true;
+    default:
+      return false;
+  }
+}
+
+
+// reads the byte at the address in esi into eax (the RAM directly, the rest via the bus)
+static void readAddress (emitter_t* e)
+{
+  EMIT(0x81, 0xfe, 0x00, 0x08, 0x00, 0x00);	// cmp esi, 0x800
+  size_t const slow = jump(e, 0x73);	// jae slow
+  EMIT(0x41, 0x0f, 0xb6, 0x04, 0x34);	// movzx eax, byte [r12 + rsi]
+  size_t const done = jump(e, 0xeb);	// jmp done
+  land(e, slow);
+  call(e, helperRead);
+  EMIT(0x0f, 0xb6, 0xc0);		// movzx eax, al
+  land(e, done);
+}
+
+
+// reads the operand of the instruction into eax
+static void read (emitter_t* e, const blockOp_t* op)
+{
+  bool const isStatic = (op -> mode == ZP0 || op -> mode == ABS);
+  if (op -> mode == IMM)
+  {
+    loadImmediate(e, RAX, op -> operand);
+  }
+  else if (isStatic && op -> operand < NES_CPU_WORK_RAM)
+  {
+    loadRAM(e, RAX, op -> operand);
+  }
+  else if (isStatic)
+  {
+    loadImmediate(e, RSI, op -> operand);
+    call(e, helperRead);
+    EMIT(0x0f, 0xb6, 0xc0);		// movzx eax, al
+  }
+  else
+  {
+    address(e, op);
+    readAddress(e);
+  }
+}
+
+
+// writes al to the address in esi, leaves the block if the code may have changed
+static void write (emitter_t* e, const context_t* ctx)
+{
+  EMIT(0x81, 0xfe, 0x00, 0x08, 0x00, 0x00);	// cmp esi, 0x800
+  size_t const slow = jump(e, 0x73);	// jae slow
+  EMIT(0x89, 0xf1);			// mov ecx, esi
+  EMIT(0xc1, 0xe9, 0x08);		// shr ecx, 8
+  EMIT(0x41, 0xf6, 0x44, 0x0d, 0x00, CodePage | BankPage);	// test byte [r13 + rcx]
+  size_t const flagged = jump(e, 0x75);	// jnz slow
+  EMIT(0x41, 0x88, 0x04, 0x34);		// mov [r12 + rsi], al
+  size_t const done = jump(e, 0xeb);	// jmp done
+  land(e, slow);
+  land(e, flagged);
+  EMIT(0x89, 0xc2);			// mov edx, eax
+  call(e, helperWrite);
+  EMIT(0x84, 0xc0);			// test al, al
+  size_t const stay = jump(e, 0x74);	// jz done
+  leave(e, ctx -> next, ctx -> through);
+  land(e, stay);
+  land(e, done);
+}
+
+
+// leaves the block before the instruction if the stack page is flagged (code in the stack)
+static void guardStack (emitter_t* e, const context_t* ctx)
+{
+  EMIT(0x41, 0xf6, 0x85, 0x01, 0x00, 0x00, 0x00, CodePage | BankPage);	// test [r13 + 1]
+  size_t const stay = jump(e, 0x74);	// jz stay
+  leave(e, ctx -> at, ctx -> before);
+  land(e, stay);
+}
+
+
+// pushes al (the stack page is not flagged)
+static void push (emitter_t* e)
+{
+  loadField(e, RCX, FIELD(sp));
+  EMIT(0x41, 0x88, 0x84, 0x0c, 0x00, 0x01, 0x00, 0x00);	// mov [r12 + rcx + 0x100], al
+  EMIT(0xfe, 0xc9);			// dec cl
+  storeField(e, RCX, FIELD(sp));
+}
+
+
+// pulls into eax
+static void pull (emitter_t* e)
+{
+  loadField(e, RCX, FIELD(sp));
+  EMIT(0xfe, 0xc1);			// inc cl
+  EMIT(0x41, 0x0f, 0xb6, 0x84, 0x0c, 0x00, 0x01, 0x00, 0x00);	// movzx eax, [r12+rcx+0x100]
+  storeField(e, RCX, FIELD(sp));
+}
+
+
+// read-modify-write: the address is kept in the abs register across the helper calls
+static void modify (emitter_t* e, const context_t* ctx, const void* helper, byte_t const step)
+{
+  address(e, ctx -> op);
+  EMIT(0x66, 0x89, 0xb3);		// mov [rbx + abs], si
+  emit32(e, FIELD(abs));
+  readAddress(e);
+  if (helper != NULL)
+  {
+    EMIT(0x89, 0xc6);			// mov esi, eax
+    call(e, helper);
+  }
+  else
+  {
+    EMIT(0xfe, step);			// inc al (or dec al)
+    setNZ(e);
+  }
+  EMIT(0x0f, 0xb6, 0xc0);		// movzx eax, al
+  EMIT(0x0f, 0xb7, 0xb3);		// movzx esi, word [rbx + abs]
+  emit32(e, FIELD(abs));
+  write(e, ctx);
+}
+
+
+static void compare (emitter_t* e, uint32_t const reg)
+{
+  loadField(e, RCX, reg);
+  EMIT(0x38, 0xc1);			// cmp cl, al
+  EMIT(0x0f, 0x93, 0xc2);		// setae dl
+  EMIT(0x28, 0xc1);			// sub cl, al
+  EMIT(0x0f, 0xb6, 0xc1);		// movzx eax, cl
+  loadField(e, RCX, FIELD(status));
+  EMIT(0x83, 0xe1, (byte_t) ~(NegativeFlag | ZeroFlag | CarryFlag));	// and ecx, ~(N|Z|C)
+  EMIT(0x41, 0x0a, 0x0c, 0x06);		// or cl, [r14 + rax]
+  EMIT(0x08, 0xd1);			// or cl, dl
+  storeField(e, RCX, FIELD(status));
+}
+
+
+static void branch (emitter_t* e, const context_t* ctx, byte_t const flag, bool const isSet)
+{
+  address_t const target = (ctx -> next + (int8_t) ctx -> op -> operand);
+  EMIT(0xf6, 0x83);			// test byte [rbx + status], flag
+  emit32(e, FIELD(status));
+  EMIT(flag);
+  size_t const skip = jump(e, (isSet)? 0x74 : 0x75);	// jz (or jnz) not taken
+  EMIT(0x49, 0x83, 0xc7, 1 + ( ( (target ^ ctx -> next) & 0xff00 )? 1 : 0 ));	// add r15
+  leave(e, target, ctx -> through);
+  land(e, skip);
+  leave(e, ctx -> next, ctx -> through);
+}
+
+
+// emits the instruction, false if it is not recompiled (the block ends before it)
+static bool instruction (emitter_t* e, const context_t* ctx)
+{
+  const blockOp_t* op = ctx -> op;
+  switch (op -> op)
+  {
+    case LDA:
+    case LDX:
+    case LDY:
+    case LAX:
+      read(e, op);
+      if (op -> op != LDX && op -> op != LDY)
+      {
+	storeField(e, RAX, FIELD(a));
+      }
+      if (op -> op == LDX || op -> op == LAX)
+      {
+	storeField(e, RAX, FIELD(x));
+      }
+      if (op -> op == LDY)
+      {
+	storeField(e, RAX, FIELD(y));
+      }
+      setNZ(e);
+      return true;
+    case STA:
+    case STX:
+    case STY:
+    case SAX:
+      address(e, op);
+      if (op -> op == SAX)
+      {
+	loadField(e, RAX, FIELD(a));
+	loadField(e, RCX, FIELD(x));
+	EMIT(0x21, 0xc8);		// and eax, ecx
+      }
+      else
+      {
+	loadField(e, RAX, (op -> op == STA)? FIELD(a) : (op -> op == STX)? FIELD(x) : FIELD(y));
+      }
+      write(e, ctx);
+      return true;
+    case TAX:
+    case TAY:
+    case TXA:
+    case TYA:
+    case TSX:
+    case TXS:
+    {
+      uint32_t const src = (op -> op == TAX || op -> op == TAY)? FIELD(a) :
+			   (op -> op == TXA || op -> op == TXS)? FIELD(x) :
+			   (op -> op == TYA)? FIELD(y) : FIELD(sp);
+      uint32_t const dst = (op -> op == TXA || op -> op == TYA)? FIELD(a) :
+			   (op -> op == TAY)? FIELD(y) :
+			   (op -> op == TXS)? FIELD(sp) : FIELD(x);
+      loadField(e, RAX, src);
+      storeField(e, RAX, dst);
+      if (op -> op != TXS)
+      {
+	setNZ(e);
+      }
+      return true;
+    }
+    case INX:
+    case INY:
+    case DEX:
+    case DEY:
+    {
+      uint32_t const reg = (op -> op == INX || op -> op == DEX)? FIELD(x) : FIELD(y);
+      loadField(e, RAX, reg);
+      EMIT(0xfe, (op -> op == INX || op -> op == INY)? 0xc0 : 0xc8);	// inc al (or dec al)
+      storeField(e, RAX, reg);
+      setNZ(e);
+      return true;
+    }
+    case CLC:
+    case CLD:
+    case CLI:
+    case CLV:
+    {
+      byte_t const flag = (op -> op == CLC)? CarryFlag : (op -> op == CLD)? DecimalFlag :
+			  (op -> op == CLI)? InterruptDisableFlag : OverflowFlag;
+      EMIT(0x80, 0xa3);			// and byte [rbx + status], ~flag
+      emit32(e, FIELD(status));
+      EMIT( (byte_t) ~flag );
+      return true;
+    }
+    case SEC:
+    case SED:
+    case SEI:
+    {
+      byte_t const flag = (op -> op == SEC)? CarryFlag : (op -> op == SED)? DecimalFlag :
+			  InterruptDisableFlag;
+      EMIT(0x80, 0x8b);			// or byte [rbx + status], flag
+      emit32(e, FIELD(status));
+      EMIT(flag);
+      return true;
+    }
+    case AND:
+    case ORA:
+    case EOR:
+      read(e, op);
+      loadField(e, RCX, FIELD(a));
+      EMIT( (op -> op == AND)? 0x21 : (op -> op == ORA)? 0x09 : 0x31, 0xc8 );	// eax op= ecx
+      storeField(e, RAX, FIELD(a));
+      setNZ(e);
+      return true;
+    case CMP:
+    case CPX:
+    case CPY:
+      read(e, op);
+      compare(e, (op -> op == CMP)? FIELD(a) : (op -> op == CPX)? FIELD(x) : FIELD(y));
+      return true;
+    case BIT:
+      read(e, op);
+      loadField(e, RCX, FIELD(status));
+      EMIT(0x83, 0xe1, (byte_t) ~(NegativeFlag | OverflowFlag | ZeroFlag));	// and ecx
+      EMIT(0x89, 0xc2);			// mov edx, eax
+      EMIT(0x81, 0xe2, 0xc0, 0x00, 0x00, 0x00);	// and edx, N | V
+      EMIT(0x09, 0xd1);			// or ecx, edx
+      EMIT(0x84, 0x83);			// test [rbx + a], al
+      emit32(e, FIELD(a));
+      EMIT(0x0f, 0x94, 0xc2);		// sete dl
+      EMIT(0x00, 0xd2);			// add dl, dl (Z)
+      EMIT(0x08, 0xd1);			// or cl, dl
+      storeField(e, RCX, FIELD(status));
+      return true;
+    case ADC:
+    case SBC:
+      read(e, op);
+      if (op -> op == SBC)
+      {
+	EMIT(0xf7, 0xd0);		// not eax
+      }
+      EMIT(0x89, 0xc6);			// mov esi, eax
+      call(e, helperADC);
+      return true;
+    case ASL_A:
+    case LSR_A:
+    case ROL_A:
+    case ROR_A:
+    {
+      const void* helper = (op -> op == ASL_A)? (const void*) helperASL :
+			   (op -> op == LSR_A)? (const void*) helperLSR :
+			   (op -> op == ROL_A)? (const void*) helperROL : (const void*) helperROR;
+      loadField(e, RSI, FIELD(a));
+      call(e, helper);
+      storeField(e, RAX, FIELD(a));
+      return true;
+    }
+    case ASL:
+    case LSR:
+    case ROL:
+    case ROR:
+    {
+      const void* helper = (op -> op == ASL)? (const void*) helperASL :
+			   (op -> op == LSR)? (const void*) helperLSR :
+			   (op -> op == ROL)? (const void*) helperROL : (const void*) helperROR;
+      modify(e, ctx, helper, 0);
+      return true;
+    }
+    case INC:
+      modify(e, ctx, NULL, 0xc0);
+      return true;
+    case DEC:
+      modify(e, ctx, NULL, 0xc8);
+      return true;
+    case NOP:
+      address(e, op);			// (the page-crossing penalty)
+      return true;
+    case PHA:
+    case PHP:
+      guardStack(e, ctx);
+      loadField(e, RAX, (op -> op == PHA)? FIELD(a) : FIELD(status));
+      if (op -> op == PHP)
+      {
+	EMIT(0x83, 0xc8, BreakFlag | UnusedFlag);	// or eax, B | U
+      }
+      push(e);
+      return true;
+    case PLA:
+      guardStack(e, ctx);
+      pull(e);
+      storeField(e, RAX, FIELD(a));
+      setNZ(e);
+      return true;
+    case PLP:
+      guardStack(e, ctx);
+      pull(e);
+      EMIT(0x83, 0xe0, (byte_t) ~BreakFlag);	// and eax, ~B
+      EMIT(0x83, 0xc8, UnusedFlag);	// or eax, U
+      storeField(e, RAX, FIELD(status));
+      return true;
+    case BCC:
+      branch(e, ctx, CarryFlag, false);
+      return true;
+    case BCS:
+      branch(e, ctx, CarryFlag, true);
+      return true;
+    case BNE:
+      branch(e, ctx, ZeroFlag, false);
+      return true;
+    case BEQ:
+      branch(e, ctx, ZeroFlag, true);
+      return true;
+    case BPL:
+      branch(e, ctx, NegativeFlag, false);
+      return true;
+    case BMI:
+      branch(e, ctx, NegativeFlag, true);
+      return true;
+    case BVC:
+      branch(e, ctx, OverflowFlag, false);
+      return true;
+    case BVS:
+      branch(e, ctx, OverflowFlag, true);
+      return true;
+    case JMP:
+      if (op -> mode == IND)
+      {
+	loadImmediate(e, RSI, op -> operand);
+	call(e, helperIndirect);
+	EMIT(0x66, 0x89, 0x83);		// mov [rbx + pc], ax
+	emit32(e, FIELD(pc));
+	EMIT(0xb8);			// mov eax, cycles
+	emit32(e, ctx -> through);
+	EMIT(0x4c, 0x01, 0xf8);		// add rax, r15
+	EMIT(0x41, 0x5f, 0x41, 0x5e, 0x41, 0x5d, 0x41, 0x5c, 0x5b, 0xc3);	// pop, ret
+	return true;
+      }
+      leave(e, op -> operand, ctx -> through);
+      return true;
+    case JSR:
+    {
+      address_t const ret = (ctx -> next - 1);
+      guardStack(e, ctx);
+      loadImmediate(e, RAX, ret >> 8);
+      push(e);
+      loadImmediate(e, RAX, ret & 0xff);
+      push(e);
+      leave(e, op -> operand, ctx -> through);
+      return true;
+    }
+    case RTS:
+      guardStack(e, ctx);
+      pull(e);
+      EMIT(0x89, 0xc2);			// mov edx, eax
+      pull(e);
+      EMIT(0xc1, 0xe0, 0x08);		// shl eax, 8
+      EMIT(0x09, 0xd0);			// or eax, edx
+      EMIT(0xff, 0xc0);			// inc eax
+      EMIT(0x66, 0x89, 0x83);		// mov [rbx + pc], ax
+      emit32(e, FIELD(pc));
+      EMIT(0xb8);			// mov eax, cycles
+      emit32(e, ctx -> through);
+      EMIT(0x4c, 0x01, 0xf8);		// add rax, r15
+      EMIT(0x41, 0x5f, 0x41, 0x5e, 0x41, 0x5d, 0x41, 0x5c, 0x5b, 0xc3);	// pop, ret
+      return true;
+    default:				// BRK, RTI, JAM, and most unofficial operations
+      return false;
+  }
+}
+
+
+// translates the block into machine code, returns NULL if the arena is full or if not
+// even the first instruction of the block can be recompiled
+static native_t compile (recompiler_t* rec, const block_t* block)
+{
+  data_t* d = rec -> data;
+  if (block -> page == NULL || block -> count == 0)
+  {
+    return NULL;
+  }
+
+  emitter_t emitter = {
+    .code = d -> m_arena + d -> m_used,
+    .size = d -> m_size - d -> m_used,
+    .used = 0
+  };
+  emitter_t* e = &emitter;
+
+  if (mprotect(d -> m_arena, d -> m_size, PROT_READ | PROT_WRITE) == -1)
+  {
+    printf("Recompiler::compile() failed to unprotect the arena!\n");
+    return NULL;
+  }
+
+  prologue(e);
+
+  size_t count = 0;
+  bool isEnded = false;
+  address_t pc = block -> pc;
+  for (size_t i = 0; i != block -> count && !isEnded; ++i)
+  {
+    const blockOp_t* op = &block -> code[i];
+    context_t const ctx = {
+      .op = op,
+      .at = pc,
+      .next = pc + op -> length,
+      .before = (block -> cycles - op -> rest - op -> cycles),
+      .through = (block -> cycles - op -> rest)
+    };
+
+    if (!instruction(e, &ctx))
+    {
+      // leaves the block (at the instruction) for the interpreter:
+      leave(e, ctx.at, ctx.before);
+      isEnded = true;
+      break;
+    }
+
+    ++count;
+    pc = ctx.next;
+    isEnded = (op -> mode == REL || op -> op == JMP || op -> op == JSR || op -> op == RTS);
+  }
+
+  if (!isEnded)
+  {
+    leave(e, pc, block -> cycles);
+  }
+
+  native_t native = NULL;
+  bool const fits = (e -> used <= e -> size);
+  if (fits && count != 0)
+  {
+    native = (native_t) (void*) e -> code;
+    d -> m_used += e -> used;
+    d -> m_used = (d -> m_used + 15) & ~( (size_t) 15 );
+    d -> m_used = (d -> m_used < d -> m_size)? d -> m_used : d -> m_size;
+  }
+  else if (!fits)
+  {
+    d -> m_used = d -> m_size;			// reports full (see isFull())
+  }
+
+  if (mprotect(d -> m_arena, d -> m_size, PROT_READ | PROT_EXEC) == -1)
+  {
+    printf("Recompiler::compile() failed to protect the arena!\n");
+    d -> m_used = d -> m_size;
+    native = NULL;
+  }
+
+  return native;
+}
+
+
+static void* map (size_t const size)
+{
+  void* arena = mmap(NULL, size, PROT_READ | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  return (arena == MAP_FAILED)? NULL : arena;
+}
+
+
+static void unmap (void* arena, size_t const size)
+{
+  munmap(arena, size);
+}
+
+#else
+
+static native_t compile (recompiler_t* rec, const block_t* block)
+{
+  (void) rec;
+  (void) block;
+  return NULL;
+}
+
+
+static void* map (size_t const size)
+{
+  (void) size;
+  printf("Recompiler::Recompiler() the recompiler supports x86-64 (unix) only\n");
+  return NULL;
+}
+
+
+static void unmap (void* arena, size_t const size)
+{
+  (void) arena;
+  (void) size;
+}
+
+#endif
+
+
+static recompiler_t* create (size_t const size)
+{
+  recompiler_t* rec = malloc( sizeof(recompiler_t) );
+  if (rec == NULL)
+  {
+    printf("Recompiler::Recompiler() failed to allocate the recompiler!\n");
+    return rec;
+  }
+
+  rec -> data = (data_t*) malloc( sizeof(data_t) );
+  if (rec -> data == NULL)
+  {
+    free(rec);
+    rec = NULL;
+    printf("Recompiler::Recompiler() failed to allocate the recompiler data!\n");
+    return rec;
+  }
+
+  data_t* d = rec -> data;
+  d -> m_size = (size)? size : NES_RECOMPILER_ARENA;
+  d -> m_used = 0;
+  d -> m_arena = map(d -> m_size);
+  if (d -> m_arena == NULL)
+  {
+    free(rec -> data);
+    rec -> data = NULL;
+    free(rec);
+    rec = NULL;
+    return rec;
+  }
+
+  return rec;
+}
+
+
+static recompiler_t* destroy (recompiler_t* rec)
+{
+  if (rec == NULL)
+  {
+    return rec;
+  }
+
+  data_t* d = rec -> data;
+  unmap(d -> m_arena, d -> m_size);
+  d -> m_arena = NULL;
+
+  free(rec -> data);
+  rec -> data = NULL;
+  d = NULL;
+
+  free(rec);
+  rec = NULL;
+  return rec;
+}
+
+
+static bool isFull (const recompiler_t* rec)
+{
+  const data_t* d = rec -> data;
+  return (d -> m_used == d -> m_size);
+}
+
+
+// discards the machine code (the blocks pointing to it must be unlinked by the caller)
+static void reset (recompiler_t* rec)
+{
+  data_t* d = rec -> data;
+  d -> m_used = 0;
+}
+
+
+recompiler_namespace_t const recompiler = {
+  .create = create,
+  .destroy = destroy,
+  .compile = compile,
+  .isFull = isFull,
+  .reset = reset
+};
+
+
+// NES Emulation					October 18, 2026
+//
+//			Academic Purpose
+//
+// source: recompiler.c
+// author: @misael-diaz
+//
+// Synopsis:
+// Implements the methods of the recompiler object.
+// The hot blocks are translated into x86-64 machine code: the loads, stores, transfers,
+// logic, compares, stack operations, and control transfers are emitted inline, while the
+// arithmetic and the shifts call small helpers. The zero page, the stack, and the work
+// RAM are accessed directly; the rest of the address space (I/O and cartridge) goes
+// through the bus callbacks. Writes to the pages holding code or to mapper registers
+// leave the block, so that self-modifying code and bank switches take effect at once.
+// The operations that are not recompiled (BRK, RTI, JAM, and most unofficial operations)
+// end the recompiled code and the CPU interprets them.
+//
+// Copyright (c) 2023 Misael Diaz-Maldonado
+// This file is released under the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// References:
+// [0] https://github.com/amhndu/SimpleNES
+// [1] https://www.felixcloutier.com/x86/
@@ -0,0 +1,131 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "romstore.h"
+
+#define NES_ROMSTORE_BUCKETS ( (size_t) 256 )
+
+
+// process-wide store, images are chained by bucket (selected by the content key)
+static romimage_t* buckets[NES_ROMSTORE_BUCKETS];
+static size_t num_images = 0;
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+
+
+// returns the image holding the bytes, taking ownership of the (heap allocated) bytes;
+// if an identical image is already in the store the bytes are freed and it is shared.
+// The key is a content hash of the bytes (the cartridge uses the size and CRC32).
+static romimage_t* acquire (byte_t* bytes, size_t const size, uint64_t const key)
+{
+  size_t const bucket = (key % NES_ROMSTORE_BUCKETS);
+
+  pthread_mutex_lock(&lock);
+  for (romimage_t* image = buckets[bucket]; image != NULL; image = image -> next)
+  {
+    bool const isSame = (image -> key == key &&
+			 image -> size == size &&
+			 memcmp(image -> bytes, bytes, size) == 0);
+    if (isSame)
+    {
+      ++image -> refs;
+      pthread_mutex_unlock(&lock);
+      free(bytes);
+      bytes = NULL;
+      return image;
+    }
+  }
+
+  romimage_t* image = malloc( sizeof(romimage_t) );
+  if (image == NULL)
+  {
+    pthread_mutex_unlock(&lock);
+    printf("RomStore::acquire() failed to allocate ROM image!\n");
+    return image;
+  }
+
+  image -> bytes = bytes;
+  image -> size = size;
+  image -> key = key;
+  image -> refs = 1;
+  image -> next = buckets[bucket];
+  buckets[bucket] = image;
+  ++num_images;
+  pthread_mutex_unlock(&lock);
+
+  return image;
+}
+
+
+// drops a reference to the image, the last one frees it
+static romimage_t* release (romimage_t* image)
+{
+  if (image == NULL)
+  {
+    return image;
+  }
+
+  size_t const bucket = (image -> key % NES_ROMSTORE_BUCKETS);
+
+  pthread_mutex_lock(&lock);
+  --image -> refs;
+  if (image -> refs != 0)
+  {
+    pthread_mutex_unlock(&lock);
+    image = NULL;
+    return image;
+  }
+
+  romimage_t** link = &buckets[bucket];
+  while (*link != image)
+  {
+    link = &(*link) -> next;
+  }
+  *link = image -> next;
+  --num_images;
+  pthread_mutex_unlock(&lock);
+
+  free((byte_t*) image -> bytes);
+  image -> bytes = NULL;
+  image -> next = NULL;
+  free(image);
+  image = NULL;
+  return image;
+}
+
+
+static size_t count (void)
+{
+  pthread_mutex_lock(&lock);
+  size_t const n = num_images;
+  pthread_mutex_unlock(&lock);
+  return n;
+}
+
+
+romstore_namespace_t const romstore = {
+  .acquire = acquire,
+  .release = release,
+  .count = count
+};
+
+
+// NES Emulation					October 18, 2026
+//
+//			Academic Purpose
+//
+// source: romstore.c
+// author: @misael-diaz
+//
+// Synopsis:
+// Implements the process-wide store of ROM images. Cartridges holding the same ROM
+// borrow the same immutable PRG-ROM and CHR-ROM buffers, so the memory used by each
+// emulator instance scales with its mutable state only.
+//
+// Copyright (c) 2023 Misael Diaz-Maldonado
+// This file is released under the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// References:
+// [0] https://github.com/amhndu/SimpleNES
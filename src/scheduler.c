@@ -0,0 +1,253 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "scheduler.h"
+
+// scheduler private data typedef:
+typedef struct
+{
+  event_t* m_heap;			// min-heap of the events (by time, then by order)
+  size_t m_count;
+  size_t m_capacity;
+  uint64_t m_order;			// events scheduled so far
+} data_t;
+
+
+// true if the event a is due before the event b
+static inline bool isBefore (const event_t* a, const event_t* b)
+{
+  return (a -> time < b -> time || (a -> time == b -> time && a -> order < b -> order));
+}
+
+
+static void swap (event_t* heap, size_t const i, size_t const j)
+{
+  event_t const event = heap[i];
+  heap[i] = heap[j];
+  heap[j] = event;
+}
+
+
+// moves the event up the heap until its parent is due before it
+static void siftUp (event_t* heap, size_t i)
+{
+  while (i != 0)
+  {
+    size_t const parent = (i - 1) / 2;
+    if (!isBefore(&heap[i], &heap[parent]))
+    {
+      break;
+    }
+
+    swap(heap, i, parent);
+    i = parent;
+  }
+}
+
+
+// moves the event down the heap until its children are due after it
+static void siftDown (event_t* heap, size_t const count, size_t i)
+{
+  for (size_t left = (2 * i + 1); left < count; left = (2 * i + 1))
+  {
+    size_t const right = (left + 1);
+    size_t const child = (right < count && isBefore(&heap[right], &heap[left]))? right : left;
+    if (!isBefore(&heap[child], &heap[i]))
+    {
+      break;
+    }
+
+    swap(heap, i, child);
+    i = child;
+  }
+}
+
+
+// removes the event at the index of the heap
+static void removeAt (data_t* d, size_t const i)
+{
+  event_t* heap = d -> m_heap;
+  --d -> m_count;
+  if (i == d -> m_count)
+  {
+    return;
+  }
+
+  heap[i] = heap[d -> m_count];
+  siftDown(heap, d -> m_count, i);
+  siftUp(heap, i);
+}
+
+
+static bool schedule (void* vscheduler, uint64_t const time, eventKind_t const kind)
+{
+  scheduler_t* scheduler = vscheduler;
+  data_t* d = scheduler -> data;
+  if (d -> m_count == d -> m_capacity)
+  {
+    printf("Scheduler::schedule() the event queue is full!\n");
+    return false;
+  }
+
+  event_t* event = &d -> m_heap[d -> m_count];
+  event -> time = time;
+  event -> order = d -> m_order;
+  event -> kind = kind;
+  ++d -> m_order;
+  ++d -> m_count;
+  siftUp(d -> m_heap, d -> m_count - 1);
+  return true;
+}
+
+
+// removes the pending events of the kind, returns how many were removed
+static size_t cancel (void* vscheduler, eventKind_t const kind)
+{
+  scheduler_t* scheduler = vscheduler;
+  data_t* d = scheduler -> data;
+  size_t removed = 0;
+  size_t i = 0;
+  while (i != d -> m_count)
+  {
+    if (d -> m_heap[i].kind == kind)
+    {
+      removeAt(d, i);
+      ++removed;
+      i = 0;				// (the heap may have moved the events around)
+      continue;
+    }
+
+    ++i;
+  }
+
+  return removed;
+}
+
+
+static uint64_t next (const void* vscheduler)
+{
+  const scheduler_t* scheduler = vscheduler;
+  const data_t* d = scheduler -> data;
+  return (d -> m_count != 0)? d -> m_heap[0].time : NES_SCHEDULER_NEVER;
+}
+
+
+// removes the earliest event into the event if it is due by the time, returns false
+// (leaving the event untouched) otherwise
+static bool pop (void* vscheduler, uint64_t const time, event_t* event)
+{
+  scheduler_t* scheduler = vscheduler;
+  data_t* d = scheduler -> data;
+  if (d -> m_count == 0 || d -> m_heap[0].time > time)
+  {
+    return false;
+  }
+
+  *event = d -> m_heap[0];
+  removeAt(d, 0);
+  return true;
+}
+
+
+static size_t getCount (const void* vscheduler)
+{
+  const scheduler_t* scheduler = vscheduler;
+  const data_t* d = scheduler -> data;
+  return d -> m_count;
+}
+
+
+static scheduler_t* create (size_t const capacity)
+{
+  if (capacity == 0)
+  {
+    printf("Scheduler::Scheduler() expects room for one or more events\n");
+    return NULL;
+  }
+
+  scheduler_t* scheduler = malloc( sizeof(scheduler_t) );
+  if (scheduler == NULL)
+  {
+    printf("Scheduler::Scheduler() failed to allocate the scheduler!\n");
+    return scheduler;
+  }
+
+  scheduler -> data = (data_t*) malloc( sizeof(data_t) );
+  if (scheduler -> data == NULL)
+  {
+    free(scheduler);
+    scheduler = NULL;
+    printf("Scheduler::Scheduler() failed to allocate the scheduler data!\n");
+    return scheduler;
+  }
+
+  data_t* d = scheduler -> data;
+  d -> m_heap = malloc( capacity * sizeof(event_t) );
+  if (d -> m_heap == NULL)
+  {
+    free(scheduler -> data);
+    scheduler -> data = NULL;
+    free(scheduler);
+    scheduler = NULL;
+    printf("Scheduler::Scheduler() failed to allocate the event queue!\n");
+    return scheduler;
+  }
+
+  d -> m_count = 0;
+  d -> m_capacity = capacity;
+  d -> m_order = 0;
+
+  scheduler -> schedule = schedule;
+  scheduler -> cancel = cancel;
+  scheduler -> next = next;
+  scheduler -> pop = pop;
+  scheduler -> getCount = getCount;
+  return scheduler;
+}
+
+
+static scheduler_t* destroy (scheduler_t* scheduler)
+{
+  if (scheduler == NULL)
+  {
+    return scheduler;
+  }
+
+  data_t* d = scheduler -> data;
+  free(d -> m_heap);
+  d -> m_heap = NULL;
+
+  free(scheduler -> data);
+  scheduler -> data = NULL;
+
+  free(scheduler);
+  scheduler = NULL;
+  return scheduler;
+}
+
+
+scheduler_namespace_t const scheduler = {
+  .create = create,
+  .destroy = destroy
+};
+
+
+// NES Emulation					October 18, 2026
+//
+//			Academic Purpose
+//
+// source: scheduler.c
+// author: @misael-diaz
+//
+// Synopsis:
+// Implements the methods of the scheduler object.
+// The events are kept in a binary min-heap ordered by the master clock time they are due
+// at (the events due at the same time come out in the order they were scheduled), so
+// that the next event is found in constant time and added or removed in log time.
+//
+// Copyright (c) 2023 Misael Diaz-Maldonado
+// This file is released under the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// References:
+// [0] https://github.com/amhndu/SimpleNES
@@ -0,0 +1,474 @@
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <zlib.h>
+#include "stream.h"
+
+
+typedef enum
+{
+  FileSource,
+  MemorySource,
+  InflateSource,
+} source_t;
+
+
+// stream private data typedef:
+typedef struct
+{
+  FILE* m_file;
+  const byte_t* m_bytes;		// buffer (or the compressed bytes to inflate)
+  size_t m_size;
+  size_t m_offset;
+  void* m_image;			// mapping of the archive (NULL if not mapped)
+  size_t m_size_image;
+  z_stream m_inflater;
+  source_t m_source;
+  bool m_end;
+  bool m_failed;			// the archive is corrupted (or truncated)
+  bool m_checksCRC;			// (zip entries, zlib checks the gzip trailer)
+  uint32_t m_crc32;			// of the bytes read (zip entries)
+  uint32_t m_crc32_stored;		// (in the central directory)
+} data_t;
+
+
+static uint16_t le16 (const byte_t* p)
+{
+  return ( (uint16_t) p[0] | ( (uint16_t) p[1] << 8 ) );
+}
+
+
+static uint32_t le32 (const byte_t* p)
+{
+  return ( (uint32_t) le16(p) | ( (uint32_t) le16(p + 2) << 16 ) );
+}
+
+
+static size_t readFile (void* v_stream, byte_t* dst, size_t const size)
+{
+  stream_t* s = v_stream;
+  data_t* d = s -> data;
+  size_t const count = fread(dst, sizeof(byte_t), size, d -> m_file);
+  return count;
+}
+
+
+static size_t readMemory (void* v_stream, byte_t* dst, size_t const size)
+{
+  stream_t* s = v_stream;
+  data_t* d = s -> data;
+  size_t const remaining = (d -> m_size - d -> m_offset);
+  size_t const count = (size < remaining)? size : remaining;
+  memcpy(dst, d -> m_bytes + d -> m_offset, count);
+  d -> m_offset += count;
+  if (d -> m_checksCRC)
+  {
+    d -> m_crc32 = crc32(d -> m_crc32, dst, count);
+  }
+
+  return count;
+}
+
+
+// inflates straight into the destination (the final PRG-ROM or CHR-ROM allocation)
+static size_t readInflate (void* v_stream, byte_t* dst, size_t const size)
+{
+  stream_t* s = v_stream;
+  data_t* d = s -> data;
+  z_stream* z = &d -> m_inflater;
+  size_t count = 0;
+  while (count != size && !d -> m_end)
+  {
+    if (z -> avail_in == 0 && d -> m_offset != d -> m_size)
+    {
+      size_t const remaining = (d -> m_size - d -> m_offset);
+      z -> next_in = (Bytef*) (d -> m_bytes + d -> m_offset);
+      z -> avail_in = (remaining < UINT_MAX)? remaining : UINT_MAX;
+      d -> m_offset += z -> avail_in;
+    }
+
+    size_t const pending = (size - count);
+    z -> next_out = (dst + count);
+    z -> avail_out = (pending < UINT_MAX)? pending : UINT_MAX;
+    uInt const avail_out = z -> avail_out;
+    int const ret = inflate(z, Z_NO_FLUSH);
+    count += (avail_out - z -> avail_out);
+    if (ret == Z_STREAM_END)
+    {
+      d -> m_end = true;
+    }
+    else if (ret != Z_OK)
+    {
+      const char* msg = (z -> msg)? z -> msg : "truncated archive";
+      printf("Stream::read() failed to inflate the ROM: %s\n", msg);
+      d -> m_end = true;
+      d -> m_failed = true;
+    }
+  }
+
+  if (d -> m_checksCRC)
+  {
+    d -> m_crc32 = crc32(d -> m_crc32, dst, count);
+  }
+
+  return count;
+}
+
+
+// reads the rest of the stream (the archive is inflated up to its end) and checks the
+// CRC32 of the bytes read against the one stored in the archive (zlib checks the trailer
+// of the gzip stream), returns false if they differ or if the archive ends early
+static bool verify (void* v_stream)
+{
+  stream_t* s = v_stream;
+  data_t* d = s -> data;
+  byte_t rest[0x1000];
+  size_t count = s -> read(s, rest, sizeof(rest));
+  while (count != 0)
+  {
+    count = s -> read(s, rest, sizeof(rest));
+  }
+
+  if (d -> m_source == InflateSource && (d -> m_failed || !d -> m_end))
+  {
+    return false;
+  }
+
+  return (!d -> m_checksCRC || d -> m_crc32 == d -> m_crc32_stored);
+}
+
+
+static stream_t* alloc (void)
+{
+  stream_t* s = malloc( sizeof(stream_t) );
+  if (s == NULL)
+  {
+    printf("Stream::Stream() failed to allocate stream!\n");
+    return s;
+  }
+
+  s -> data = (data_t*) malloc( sizeof(data_t) );
+  if (s -> data == NULL)
+  {
+    free(s);
+    s = NULL;
+    printf("Stream::Stream() failed to allocate stream data!\n");
+    return s;
+  }
+
+  data_t* d = s -> data;
+  memset(d, 0, sizeof(data_t));
+  d -> m_file = NULL;
+  d -> m_bytes = NULL;
+  d -> m_image = NULL;
+  d -> m_source = MemorySource;
+  d -> m_end = false;
+  d -> m_failed = false;
+  d -> m_checksCRC = false;
+  d -> m_crc32 = crc32(0, Z_NULL, 0);
+  d -> m_crc32_stored = 0;
+  s -> read = readMemory;
+  s -> verify = verify;
+  return s;
+}
+
+
+static stream_t* destroy (stream_t* s)
+{
+  if (s == NULL)
+  {
+    return s;
+  }
+
+  data_t* d = s -> data;
+  if (d -> m_source == InflateSource)
+  {
+    inflateEnd(&d -> m_inflater);
+  }
+
+  if (d -> m_file != NULL)
+  {
+    fclose(d -> m_file);
+    d -> m_file = NULL;
+  }
+
+  if (d -> m_image != NULL)
+  {
+    munmap(d -> m_image, d -> m_size_image);
+    d -> m_image = NULL;
+  }
+
+  free(s -> data);
+  s -> data = NULL;
+  d = NULL;
+
+  free(s);
+  s = NULL;
+  return s;
+}
+
+
+static stream_t* openFile (const char* path)
+{
+  FILE* file = fopen(path, "rb");
+  if (file == NULL)
+  {
+    return NULL;
+  }
+
+  stream_t* s = alloc();
+  if (s == NULL)
+  {
+    fclose(file);
+    return s;
+  }
+
+  data_t* d = s -> data;
+  d -> m_file = file;
+  d -> m_source = FileSource;
+  s -> read = readFile;
+  return s;
+}
+
+
+static bool isROM (const byte_t* name, size_t const len)
+{
+  return (len >= 4 && strncasecmp( (const char*) (name + len - 4), ".nes", 4 ) == 0);
+}
+
+
+// finds the ROM (the first .nes entry, or else the first entry) of the zip archive
+// via its central directory (ref[1]), ZIP64 and encrypted archives are not supported; the
+// offsets read from the archive are checked against its size before they are used
+static bool locate (data_t* d, const byte_t* bytes, size_t const size, int* method)
+{
+  // (shorter than an entry of the central directory and its end record:)
+  if (size < 46 + 22)
+  {
+    return false;
+  }
+
+  // end of central directory record (followed by a comment of up to 64KB):
+  size_t const min = (size > 22 + 0xffff)? (size - 22 - 0xffff) : 0;
+  const byte_t* eocd = NULL;
+  for (size_t i = size - 22; eocd == NULL; --i)
+  {
+    if (le32(bytes + i) == 0x06054b50)
+    {
+      eocd = (bytes + i);
+    }
+
+    if (i == min)
+    {
+      break;
+    }
+  }
+
+  if (eocd == NULL)
+  {
+    return false;
+  }
+
+  size_t const entries = le16(eocd + 10);
+  size_t const offset_cd = le32(eocd + 16);
+  const byte_t* entry = NULL;
+  size_t offset = offset_cd;
+  for (size_t i = 0; i != entries; ++i)
+  {
+    if (offset > size - 46)
+    {
+      return false;
+    }
+
+    const byte_t* p = (bytes + offset);
+    size_t const len_name = le16(p + 28);
+    size_t const len_extra = le16(p + 30);
+    size_t const len_comment = le16(p + 32);
+    if (le32(p) != 0x02014b50 || len_name > size - 46 - offset)
+    {
+      return false;
+    }
+
+    if (entry == NULL || (!isROM(entry + 46, le16(entry + 28)) && isROM(p + 46, len_name)))
+    {
+      entry = p;
+    }
+
+    offset += (46 + len_name + len_extra + len_comment);
+  }
+
+  if (entry == NULL)
+  {
+    return false;
+  }
+
+  uint16_t const flags = le16(entry + 8);
+  size_t const size_compressed = le32(entry + 20);
+  size_t const offset_local = le32(entry + 42);
+  if ( (flags & 0x01) || size_compressed == 0xffffffff || offset_local > size - 30 )
+  {
+    return false;
+  }
+
+  const byte_t* local = (bytes + offset_local);
+  if (le32(local) != 0x04034b50)
+  {
+    return false;
+  }
+
+  size_t const offset_data = (offset_local + 30 + le16(local + 26) + le16(local + 28));
+  if (offset_data > size || size_compressed > size - offset_data)
+  {
+    return false;
+  }
+
+  *method = le16(entry + 10);
+  d -> m_bytes = (bytes + offset_data);
+  d -> m_size = size_compressed;
+  d -> m_checksCRC = true;
+  d -> m_crc32_stored = le32(entry + 16);
+  return true;
+}
+
+
+// streams the ROM in the buffer, inflating it on the fly if it is gzip'd or zip'd
+static stream_t* openMemory (const byte_t* bytes, size_t const size)
+{
+  stream_t* s = alloc();
+  if (s == NULL)
+  {
+    return s;
+  }
+
+  data_t* d = s -> data;
+  d -> m_bytes = bytes;
+  d -> m_size = size;
+
+  bool const isGzip = (size >= 2 && bytes[0] == 0x1f && bytes[1] == 0x8b);	// ref[2]
+  bool const isZip = (size >= 4 && le32(bytes) == 0x04034b50);		// ref[1]
+  if (!isGzip && !isZip)
+  {
+    return s;
+  }
+
+  int windowBits = (16 + MAX_WBITS);		// gzip wrapper
+  if (isZip)
+  {
+    int method = 0;
+    if (!locate(d, bytes, size, &method))
+    {
+      printf("Stream::openMemory() unsupported or corrupted zip archive\n");
+      s = destroy(s);
+      return s;
+    }
+
+    if (method == 0)				// stored
+    {
+      return s;
+    }
+
+    if (method != 8)
+    {
+      printf("Stream::openMemory() unsupported zip compression method %d\n", method);
+      s = destroy(s);
+      return s;
+    }
+
+    windowBits = -MAX_WBITS;			// raw deflate
+  }
+
+  z_stream* z = &d -> m_inflater;
+  z -> zalloc = Z_NULL;
+  z -> zfree = Z_NULL;
+  z -> opaque = Z_NULL;
+  z -> next_in = Z_NULL;
+  z -> avail_in = 0;
+  if (inflateInit2(z, windowBits) != Z_OK)
+  {
+    printf("Stream::openMemory() failed to initialize the inflater!\n");
+    s = destroy(s);
+    return s;
+  }
+
+  d -> m_source = InflateSource;
+  s -> read = readInflate;
+  return s;
+}
+
+
+// maps the (gzip or zip) archive and streams the ROM out of it, no temporary files
+static stream_t* openArchive (const char* path)
+{
+  int const fd = open(path, O_RDONLY);
+  if (fd == -1)
+  {
+    return NULL;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) == -1 || st.st_size == 0)
+  {
+    close(fd);
+    return NULL;
+  }
+
+  size_t const size = st.st_size;
+  void* image = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (image == MAP_FAILED)
+  {
+    return NULL;
+  }
+
+  stream_t* s = openMemory(image, size);
+  if (s == NULL)
+  {
+    munmap(image, size);
+    return s;
+  }
+
+  data_t* d = s -> data;
+  d -> m_image = image;
+  d -> m_size_image = size;
+  return s;
+}
+
+
+stream_namespace_t const stream = {
+  .openFile = openFile,
+  .openMemory = openMemory,
+  .openArchive = openArchive,
+  .destroy = destroy
+};
+
+
+// NES Emulation					October 18, 2026
+//
+//			Academic Purpose
+//
+// source: stream.c
+// author: @misael-diaz
+//
+// Synopsis:
+// Implements the methods of the stream object.
+// Streams the ROM out of a file, a buffer, or a gzip or zip archive. Archives are
+// inflated (with zlib) straight into the buffers the reader supplies, so that loading
+// a compressed ROM needs neither a temporary file nor an extra copy. The archive is
+// inflated to its end once the ROM is read, so that its CRC32 is checked.
+//
+// Copyright (c) 2023 Misael Diaz-Maldonado
+// This file is released under the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// References:
+// [0] https://github.com/amhndu/SimpleNES
+// [1] https://pkware.cachefly.net/webdocs/casestudies/APPNOTE.TXT
+// [2] https://www.rfc-editor.org/rfc/rfc1952
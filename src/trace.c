@@ -0,0 +1,147 @@
+#include <string.h>
+#include "trace.h"
+
+
+static size_t capacityOf (size_t const size)	// rounds up to a power of two
+{
+  size_t capacity = 1;
+  while (capacity < size)
+  {
+    capacity <<= 1;
+  }
+
+  return capacity;
+}
+
+
+static trace_t* create (size_t const size)
+{
+  trace_t* ring = aligned_alloc( _Alignof(trace_t), sizeof(trace_t) );
+  if (ring == NULL)
+  {
+    printf("Trace::Trace() failed to allocate the trace!\n");
+    return ring;
+  }
+
+  size_t const capacity = capacityOf( (size)? size : NES_TRACE_CAPACITY );
+  ring -> records = (traceRecord_t*) malloc( capacity * sizeof(traceRecord_t) );
+  if (ring -> records == NULL)
+  {
+    free(ring);
+    ring = NULL;
+    printf("Trace::Trace() failed to allocate the trace records!\n");
+    return ring;
+  }
+
+  atomic_init(&ring -> head, 0);
+  atomic_init(&ring -> tail, 0);
+  ring -> tail_cached = 0;
+  ring -> cycle = 0;
+  ring -> dropped = 0;
+  ring -> reported = 0;
+  ring -> mask = (capacity - 1);
+  return ring;
+}
+
+
+static trace_t* destroy (trace_t* ring)
+{
+  if (ring == NULL)
+  {
+    return ring;
+  }
+
+  free(ring -> records);
+  ring -> records = NULL;
+
+  free(ring);
+  ring = NULL;
+  return ring;
+}
+
+
+// consumer: writes the pending records (in order) to the stream, returns the count
+static size_t drain (trace_t* ring, FILE* file)
+{
+  size_t const tail = atomic_load_explicit(&ring -> tail, memory_order_relaxed);
+  size_t const head = atomic_load_explicit(&ring -> head, memory_order_acquire);
+  size_t const capacity = (ring -> mask + 1);
+  size_t count = 0;
+  while (tail + count != head)
+  {
+    size_t const begin = ( (tail + count) & ring -> mask );
+    size_t const pending = (head - tail - count);
+    size_t const contiguous = (capacity - begin);
+    size_t const size = (pending < contiguous)? pending : contiguous;
+    size_t const written = fwrite(ring -> records + begin, sizeof(traceRecord_t), size, file);
+    count += written;
+    if (written != size)
+    {
+      printf("Trace::drain() failed to write the trace records!\n");
+      break;
+    }
+  }
+
+  atomic_store_explicit(&ring -> tail, tail + count, memory_order_release);
+  return count;
+}
+
+
+// appends the pending records to the trace file (created with its header if needed)
+static size_t dump (trace_t* ring, const char* path)
+{
+  FILE* file = fopen(path, "ab");
+  if (file == NULL)
+  {
+    printf("Trace::dump() failed to open %s\n", path);
+    return 0;
+  }
+
+  if (ftell(file) == 0)
+  {
+    uint32_t const header[] = { NES_TRACE_VERSION, sizeof(traceRecord_t) };
+    fwrite(NES_TRACE_MAGIC, sizeof(char), strlen(NES_TRACE_MAGIC), file);
+    fwrite(header, sizeof(uint32_t), 2, file);
+  }
+
+  size_t const count = drain(ring, file);
+  if (ring -> dropped != ring -> reported)
+  {
+    printf("Trace::dump() %zu records were dropped (ring full)\n",
+	   ring -> dropped - ring -> reported);
+    ring -> reported = ring -> dropped;
+  }
+
+  fclose(file);
+  return count;
+}
+
+
+trace_namespace_t const trace = {
+  .create = create,
+  .destroy = destroy,
+  .drain = drain,
+  .dump = dump
+};
+
+
+// NES Emulation					October 18, 2026
+//
+//			Academic Purpose
+//
+// source: trace.c
+// author: @misael-diaz
+//
+// Synopsis:
+// Implements the methods of the trace object.
+// The mapper (producer) pushes records without locks or syscalls, the consumer drains
+// them in bulk to a binary trace file.
+//
+// Copyright (c) 2023 Misael Diaz-Maldonado
+// This file is released under the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// References:
+// [0] https://github.com/amhndu/SimpleNES
+// [1] https://www.1024cores.net/home/lock-free-algorithms/queues
@@ -0,0 +1,86 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include "trace.h"
+
+#define SUCCESS ( (int) 0x00000000 )
+#define FAILURE ( (int) 0xffffffff )
+
+
+static void decode (const traceRecord_t* record)
+{
+  const char* const ops[] = { "read PRG", "read CHR", "write PRG", "write CHR", "scanline IRQ" };
+  uint8_t const op = (record -> op & ~NES_TRACE_FAULT);
+  const char* name = (op <= TraceScanlineIRQ)? ops[op] : "unknown";
+  const char* fault = (record -> op & NES_TRACE_FAULT)? " (rejected)" : "";
+  const char log[] = "%12" PRIu64 " Mapper::Mapper: %u %s address 0x%x value %u%s\n";
+  printf(log, record -> cycle, record -> kind, name, record -> address, record -> value, fault);
+}
+
+
+int main (int argc, char* argv[])
+{
+  if (argc != 2)
+  {
+    printf("usage: %s trace-file\n", argv[0]);
+    return FAILURE;
+  }
+
+  FILE* file = fopen(argv[1], "rb");
+  if (file == NULL)
+  {
+    printf("failed to open %s\n", argv[1]);
+    return FAILURE;
+  }
+
+  char magic[sizeof(NES_TRACE_MAGIC) - 1];
+  uint32_t header[2];
+  size_t const size_magic = sizeof(magic);
+  bool const isValid = (fread(magic, sizeof(char), size_magic, file) == size_magic &&
+			fread(header, sizeof(uint32_t), 2, file) == 2 &&
+			memcmp(magic, NES_TRACE_MAGIC, size_magic) == 0 &&
+			header[0] == NES_TRACE_VERSION &&
+			header[1] == sizeof(traceRecord_t));
+  if (!isValid)
+  {
+    printf("%s is not a (supported) NES trace\n", argv[1]);
+    fclose(file);
+    return FAILURE;
+  }
+
+  size_t count = 0;
+  traceRecord_t records[256];
+  size_t const size = sizeof(records) / sizeof(traceRecord_t);
+  for (size_t n = size; n == size; count += n)
+  {
+    n = fread(records, sizeof(traceRecord_t), size, file);
+    for (size_t i = 0; i != n; ++i)
+    {
+      decode(&records[i]);
+    }
+  }
+
+  printf("records: %zu\n", count);
+  fclose(file);
+  return SUCCESS;
+}
+
+
+// NES Emulation					October 18, 2026
+//
+//			Academic Purpose
+//
+// source: tracedump.c
+// author: @misael-diaz
+//
+// Synopsis:
+// Decodes (offline) the binary trace files written by the emulator built with tracing.
+//
+// Copyright (c) 2023 Misael Diaz-Maldonado
+// This file is released under the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// References:
+// [0] https://github.com/amhndu/SimpleNES